@@ -243,8 +243,9 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
     if (!m_pDS)
       return false;
 
-    std::string sql = PrepareSQL("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url='%s'", url.c_str());
-    m_pDS->query(sql);
+    // looked up for every image shown, the statement is kept compiled
+    m_pDS->query_bound("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url=?",
+                       {dbiplus::field_value(url.c_str())});
     if (!m_pDS->eof())
     { // have some information
       details.id = m_pDS->fv(0).get_asInt();
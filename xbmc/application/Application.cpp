@@ -437,6 +437,8 @@ bool CApplication::Create()
 
   m_pActiveAE.reset(new ActiveAE::CActiveAE());
   m_pActiveAE2.reset(new ActiveAE::CActiveAE(true));
+  if (settingsComponent->GetAdvancedSettings()->m_audioSharedEngineThread)
+    m_pActiveAE2->SetHostEngine(m_pActiveAE.get());
   CServiceBroker::RegisterAE(m_pActiveAE.get(), m_pActiveAE2.get());
 
   // initialize m_replayGainSettings
@@ -974,6 +974,15 @@ bool CApplicationPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned
     return false;
 }
 
+bool CApplicationPlayer::GetRenderTrace(CVariant& trace) const
+{
+  const std::shared_ptr<const IPlayer> player = GetInternal();
+  if (player)
+    return player->GetRenderTrace(trace);
+  else
+    return false;
+}
+
 bool CApplicationPlayer::IsExternalPlaying() const
 {
   const std::shared_ptr<const IPlayer> player = GetInternal();
@@ -24,6 +24,7 @@ class CAction;
 class CPlayerCoreFactory;
 class CPlayerOptions;
 class CStreamDetails;
+class CVariant;
 
 struct AudioStreamInfo;
 struct VideoStreamInfo;
@@ -67,6 +68,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags = 0);
   void RenderCaptureRelease(unsigned int captureId);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  bool GetRenderTrace(CVariant& trace) const;
   bool IsExternalPlaying() const;
   bool IsRemotePlaying() const;
 
@@ -8,6 +8,8 @@
 
 #include "ActiveAE.h"
 
+#include <algorithm>
+#include <memory>
 #include <mutex>
 
 using namespace AE;
@@ -26,6 +28,7 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
 using namespace std::chrono_literals;
@@ -125,11 +128,10 @@ void CEngineStats::UpdateStream(CActiveAEStream *stream)
       }
 
       std::unique_lock<CCriticalSection> lock(stream->m_statsLock);
-      std::deque<CSampleBuffer*>::iterator itBuf;
-      for(itBuf=stream->m_processingSamples.begin(); itBuf!=stream->m_processingSamples.end(); ++itBuf)
+      for (const auto& buf : stream->m_processingSamples)
       {
         if (m_pcmOutput)
-          delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+          delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
         else
           delay += static_cast<float>(m_sinkFormat.m_streamInfo.GetDuration() / 1000.0);
       }
@@ -322,9 +324,25 @@ void CActiveAE::Dispose()
     m_isWinSysReg = false;
   }
 
+  if (m_hostEngine)
+  {
+    m_hostEngine->DetachGuestEngine();
+    m_hostEngine = nullptr;
+  }
+
   m_bStop = true;
   m_outMsgEvent.Set();
   StopThread();
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_guestLock);
+    if (m_guestEngine)
+    {
+      m_guestEngine->m_hostEngine = nullptr;
+      m_guestEngine = nullptr;
+    }
+  }
+
   m_controlPort.Purge();
   m_dataPort.Purge();
   m_sink.Dispose();
@@ -444,7 +462,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
           CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
+          buffer = msg ? (CSampleBuffer**)msg->data : &m_returnedSample;
           if (buffer)
           {
             (*buffer)->Return();
@@ -869,7 +887,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
           CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
+          buffer = msg ? (CSampleBuffer**)msg->data : &m_returnedSample;
           if (buffer)
           {
             (*buffer)->Return();
@@ -934,7 +952,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
           CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
+          buffer = msg ? (CSampleBuffer**)msg->data : &m_returnedSample;
           if (buffer)
           {
             (*buffer)->Return();
@@ -1057,11 +1075,29 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
 
 void CActiveAE::Process()
 {
-  Message *msg = NULL;
-  Protocol *port = NULL;
-  bool gotMsg;
-  XbmcThreads::EndTime<> timer;
+  InitProcess();
+
+  if (m_guestEngine)
+  {
+    ProcessShared();
+    return;
+  }
+
+  XbmcThreads::EndTime<> timer(m_extTimeout);
+
+  while (!m_bStop)
+  {
+    if (ProcessOnce(timer))
+      continue;
+
+    // wait for message, keep the deadline if woken up early
+    m_outMsgEvent.Wait(timer.GetTimeLeft());
+    m_extTimeout = timer.GetTimeLeft();
+  }
+}
 
+void CActiveAE::InitProcess()
+{
   m_state = AE_TOP_WAIT_PRECOND;
   m_extTimeout = 1000ms;
   m_bStateMachineSelfTrigger = false;
@@ -1072,92 +1108,185 @@ void CActiveAE::Process()
   // start sink
   m_sink.SetAudio2(m_bAudio2);
   m_sink.Start();
+}
 
-  while (!m_bStop)
+/*!
+ * \brief Handles one pending message or an expired timeout
+ * \return false if there was nothing to do
+ */
+bool CActiveAE::ProcessOnce(XbmcThreads::EndTime<>& timer)
+{
+  if (ProcessMessage())
   {
-    gotMsg = false;
-    timer.Set(m_extTimeout);
+  }
+  else if (timer.IsTimePast())
+  {
+    ProcessTimeout();
+  }
+  else
+    return false;
 
-    if (m_bStateMachineSelfTrigger)
-    {
-      m_bStateMachineSelfTrigger = false;
-      // self trigger state machine
-      StateMachine(msg->signal, port, msg);
-      if (!m_bStateMachineSelfTrigger)
-      {
-        msg->Release();
-        msg = NULL;
-      }
-      continue;
-    }
-    // check control port
-    else if (m_controlPort.ReceiveOutMessage(&msg))
-    {
-      gotMsg = true;
-      port = &m_controlPort;
-    }
-    // check sink data port
-    else if (m_sink.m_dataPort.ReceiveInMessage(&msg))
-    {
-      gotMsg = true;
-      port = &m_sink.m_dataPort;
-    }
-    else if (!m_extDeferData)
+  timer.Set(m_extTimeout);
+  return true;
+}
+
+bool CActiveAE::ProcessMessage()
+{
+  if (m_bStateMachineSelfTrigger)
+  {
+    m_bStateMachineSelfTrigger = false;
+    // self trigger state machine
+    StateMachine(m_processMsg->signal, m_processPort, m_processMsg);
+  }
+  // check control port
+  else if (m_controlPort.ReceiveOutMessage(&m_processMsg))
+  {
+    m_processPort = &m_controlPort;
+    StateMachine(m_processMsg->signal, m_processPort, m_processMsg);
+  }
+  // check samples returned by the sink
+  else if (m_sink.GetReturnedSample(m_returnedSample))
+  {
+    StateMachine(CSinkDataProtocol::RETURNSAMPLE, &m_sink.m_dataPort, nullptr);
+    m_returnedSample = nullptr;
+    return true;
+  }
+  // check sink data port
+  else if (m_sink.m_dataPort.ReceiveInMessage(&m_processMsg))
+  {
+    m_processPort = &m_sink.m_dataPort;
+    StateMachine(m_processMsg->signal, m_processPort, m_processMsg);
+  }
+  else
+  {
+    bool gotMsg = false;
+    if (!m_extDeferData)
     {
       // check data port
-      if (m_dataPort.ReceiveOutMessage(&msg))
-      {
+      if (m_dataPort.ReceiveOutMessage(&m_processMsg))
         gotMsg = true;
-        port = &m_dataPort;
-      }
       // stream data ports
       else
       {
-        std::list<CActiveAEStream*>::iterator it;
-        for(it=m_streams.begin(); it!=m_streams.end(); ++it)
+        for (auto* stream : m_streams)
         {
-          if((*it)->m_streamPort->ReceiveOutMessage(&msg))
+          if (stream->m_streamPort->ReceiveOutMessage(&m_processMsg))
           {
             gotMsg = true;
-            port = &m_dataPort;
             break;
           }
         }
       }
     }
+    if (!gotMsg)
+      return false;
+
+    m_processPort = &m_dataPort;
+    StateMachine(m_processMsg->signal, m_processPort, m_processMsg);
+  }
+
+  if (!m_bStateMachineSelfTrigger)
+  {
+    m_processMsg->Release();
+    m_processMsg = NULL;
+  }
+  return true;
+}
 
-    if (gotMsg)
+void CActiveAE::ProcessTimeout()
+{
+  m_processMsg = m_controlPort.GetMessage();
+  m_processMsg->signal = CActiveAEControlProtocol::TIMEOUT;
+  m_processPort = 0;
+  // signal timeout to state machine
+  StateMachine(m_processMsg->signal, m_processPort, m_processMsg);
+  if (!m_bStateMachineSelfTrigger)
+  {
+    m_processMsg->Release();
+    m_processMsg = NULL;
+  }
+}
+
+/*!
+ * \brief Drives the state machines of this engine and its guest
+ *
+ * Each engine keeps its own ports, timeouts and sink thread, only the
+ * waiting is done on both message events at once.
+ */
+void CActiveAE::ProcessShared()
+{
+  CActiveAE* guest = nullptr;
+  std::unique_ptr<XbmcThreads::CEventGroup> events;
+  XbmcThreads::EndTime<> timer(m_extTimeout);
+  XbmcThreads::EndTime<> guestTimer;
+
+  while (!m_bStop)
+  {
     {
-      StateMachine(msg->signal, port, msg);
-      if (!m_bStateMachineSelfTrigger)
+      std::unique_lock<CCriticalSection> lock(m_guestLock);
+      if (guest != m_guestEngine)
       {
-        msg->Release();
-        msg = NULL;
+        events.reset();
+        if (!guest)
+        {
+          guest = m_guestEngine;
+          guest->InitProcess();
+          guestTimer.Set(guest->m_extTimeout);
+          m_guestProcessing = true;
+          events.reset(new XbmcThreads::CEventGroup{&m_outMsgEvent, &guest->m_outMsgEvent});
+          CLog::Log(LOGINFO, "ActiveAE::{} - running 2nd engine on this thread", __FUNCTION__);
+        }
+        else
+        {
+          guest = nullptr;
+          m_guestProcessing = false;
+          m_guestDetached.Set();
+        }
       }
-      continue;
     }
 
-    // wait for message
-    else if (m_outMsgEvent.Wait(m_extTimeout))
-    {
-      m_extTimeout = timer.GetTimeLeft();
+    bool busy = ProcessOnce(timer);
+    if (guest && guest->ProcessOnce(guestTimer))
+      busy = true;
+
+    if (busy)
       continue;
-    }
-    // time out
-    else
+
+    if (guest)
     {
-      msg = m_controlPort.GetMessage();
-      msg->signal = CActiveAEControlProtocol::TIMEOUT;
-      port = 0;
-      // signal timeout to state machine
-      StateMachine(msg->signal, port, msg);
-      if (!m_bStateMachineSelfTrigger)
-      {
-        msg->Release();
-        msg = NULL;
-      }
+      events->wait(std::min(timer.GetTimeLeft(), guestTimer.GetTimeLeft()));
+      guest->m_extTimeout = guestTimer.GetTimeLeft();
     }
+    else
+      m_outMsgEvent.Wait(timer.GetTimeLeft());
+    m_extTimeout = timer.GetTimeLeft();
+  }
+
+  std::unique_lock<CCriticalSection> lock(m_guestLock);
+  m_guestProcessing = false;
+  m_guestDetached.Set();
+}
+
+void CActiveAE::SetHostEngine(CActiveAE* host)
+{
+  m_hostEngine = host;
+  std::unique_lock<CCriticalSection> lock(host->m_guestLock);
+  host->m_guestEngine = this;
+}
+
+void CActiveAE::DetachGuestEngine()
+{
+  {
+    std::unique_lock<CCriticalSection> lock(m_guestLock);
+    m_guestEngine = nullptr;
+    if (!m_guestProcessing)
+      return;
+    m_guestDetached.Reset();
   }
+  m_outMsgEvent.Set();
+
+  // the engine thread must not touch the guest anymore
+  m_guestDetached.Wait();
 }
 
 AEAudioFormat CActiveAE::GetInputFormat(AEAudioFormat *desiredFmt)
@@ -1638,7 +1767,7 @@ void CActiveAE::ClearDiscardedBuffers()
       rbuf->Flush();
     }
     // if all buffers have returned, we can delete the buffer pool
-    if ((*it) && (*it)->m_allSamples.size() == (*it)->m_freeSamples.size())
+    if ((*it) && (*it)->m_allSamples.size() == (*it)->GetFreeCount())
     {
       delete (*it);
       CLog::Log(LOGDEBUG, "CActiveAE::ClearDiscardedBuffers - buffer pool deleted");
@@ -1942,6 +2071,7 @@ void CActiveAE::UnconfigureSink()
 bool CActiveAE::RunStages()
 {
   bool busy = false;
+  const uint64_t growth = CActiveAEBufferPool::GetGrowthCount();
 
   // serve input streams
   std::list<CActiveAEStream*>::iterator it;
@@ -1967,7 +2097,7 @@ bool CActiveAE::RunStages()
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
       while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) &&
-             !(*it)->m_inputBuffers->m_freeSamples.empty())
+             (*it)->m_inputBuffers->HasFreeBuffer())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -2012,7 +2142,7 @@ bool CActiveAE::RunStages()
       (m_mode == MODE_RAW && m_sinkFormat.m_streamInfo.m_type == CAEStreamInfo::STREAM_TYPE_TRUEHD);
 
   if ((m_stats.GetWaterLevel() < (MAX_WATER_LEVEL + 0.0001f) || ignoreWL) &&
-      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
+      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && m_encoderBuffers->HasFreeBuffer())))
   {
     // calculate sync error
     for (it = m_streams.begin(); it != m_streams.end(); ++it)
@@ -2053,7 +2183,7 @@ bool CActiveAE::RunStages()
       CSampleBuffer *out = NULL;
       if (!m_sounds_playing.empty() && m_streams.empty())
       {
-        if (m_silenceBuffers && !m_silenceBuffers->m_freeSamples.empty())
+        if (m_silenceBuffers && m_silenceBuffers->HasFreeBuffer())
         {
           out = m_silenceBuffers->GetFreeBuffer();
           for (int i=0; i<out->pkt->planes; i++)
@@ -2162,15 +2292,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEUtil::MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2231,24 +2353,8 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (CAEUtil::MulAddArray(dst, src, volume, nb_floats))
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2283,7 +2389,7 @@ bool CActiveAE::RunStages()
               m_vizInitialized = true;
             }
 
-            if (!m_vizBuffersInput->m_freeSamples.empty())
+            if (m_vizBuffersInput->HasFreeBuffer())
             {
               // copy the samples into the viz input buffer
               CSampleBuffer *viz = m_vizBuffersInput->GetFreeBuffer();
@@ -2386,12 +2492,22 @@ bool CActiveAE::RunStages()
   {
     CSampleBuffer *out = NULL;
     out = m_sinkBuffers->m_outputSamples.front();
+    // sample queue full, keep the sample and retry when the sink returns one
+    if (!m_sink.QueueSample(out))
+      break;
     m_sinkBuffers->m_outputSamples.pop_front();
-    m_sink.m_dataPort.SendOutMessage(CSinkDataProtocol::SAMPLE,
-        &out, sizeof(CSampleBuffer*));
     busy = true;
   }
 
+  // pools are allocated on configure, only sample queues may still grow
+  // until they have reached their working size
+  if (CActiveAEBufferPool::GetGrowthCount() != growth)
+  {
+    m_stageGrowth += CActiveAEBufferPool::GetGrowthCount() - growth;
+    CLog::Log(LOGDEBUG, "CActiveAE::{} - pool or sample queue grew in processing stages, total: {}",
+              __FUNCTION__, m_stageGrowth.load());
+  }
+
   return busy;
 }
 
@@ -2592,7 +2708,11 @@ CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
   if (!newerror || stream->m_syncState != CAESyncInfo::AESyncState::SYNC_INSYNC)
     return ret;
 
-  if (stream->m_resampleMode)
+  if (stream->m_resampleMode == 2)
+  {
+    // ratio is set by the owner of the stream
+  }
+  else if (stream->m_resampleMode)
   {
     if (stream->m_processingBuffers)
     {
@@ -2637,12 +2757,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2667,13 +2782,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2812,7 +2921,9 @@ void CActiveAE::CheckDevice2(bool bPreInitSink)
 
 void CActiveAE::Start()
 {
-  Create();
+  // a hosted engine is processed by the thread of its host
+  if (!m_hostEngine)
+    Create();
   Message *reply;
   if (m_controlPort.SendOutMessageSync(CActiveAEControlProtocol::INIT,
                                                  &reply,
@@ -3240,6 +3351,29 @@ bool CActiveAE::CompareFormat(const AEAudioFormat& lhs, const AEAudioFormat& rhs
  */
 
 IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
+{
+  // No custom deleter until sound is registered
+  auto sound = std::make_unique<CActiveAESound>(file, this);
+  sound->SetAudio2(m_bAudio2);
+
+  // decode each file once, the other engine gets the same samples
+  CActiveAESoundStore& store = CActiveAESoundStore::GetInstance();
+  std::shared_ptr<CSoundPacket> decoded = store.Get(file);
+  if (decoded)
+    sound->SetSound(true, std::move(decoded));
+  else if (DecodeSound(*sound, file))
+    sound->SetSound(true, store.Add(file, sound->ShareSound(true)));
+  else
+    return nullptr;
+
+  // register sound
+  m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+
+  // transfer ownership to std::unique_ptr that unregisters the sound
+  return {sound.release(), IAESoundDeleter(*this)};
+}
+
+bool CActiveAE::DecodeSound(CActiveAESound& sound, const std::string& file)
 {
   AVFormatContext *fmt_ctx = nullptr;
   AVCodecContext *dec_ctx = nullptr;
@@ -3248,28 +3382,25 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
   AVCodec *dec = nullptr;
   SampleConfig config;
 
-  // No custom deleter until sound is registered
-  auto sound = std::make_unique<CActiveAESound>(file, this);
-  sound->SetAudio2(m_bAudio2);
-  if (!sound->Prepare())
+  if (!sound.Prepare())
   {
-    return nullptr;
+    return false;
   }
-  int fileSize = sound->GetFileSize();
+  int fileSize = sound.GetFileSize();
 
   int bufferSize = 4096;
-  int blockSize = sound->GetChunkSize();
+  int blockSize = sound.GetChunkSize();
   if (blockSize > 1)
     bufferSize = blockSize;
 
   fmt_ctx = avformat_alloc_context();
   unsigned char* buffer = (unsigned char*)av_malloc(bufferSize);
-  io_ctx = avio_alloc_context(buffer, bufferSize, 0, sound.get(), CActiveAESound::Read, NULL,
+  io_ctx = avio_alloc_context(buffer, bufferSize, 0, &sound, CActiveAESound::Read, NULL,
                               CActiveAESound::Seek);
 
   io_ctx->max_packet_size = bufferSize;
 
-  if (!sound->IsSeekPossible())
+  if (!sound.IsSeekPossible())
   {
     io_ctx->seekable = 0;
     io_ctx->max_packet_size = 0;
@@ -3286,7 +3417,7 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
       av_freep(&io_ctx->buffer);
       av_freep(&io_ctx);
     }
-    return nullptr;
+    return false;
   }
 
   // find decoder
@@ -3310,7 +3441,7 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
       av_freep(&io_ctx->buffer);
       av_freep(&io_ctx);
     }
-    return nullptr;
+    return false;
   }
 
   dec_ctx = avcodec_alloc_context3(dec);
@@ -3353,11 +3484,11 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
           int samples = fileSize / av_get_bytes_per_sample(dec_ctx->sample_fmt) / config.channels;
           config.fmt = dec_ctx->sample_fmt;
           config.bits_per_sample = dec_ctx->bits_per_coded_sample;
-          sound->InitSound(true, config, samples);
+          sound.InitSound(true, config, samples);
           init = true;
         }
-        sound->StoreSound(true, decoded_frame->extended_data,
-                          decoded_frame->nb_samples, decoded_frame->linesize[0]);
+        sound.StoreSound(true, decoded_frame->extended_data,
+                         decoded_frame->nb_samples, decoded_frame->linesize[0]);
       }
       av_packet_unref(avpkt);
 
@@ -3372,8 +3503,8 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
     {
       if (ret == 0)
       {
-        sound->StoreSound(true, decoded_frame->extended_data,
-                          decoded_frame->nb_samples, decoded_frame->linesize[0]);
+        sound.StoreSound(true, decoded_frame->extended_data,
+                         decoded_frame->nb_samples, decoded_frame->linesize[0]);
       }
       else
       {
@@ -3393,18 +3524,14 @@ IAE::SoundPtr CActiveAE::MakeSound(const std::string& file)
     av_freep(&io_ctx);
   }
 
-  if (error)
+  if (error || !sound.GetSound(true))
   {
-    return nullptr;
+    return false;
   }
 
-  sound->Finish();
-
-  // register sound
-  m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+  sound.Finish();
 
-  // transfer ownership to std::unique_ptr that unregisters the sound
-  return {sound.release(), IAESoundDeleter(*this)};
+  return true;
 }
 
 void CActiveAE::FreeSound(IAESound *sound)
@@ -3482,6 +3609,21 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
     }
   }
 
+  // engines with the same internal format share the converted samples
+  CActiveAESoundStore& store = CActiveAESoundStore::GetInstance();
+  const std::string key = StringUtils::Format(
+      "{}|{}|{}|{}|{}|{}|{}|{}", sound->GetFileName(), dst_config.channel_layout,
+      dst_config.channels, dst_config.sample_rate, static_cast<int>(dst_config.fmt),
+      dst_config.dither_bits, static_cast<int>(testChannel),
+      static_cast<int>(m_settings.resampleQuality));
+  std::shared_ptr<CSoundPacket> converted = store.Get(key);
+  if (converted)
+  {
+    sound->SetSound(false, std::move(converted));
+    sound->SetConverted(true);
+    return true;
+  }
+
   IAEResample *resampler = CAEResampleFactory::Create(AERESAMPLEFACTORY_QUICK_RESAMPLE);
 
   resampler->Init(dst_config, orig_config,
@@ -3510,6 +3652,7 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
   sound->GetSound(false)->nb_samples = samples;
 
   delete resampler;
+  sound->SetSound(false, store.Add(key, sound->ShareSound(false)));
   sound->SetConverted(true);
   return true;
 }
@@ -16,6 +16,7 @@
 #include "threads/SystemClock.h"
 #include "threads/Thread.h"
 
+#include <atomic>
 #include <list>
 #include <queue>
 #include <string>
@@ -242,6 +243,19 @@ public:
   bool IsSuspended() override;
   void OnSettingsChange();
 
+  /*!
+   * \brief Run the state machine of this engine on the thread of host
+   *
+   * Must be called before either engine is started. Only the sinks keep
+   * their own threads, both mixes are processed in one pass.
+   */
+  void SetHostEngine(CActiveAE* host);
+
+  /*!
+   * \brief Times pools or sample queues grew in the processing stages since the engine was created
+   */
+  uint64_t GetStageGrowth() const { return m_stageGrowth; }
+
   float GetVolume() override;
   void SetVolume(const float volume) override;
   void SetMute(const bool enabled) override;
@@ -303,6 +317,12 @@ protected:
 
 protected:
   void Process() override;
+  void InitProcess();
+  bool ProcessOnce(XbmcThreads::EndTime<>& timer);
+  bool ProcessMessage();
+  void ProcessTimeout();
+  void ProcessShared();
+  void DetachGuestEngine();
   void StateMachine(int signal, Protocol *port, Message *msg);
   bool InitSink();
   void DrainSink();
@@ -335,6 +355,7 @@ protected:
 
   void ResampleSounds();
   bool ResampleSound(CActiveAESound *sound);
+  bool DecodeSound(CActiveAESound& sound, const std::string& file);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
 
@@ -356,6 +377,16 @@ protected:
   bool m_extSuspended = false;
   bool m_isWinSysReg = false;
 
+  // engine thread
+  Message* m_processMsg = nullptr;
+  Protocol* m_processPort = nullptr;
+  CSampleBuffer* m_returnedSample = nullptr; // sample popped from the sink's return queue
+  CActiveAE* m_hostEngine = nullptr; // runs our state machine
+  CActiveAE* m_guestEngine = nullptr; // state machine we run
+  CCriticalSection m_guestLock;
+  bool m_guestProcessing = false;
+  CEvent m_guestDetached;
+
   enum
   {
     MODE_RAW,
@@ -385,6 +416,7 @@ protected:
   // streams
   std::list<CActiveAEStream*> m_streams;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
+  std::atomic<uint64_t> m_stageGrowth{0}; // pools and queues grown in RunStages
   unsigned int m_streamIdGen;
 
   // gui sounds
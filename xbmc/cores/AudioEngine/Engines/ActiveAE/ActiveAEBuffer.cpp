@@ -12,9 +12,109 @@
 #include "ActiveAEFilter.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/CriticalSection.h"
+
+#include <mutex>
+#include <utility>
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavutil/samplefmt.h>
+}
 
 using namespace ActiveAE;
 
+namespace
+{
+// same alignment as CActiveAE::AllocSoundSample
+constexpr int PLANE_ALIGN = 16;
+// start of each packet within a slab
+constexpr size_t PACKET_ALIGN = 64;
+
+thread_local uint64_t poolGrowth = 0;
+
+/**
+ * Slabs of pools that have been destroyed. Pools are recreated on every
+ * format change and seek, usually with the same size as before. Handing
+ * the slab to the next pool saves the allocation and page faults.
+ */
+class CSlabCache
+{
+public:
+  ~CSlabCache()
+  {
+    for (auto& slab : m_slabs)
+      av_free(slab.first);
+  }
+
+  uint8_t* Get(size_t size, size_t& capacity)
+  {
+    {
+      std::unique_lock<CCriticalSection> lock(m_lock);
+      auto best = m_slabs.end();
+      for (auto it = m_slabs.begin(); it != m_slabs.end(); ++it)
+      {
+        // do not tie up a large slab in a small pool
+        if (it->second < size || it->second > size * 2)
+          continue;
+        if (best == m_slabs.end() || it->second < best->second)
+          best = it;
+      }
+      if (best != m_slabs.end())
+      {
+        uint8_t* slab = best->first;
+        capacity = best->second;
+        m_slabs.erase(best);
+        return slab;
+      }
+    }
+
+    CActiveAEBufferPool::CountGrowth();
+    capacity = size;
+    return static_cast<uint8_t*>(av_malloc(size));
+  }
+
+  void Put(uint8_t* slab, size_t capacity)
+  {
+    std::unique_lock<CCriticalSection> lock(m_lock);
+    if (m_slabs.size() >= MAX_SLABS)
+    {
+      // drop the smallest one, large slabs fit more formats
+      auto smallest = m_slabs.begin();
+      for (auto it = m_slabs.begin(); it != m_slabs.end(); ++it)
+      {
+        if (it->second < smallest->second)
+          smallest = it;
+      }
+      if (smallest->second >= capacity)
+      {
+        av_free(slab);
+        return;
+      }
+      av_free(smallest->first);
+      m_slabs.erase(smallest);
+    }
+    m_slabs.emplace_back(slab, capacity);
+  }
+
+private:
+  static constexpr size_t MAX_SLABS = 8;
+  CCriticalSection m_lock;
+  std::vector<std::pair<uint8_t*, size_t>> m_slabs;
+};
+
+CSlabCache& GetSlabCache()
+{
+  static CSlabCache cache;
+  return cache;
+}
+
+size_t AlignPacket(size_t size)
+{
+  return (size + PACKET_ALIGN - 1) & ~(PACKET_ALIGN - 1);
+}
+} // namespace
+
 CSoundPacket::CSoundPacket(const SampleConfig& conf, int samples, bool bAudio2) : config(conf)
 {
   m_bAudio2 = bAudio2;
@@ -24,12 +124,35 @@ CSoundPacket::CSoundPacket(const SampleConfig& conf, int samples, bool bAudio2)
   pause_burst_ms = 0;
 }
 
+CSoundPacket::CSoundPacket(const SampleConfig& conf, int samples, uint8_t* buffer, bool bAudio2)
+  : config(conf)
+{
+  m_bAudio2 = bAudio2;
+  m_ownsData = false;
+  planes = av_sample_fmt_is_planar(config.fmt) ? config.channels : 1;
+  data = new uint8_t*[planes];
+  av_samples_fill_arrays(data, &linesize, buffer, config.channels, samples, config.fmt,
+                         PLANE_ALIGN);
+  bytes_per_sample = av_get_bytes_per_sample(config.fmt);
+  max_nb_samples = samples;
+  nb_samples = 0;
+  pause_burst_ms = 0;
+}
+
 CSoundPacket::~CSoundPacket()
 {
-  if (data)
+  if (!m_ownsData)
+    delete[] data;
+  else if (data)
     CActiveAE::FreeSoundSample(data);
 }
 
+size_t CSoundPacket::GetBufferSize(const SampleConfig& conf, int samples)
+{
+  int size = av_samples_get_buffer_size(nullptr, conf.channels, samples, conf.fmt, PLANE_ALIGN);
+  return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
 CSampleBuffer::~CSampleBuffer()
 {
   delete pkt;
@@ -48,6 +171,49 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+void CSampleQueue::push_back(CSampleBuffer* buffer)
+{
+  if (m_size == m_items.size())
+    reserve(m_items.empty() ? 16 : m_items.size() * 2);
+
+  m_items[(m_head + m_size) & m_mask] = buffer;
+  m_size++;
+}
+
+void CSampleQueue::pop_front()
+{
+  m_head = (m_head + 1) & m_mask;
+  m_size--;
+}
+
+void CSampleQueue::reserve(size_t capacity)
+{
+  if (capacity <= m_items.size())
+    return;
+
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+
+  std::vector<CSampleBuffer*> items(size);
+  for (size_t i = 0; i < m_size; i++)
+    items[i] = At(i);
+  m_items.swap(items);
+  m_head = 0;
+  m_mask = size - 1;
+  CActiveAEBufferPool::CountGrowth();
+}
+
+uint64_t CActiveAEBufferPool::GetGrowthCount()
+{
+  return poolGrowth;
+}
+
+void CActiveAEBufferPool::CountGrowth()
+{
+  poolGrowth++;
+}
+
 CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format, bool bAudio2) : m_format(format)
 {
   m_bAudio2 = bAudio2;
@@ -63,23 +229,23 @@ CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format, bool bAudi
 
 CActiveAEBufferPool::~CActiveAEBufferPool()
 {
-  CSampleBuffer *buffer;
-  while(!m_allSamples.empty())
-  {
-    buffer = m_allSamples.front();
-    m_allSamples.pop_front();
+  for (auto* buffer : m_allSamples)
     delete buffer;
-  }
+  m_allSamples.clear();
+
+  if (m_slab)
+    GetSlabCache().Put(m_slab, m_slabSize);
 }
 
 CSampleBuffer* CActiveAEBufferPool::GetFreeBuffer()
 {
-  CSampleBuffer* buf = NULL;
+  CSampleBuffer* buf = m_freeList;
 
-  if (!m_freeSamples.empty())
+  if (buf)
   {
-    buf = m_freeSamples.front();
-    m_freeSamples.pop_front();
+    m_freeList = buf->nextFree;
+    m_freeCount--;
+    buf->nextFree = nullptr;
     buf->refCount = 1;
     buf->centerMixLevel = M_SQRT1_2;
   }
@@ -90,7 +256,9 @@ void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
 {
   buffer->pkt->nb_samples = 0;
   buffer->pkt->pause_burst_ms = 0;
-  m_freeSamples.push_back(buffer);
+  buffer->nextFree = m_freeList;
+  m_freeList = buffer;
+  m_freeCount++;
 }
 
 bool CActiveAEBufferPool::Create(unsigned int totaltime)
@@ -112,15 +280,27 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   }
   unsigned int n = 0;
   while (time < totaltime || n < 5)
+  {
+    time += buffertime;
+    n++;
+  }
+
+  // all planes live in a single slab, which may be left over from a
+  // previous pool
+  const size_t packetSize = AlignPacket(CSoundPacket::GetBufferSize(config, m_format.m_frames));
+  m_slab = GetSlabCache().Get(packetSize * n, m_slabSize);
+  if (!m_slab)
+    return false;
+
+  m_allSamples.reserve(m_allSamples.size() + n);
+  for (unsigned int i = 0; i < n; i++)
   {
     buffer = new CSampleBuffer();
     buffer->pool = this;
-    buffer->pkt = new CSoundPacket(config, m_format.m_frames, m_bAudio2);
+    buffer->pkt = new CSoundPacket(config, m_format.m_frames, m_slab + i * packetSize, m_bAudio2);
 
     m_allSamples.push_back(buffer);
-    m_freeSamples.push_back(buffer);
-    time += buffertime;
-    n++;
+    ReturnBuffer(buffer);
   }
 
   return true;
@@ -155,6 +335,8 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
 {
   CActiveAEBufferPool::Create(totaltime);
+  m_inputSamples.reserve(m_allSamples.size());
+  m_outputSamples.reserve(m_allSamples.size());
 
   m_remap = remap;
   m_stereoUpmix = upmix;
@@ -234,7 +416,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffer())
   {
     int free_samples;
     if (m_procSample)
@@ -384,19 +566,18 @@ void CActiveAEBufferPoolResample::ConfigureResampler(bool normalizelevels, bool
 float CActiveAEBufferPoolResample::GetDelay()
 {
   float delay = 0;
-  std::deque<CSampleBuffer*>::iterator itBuf;
 
   if (m_procSample)
     delay += (float)m_procSample->pkt->nb_samples / m_procSample->pkt->config.sample_rate;
 
-  for(itBuf=m_inputSamples.begin(); itBuf!=m_inputSamples.end(); ++itBuf)
+  for (auto &buf : m_inputSamples)
   {
-    delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+    delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
   }
 
-  for(itBuf=m_outputSamples.begin(); itBuf!=m_outputSamples.end(); ++itBuf)
+  for (auto &buf : m_outputSamples)
   {
-    delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+    delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
   }
 
   if (m_resampler)
@@ -481,6 +662,8 @@ CActiveAEBufferPoolAtempo::~CActiveAEBufferPoolAtempo()
 bool CActiveAEBufferPoolAtempo::Create(unsigned int totaltime)
 {
   CActiveAEBufferPool::Create(totaltime);
+  m_inputSamples.reserve(m_allSamples.size());
+  m_outputSamples.reserve(m_allSamples.size());
 
   m_pTempoFilter.reset(new CActiveAEFilter());
   m_pTempoFilter->Init(CAEUtil::GetAVSampleFormat(m_format.m_dataFormat), m_format.m_sampleRate, CAEUtil::GetAVChannelLayout(m_format.m_channelLayout));
@@ -515,7 +698,7 @@ bool CActiveAEBufferPoolAtempo::ProcessBuffers()
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffer())
   {
     bool skipInput = false;
 
@@ -11,8 +11,9 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include <cmath>
-#include <deque>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -29,7 +30,13 @@ class CSoundPacket
 {
 public:
   CSoundPacket(const SampleConfig& conf, int samples, bool bAudio2 = false);
+  /*!
+   * \brief Packet with planes in memory owned by the caller
+   * \param buffer must hold at least GetBufferSize(conf, samples) bytes
+   */
+  CSoundPacket(const SampleConfig& conf, int samples, uint8_t* buffer, bool bAudio2 = false);
   ~CSoundPacket();
+  static size_t GetBufferSize(const SampleConfig& conf, int samples);
   uint8_t **data;                        // array with pointers to planes of data
   SampleConfig config;
   int bytes_per_sample;                  // bytes per sample and per channel
@@ -40,6 +47,7 @@ public:
   int pause_burst_ms;
 protected:
   bool m_bAudio2;
+  bool m_ownsData = true;
 };
 
 class CActiveAEBufferPool;
@@ -57,6 +65,49 @@ public:
   int pkt_start_offset = 0;
   int refCount = 0;
   double centerMixLevel;
+  CSampleBuffer *nextFree = nullptr;     // link in the free list of the pool
+};
+
+/**
+ * fifo of sample buffers, storage grows on demand and is never released,
+ * so it stops allocating once it has reached its working size
+ */
+class CSampleQueue
+{
+public:
+  class iterator
+  {
+  public:
+    iterator(const CSampleQueue* queue, size_t pos) : m_queue(queue), m_pos(pos) {}
+    CSampleBuffer* const& operator*() const { return m_queue->At(m_pos); }
+    iterator& operator++()
+    {
+      ++m_pos;
+      return *this;
+    }
+    bool operator!=(const iterator& rhs) const { return m_pos != rhs.m_pos; }
+
+  private:
+    const CSampleQueue* m_queue;
+    size_t m_pos;
+  };
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+  CSampleBuffer* front() const { return m_items[m_head]; }
+  void push_back(CSampleBuffer* buffer);
+  void pop_front();
+  void reserve(size_t capacity);
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, m_size); }
+
+private:
+  CSampleBuffer* const& At(size_t pos) const { return m_items[(m_head + pos) & m_mask]; }
+
+  std::vector<CSampleBuffer*> m_items;
+  size_t m_head = 0;
+  size_t m_size = 0;
+  size_t m_mask = 0;
 };
 
 class CActiveAEBufferPool
@@ -67,11 +118,24 @@ public:
   virtual bool Create(unsigned int totaltime);
   CSampleBuffer *GetFreeBuffer();
   void ReturnBuffer(CSampleBuffer *buffer);
+  bool HasFreeBuffer() const { return m_freeList != nullptr; }
+  size_t GetFreeCount() const { return m_freeCount; }
+  /*!
+   * \brief Slabs and queue storage allocated by pools and sample queues on the calling thread
+   *
+   * Buffers are allocated in Create, once the engine is running this
+   * must not move. Other heap allocations, e.g. by ffmpeg, are not counted.
+   */
+  static uint64_t GetGrowthCount();
+  static void CountGrowth();
   AEAudioFormat m_format;
-  std::deque<CSampleBuffer*> m_allSamples;
-  std::deque<CSampleBuffer*> m_freeSamples;
+  std::vector<CSampleBuffer*> m_allSamples;
 protected:
   bool m_bAudio2;
+  CSampleBuffer *m_freeList = nullptr;
+  size_t m_freeCount = 0;
+  uint8_t *m_slab = nullptr;             // planes of all packets
+  size_t m_slabSize = 0;
 };
 
 class IAEResample;
@@ -94,8 +158,8 @@ public:
   bool DoesNormalize() const;
   void ForceResampler(bool force);
   AEAudioFormat m_inputFormat;
-  std::deque<CSampleBuffer*> m_inputSamples;
-  std::deque<CSampleBuffer*> m_outputSamples;
+  CSampleQueue m_inputSamples;
+  CSampleQueue m_outputSamples;
 
 protected:
   void ChangeResampler();
@@ -132,8 +196,8 @@ public:
   float GetTempo() const;
   void FillBuffer();
   void SetDrain(bool drain);
-  std::deque<CSampleBuffer*> m_inputSamples;
-  std::deque<CSampleBuffer*> m_outputSamples;
+  CSampleQueue m_inputSamples;
+  CSampleQueue m_outputSamples;
 
 protected:
   void ChangeFilter();
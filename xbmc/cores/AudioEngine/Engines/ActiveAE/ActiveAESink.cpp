@@ -57,6 +57,17 @@ void CActiveAESink::Dispose()
   StopThread();
   m_controlPort.Purge();
   m_dataPort.Purge();
+  if (m_pendingDataMsg)
+  {
+    m_pendingDataMsg->Release();
+    m_pendingDataMsg = nullptr;
+  }
+  // samples still queued belong to the engine's buffer pools, those are
+  // torn down by the engine itself
+  CSampleBuffer* samples;
+  while (m_sampleQueue.Pop(samples))
+    ;
+  m_sample = nullptr;
 
   if (m_sink)
   {
@@ -383,10 +394,10 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         {
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *samples;
-          samples = *((CSampleBuffer**)msg->data);
+          samples = m_sample;
           CThread::Sleep(std::chrono::milliseconds(1000 * samples->pkt->nb_samples /
                                                    samples->pkt->config.sample_rate));
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          ReturnSample(samples);
           m_extTimeout = 0ms;
           return;
         default:
@@ -441,9 +452,9 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         case CSinkDataProtocol::SAMPLE:
           CSampleBuffer *samples;
           unsigned int delay;
-          samples = *((CSampleBuffer**)msg->data);
+          samples = m_sample;
           delay = OutputSamples(samples);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          ReturnSample(samples);
           if (m_extError)
           {
             m_sink->Deinitialize();
@@ -615,6 +626,7 @@ void CActiveAESink::Process()
 {
   Message *msg = nullptr;
   Protocol *port = nullptr;
+  int signal = 0;
   bool gotMsg;
   XbmcThreads::EndTime<> timer;
 
@@ -632,11 +644,13 @@ void CActiveAESink::Process()
     {
       m_bStateMachineSelfTrigger = false;
       // self trigger state machine
-      StateMachine(msg->signal, port, msg);
+      StateMachine(signal, port, msg);
       if (!m_bStateMachineSelfTrigger)
       {
-        msg->Release();
+        if (msg)
+          msg->Release();
         msg = nullptr;
+        m_sample = nullptr;
       }
       continue;
     }
@@ -645,21 +659,48 @@ void CActiveAESink::Process()
     {
       gotMsg = true;
       port = &m_controlPort;
+      signal = msg->signal;
+    }
+    // check sample queue
+    else if (m_sampleQueue.Pop(m_sample))
+    {
+      gotMsg = true;
+      port = &m_dataPort;
+      signal = CSinkDataProtocol::SAMPLE;
+      msg = nullptr;
+    }
+    // data messages wait for samples queued before them
+    else if (m_pendingDataMsg)
+    {
+      gotMsg = true;
+      port = &m_dataPort;
+      msg = m_pendingDataMsg;
+      signal = msg->signal;
+      m_pendingDataMsg = nullptr;
     }
     // check data port
     else if (m_dataPort.ReceiveOutMessage(&msg))
     {
+      if (!m_sampleQueue.IsEmpty())
+      {
+        m_pendingDataMsg = msg;
+        msg = nullptr;
+        continue;
+      }
       gotMsg = true;
       port = &m_dataPort;
+      signal = msg->signal;
     }
 
     if (gotMsg)
     {
-      StateMachine(msg->signal, port, msg);
+      StateMachine(signal, port, msg);
       if (!m_bStateMachineSelfTrigger)
       {
-        msg->Release();
+        if (msg)
+          msg->Release();
         msg = nullptr;
+        m_sample = nullptr;
       }
       continue;
     }
@@ -675,9 +716,10 @@ void CActiveAESink::Process()
     {
       msg = m_controlPort.GetMessage();
       msg->signal = CSinkControlProtocol::TIMEOUT;
+      signal = msg->signal;
       port = 0;
       // signal timeout to state machine
-      StateMachine(msg->signal, port, msg);
+      StateMachine(signal, port, msg);
       if (!m_bStateMachineSelfTrigger)
       {
         msg->Release();
@@ -919,6 +961,13 @@ void CActiveAESink::ReturnBuffers()
 {
   Message *msg = nullptr;
   CSampleBuffer *samples;
+  while (m_sampleQueue.Pop(samples))
+    ReturnSample(samples);
+  if (m_pendingDataMsg)
+  {
+    m_pendingDataMsg->Release();
+    m_pendingDataMsg = nullptr;
+  }
   while (m_dataPort.ReceiveOutMessage(&msg))
   {
     if (msg->signal == CSinkDataProtocol::SAMPLE)
@@ -930,6 +979,25 @@ void CActiveAESink::ReturnBuffers()
   }
 }
 
+bool CActiveAESink::QueueSample(CSampleBuffer* samples)
+{
+  if (!m_sampleQueue.Push(samples))
+    return false;
+  m_outMsgEvent.Set();
+  return true;
+}
+
+void CActiveAESink::ReturnSample(CSampleBuffer* samples)
+{
+  // the engine drains the return queue each time it wakes up, a full queue
+  // means it is stalled: fall back to the message port rather than losing
+  // the buffer
+  if (m_returnQueue.Push(samples))
+    m_inMsgEvent->Set();
+  else
+    m_dataPort.SendInMessage(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+}
+
 unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 {
   uint8_t **buffer = samples->pkt->data;
@@ -13,6 +13,7 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AESink.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 #include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "utils/ActorProtocol.h"
@@ -106,6 +107,17 @@ public:
   CSinkDataProtocol m_dataPort;
   void SetAudio2(bool bAudio2){ m_bAudio2 = bAudio2; }
 
+  /*!
+   * \brief Hand samples to the sink, engine thread only
+   *
+   * Samples bypass m_dataPort, they come back through GetReturnedSample.
+   * Drain and other data messages are still sent through m_dataPort and
+   * are handled after all samples queued before them.
+   * \return false if the queue is full, retry later
+   */
+  bool QueueSample(CSampleBuffer* samples);
+  bool GetReturnedSample(CSampleBuffer*& samples) { return m_returnQueue.Pop(samples); }
+
 protected:
   void Process() override;
   void StateMachine(int signal, Protocol *port, Message *msg);
@@ -113,6 +125,7 @@ protected:
   void GetDeviceFriendlyName(const std::string& device);
   void OpenSink();
   void ReturnBuffers();
+  void ReturnSample(CSampleBuffer* samples);
   void SetSilenceTimer();
   bool NeedIECPacking();
 
@@ -123,6 +136,13 @@ protected:
 
   CEvent m_outMsgEvent;
   CEvent *m_inMsgEvent;
+
+  // data path to and from the engine
+  static constexpr size_t SAMPLE_QUEUE_SIZE = 1024;
+  XbmcThreads::CSPSCQueue<CSampleBuffer*> m_sampleQueue{SAMPLE_QUEUE_SIZE};
+  XbmcThreads::CSPSCQueue<CSampleBuffer*> m_returnQueue{SAMPLE_QUEUE_SIZE};
+  CSampleBuffer* m_sample = nullptr; // sample being processed by the state machine
+  Message* m_pendingDataMsg = nullptr; // waits for queued samples to be played
   int m_state;
   bool m_bStateMachineSelfTrigger;
   std::chrono::milliseconds m_extTimeout;
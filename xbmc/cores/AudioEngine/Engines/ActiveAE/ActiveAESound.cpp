@@ -13,6 +13,8 @@
 #include "filesystem/File.h"
 #include "utils/log.h"
 
+#include <mutex>
+
 extern "C" {
 #include <libavutil/avutil.h>
 }
@@ -20,14 +22,55 @@ extern "C" {
 using namespace ActiveAE;
 using namespace XFILE;
 
+CActiveAESoundStore& CActiveAESoundStore::GetInstance()
+{
+  static CActiveAESoundStore store;
+  return store;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundStore::Get(const std::string& key)
+{
+  std::unique_lock<CCriticalSection> lock(m_lock);
+
+  auto it = m_sounds.find(key);
+  if (it == m_sounds.end())
+    return nullptr;
+
+  std::shared_ptr<CSoundPacket> sound = it->second.lock();
+  if (!sound)
+    m_sounds.erase(it);
+  return sound;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundStore::Add(const std::string& key,
+                                                       std::shared_ptr<CSoundPacket> sound)
+{
+  std::unique_lock<CCriticalSection> lock(m_lock);
+
+  // drop orphaned entries
+  for (auto it = m_sounds.begin(); it != m_sounds.end();)
+  {
+    if (it->second.expired())
+      it = m_sounds.erase(it);
+    else
+      ++it;
+  }
+
+  auto& entry = m_sounds[key];
+  std::shared_ptr<CSoundPacket> existing = entry.lock();
+  if (existing)
+    return existing;
+
+  entry = sound;
+  return sound;
+}
+
 CActiveAESound::CActiveAESound(const std::string &filename, CActiveAE *ae) :
   IAESound         (filename),
   m_filename       (filename),
   m_volume         (1.0f    ),
   m_channel        (AE_CH_NULL)
 {
-  m_orig_sound = NULL;
-  m_dst_sound = NULL;
   m_pFile = NULL;
   m_isSeekPossible = false;
   m_fileSize = 0;
@@ -37,8 +80,6 @@ CActiveAESound::CActiveAESound(const std::string &filename, CActiveAE *ae) :
 
 CActiveAESound::~CActiveAESound()
 {
-  delete m_orig_sound;
-  delete m_dst_sound;
   Finish();
 }
 
@@ -61,44 +102,36 @@ bool CActiveAESound::IsPlaying()
 
 uint8_t** CActiveAESound::InitSound(bool orig, SampleConfig config, int nb_samples)
 {
-  CSoundPacket **info;
-  if (orig)
-    info = &m_orig_sound;
-  else
-    info = &m_dst_sound;
+  std::shared_ptr<CSoundPacket>& info = orig ? m_orig_sound : m_dst_sound;
 
-  delete *info;
-  *info = new CSoundPacket(config, nb_samples);
+  // samples may be shared with other sounds, never write into them
+  info = std::make_shared<CSoundPacket>(config, nb_samples);
 
-  (*info)->nb_samples = 0;
+  info->nb_samples = 0;
   m_isConverted = false;
-  return (*info)->data;
+  return info->data;
 }
 
 bool CActiveAESound::StoreSound(bool orig, uint8_t **buffer, int samples, int linesize)
 {
-  CSoundPacket **info;
-  if (orig)
-    info = &m_orig_sound;
-  else
-    info = &m_dst_sound;
+  CSoundPacket* info = GetSound(orig);
 
-  if ((*info)->nb_samples + samples > (*info)->max_nb_samples)
+  if (info->nb_samples + samples > info->max_nb_samples)
   {
     CLog::Log(LOGERROR, "CActiveAESound::StoreSound - exceeded max samples");
     return false;
   }
 
-  int bytes_to_copy = samples * (*info)->bytes_per_sample * (*info)->config.channels;
-  bytes_to_copy /= (*info)->planes;
-  int start = (*info)->nb_samples * (*info)->bytes_per_sample * (*info)->config.channels;
-  start /= (*info)->planes;
+  int bytes_to_copy = samples * info->bytes_per_sample * info->config.channels;
+  bytes_to_copy /= info->planes;
+  int start = info->nb_samples * info->bytes_per_sample * info->config.channels;
+  start /= info->planes;
 
-  for (int i=0; i<(*info)->planes; i++)
+  for (int i=0; i<info->planes; i++)
   {
-    memcpy((*info)->data[i]+start, buffer[i], bytes_to_copy);
+    memcpy(info->data[i]+start, buffer[i], bytes_to_copy);
   }
-  (*info)->nb_samples += samples;
+  info->nb_samples += samples;
 
   return true;
 }
@@ -106,9 +139,25 @@ bool CActiveAESound::StoreSound(bool orig, uint8_t **buffer, int samples, int li
 CSoundPacket *CActiveAESound::GetSound(bool orig)
 {
   if (orig)
-    return m_orig_sound;
+    return m_orig_sound.get();
+  else
+    return m_dst_sound.get();
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESound::ShareSound(bool orig)
+{
+  return orig ? m_orig_sound : m_dst_sound;
+}
+
+void CActiveAESound::SetSound(bool orig, std::shared_ptr<CSoundPacket> sound)
+{
+  if (orig)
+  {
+    m_orig_sound = std::move(sound);
+    m_isConverted = false;
+  }
   else
-    return m_dst_sound;
+    m_dst_sound = std::move(sound);
 }
 
 bool CActiveAESound::Prepare()
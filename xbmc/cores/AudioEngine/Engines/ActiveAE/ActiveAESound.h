@@ -10,6 +10,11 @@
 
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
 
 class DllAvUtil;
 
@@ -23,6 +28,29 @@ namespace ActiveAE
 
 class CActiveAE;
 
+/*!
+ * \brief Decoded and converted samples of gui sounds, shared by all engines
+ *
+ * Entries are weak, samples are freed once the last sound using them is gone.
+ */
+class CActiveAESoundStore
+{
+public:
+  static CActiveAESoundStore& GetInstance();
+
+  std::shared_ptr<CSoundPacket> Get(const std::string& key);
+
+  /*!
+   * \brief Add samples to the store
+   * \return the samples to use, those of a concurrent Add if it won
+   */
+  std::shared_ptr<CSoundPacket> Add(const std::string& key, std::shared_ptr<CSoundPacket> sound);
+
+protected:
+  CCriticalSection m_lock;
+  std::map<std::string, std::weak_ptr<CSoundPacket>> m_sounds;
+};
+
 class CActiveAESound : public IAESound
 {
 public:
@@ -41,6 +69,9 @@ public:
   uint8_t** InitSound(bool orig, SampleConfig config, int nb_samples);
   bool StoreSound(bool orig, uint8_t **buffer, int samples, int linesize);
   CSoundPacket *GetSound(bool orig);
+  std::shared_ptr<CSoundPacket> ShareSound(bool orig);
+  void SetSound(bool orig, std::shared_ptr<CSoundPacket> sound);
+  const std::string& GetFileName() const { return m_filename; }
 
   bool IsConverted() { return m_isConverted; }
   void SetConverted(bool state) { m_isConverted = state; }
@@ -63,8 +94,8 @@ protected:
   float m_volume;
   AEChannel m_channel;
 
-  CSoundPacket *m_orig_sound;
-  CSoundPacket *m_dst_sound;
+  std::shared_ptr<CSoundPacket> m_orig_sound;
+  std::shared_ptr<CSoundPacket> m_dst_sound;
 
   bool m_isConverted;
 };
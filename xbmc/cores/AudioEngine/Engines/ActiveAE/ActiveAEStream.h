@@ -16,7 +16,6 @@
 #include "threads/Event.h"
 
 #include <atomic>
-#include <deque>
 
 namespace ActiveAE
 {
@@ -115,8 +114,8 @@ public:
   CActiveAEBufferPool *GetAtempoBuffers();
 
   AEAudioFormat m_inputFormat;
-  std::deque<CSampleBuffer*> m_outputSamples;
-  std::deque<CSampleBuffer*> m_inputSamples;
+  CSampleQueue m_outputSamples;
+  CSampleQueue m_inputSamples;
 
 protected:
   CActiveAEBufferPoolResample *m_resampleBuffers;
@@ -215,7 +214,7 @@ protected:
   // only accessed by engine
   CActiveAEBufferPool *m_inputBuffers;
   CActiveAEStreamBuffers *m_processingBuffers;
-  std::deque<CSampleBuffer*> m_processingSamples;
+  CSampleQueue m_processingSamples;
   CActiveAEDataProtocol *m_streamPort;
   CEvent m_inMsgEvent;
   bool m_drain;
@@ -0,0 +1,314 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkOffline.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/XTimeUtils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+using namespace std::chrono_literals;
+
+/*
+ * Benchmarks of the audio engine without audio hardware. The engine tests
+ * drive CActiveAE through CAESinkOffline and take a few seconds each, run
+ * them with --gtest_also_run_disabled_tests --gtest_filter=TestActiveAEBenchmark*
+ */
+
+namespace
+{
+constexpr unsigned int PERIODS_PER_SECOND = 100;
+constexpr unsigned int AUDIO_SECONDS = 8;
+// the simulated device clock runs this much faster than real time
+constexpr double CLOCK_SPEED = 4.0;
+
+AEAudioFormat GetFormat(AEDataFormat dataFormat, unsigned int sampleRate, AEStdChLayout layout)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = sampleRate;
+  format.m_channelLayout = CAEChannelInfo(layout);
+  format.m_frames = sampleRate / PERIODS_PER_SECOND;
+  format.m_frameSize =
+      format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(dataFormat) >> 3);
+  return format;
+}
+
+// one period of interleaved samples, a 1 kHz tone or silence
+std::vector<uint8_t> GetPeriod(const AEAudioFormat& format, bool signal)
+{
+  std::vector<uint8_t> period(format.m_frames * format.m_frameSize, 0);
+  if (!signal)
+    return period;
+
+  const unsigned int channels = format.m_channelLayout.Count();
+  for (unsigned int frame = 0; frame < format.m_frames; frame++)
+  {
+    const float value =
+        0.25f * std::sin(2.0f * static_cast<float>(M_PI) * 1000.0f * frame / format.m_sampleRate);
+    for (unsigned int ch = 0; ch < channels; ch++)
+    {
+      const unsigned int index = frame * channels + ch;
+      if (format.m_dataFormat == AE_FMT_FLOAT)
+        reinterpret_cast<float*>(period.data())[index] = value;
+      else
+        reinterpret_cast<int16_t*>(period.data())[index] = static_cast<int16_t>(value * 32767);
+    }
+  }
+  return period;
+}
+
+double GetCPUSeconds(std::clock_t start)
+{
+  return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+struct ResampleChain
+{
+  const char* name;
+  AEAudioFormat input;
+  AEAudioFormat output;
+};
+} // namespace
+
+class TestActiveAEBenchmark : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    m_device = m_settings->GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+    m_device2 = m_settings->GetString(CSettings::SETTING_AUDIOOUTPUT2_AUDIODEVICE);
+    m_enabled2 = m_settings->GetBool(CSettings::SETTING_AUDIOOUTPUT2_ENABLED);
+
+    m_settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "OFFLINE:null");
+    m_settings->SetString(CSettings::SETTING_AUDIOOUTPUT2_AUDIODEVICE, "OFFLINE:null2");
+
+    AE::CAESinkFactory::ClearSinks();
+    CAESinkOffline::Register();
+    CAESinkOffline::SetSpeed(CLOCK_SPEED);
+    CAESinkOffline::ResetStats();
+  }
+
+  void TearDown() override
+  {
+    m_settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, m_device);
+    m_settings->SetString(CSettings::SETTING_AUDIOOUTPUT2_AUDIODEVICE, m_device2);
+    m_settings->SetBool(CSettings::SETTING_AUDIOOUTPUT2_ENABLED, m_enabled2);
+    AE::CAESinkFactory::ClearSinks();
+  }
+
+  /*!
+   * \brief Play AUDIO_SECONDS of audio into one stream per engine
+   *
+   * The first quarter is silence, the time the first tone period needs to
+   * reach the sink is the end-to-end latency of the engine.
+   */
+  void Play(const std::vector<CActiveAE*>& engines, const AEAudioFormat& format)
+  {
+    const std::vector<std::string> devices = {"null", "null2"};
+    const std::vector<uint8_t> silence = GetPeriod(format, false);
+    const std::vector<uint8_t> tone = GetPeriod(format, true);
+    const unsigned int totalFrames = AUDIO_SECONDS * format.m_sampleRate;
+    const unsigned int signalFrame = totalFrames / 4;
+
+    std::vector<IAE::StreamPtr> streams;
+    for (auto* engine : engines)
+    {
+      AEAudioFormat streamFormat = format;
+      streams.emplace_back(engine->MakeStream(streamFormat));
+      ASSERT_TRUE(streams.back());
+    }
+
+    std::vector<unsigned int> written(engines.size(), 0);
+    std::vector<std::chrono::steady_clock::time_point> signalTime(engines.size());
+    std::vector<double> reportedDelay(engines.size(), 0.0);
+
+    const std::clock_t cpuStart = std::clock();
+    const auto start = std::chrono::steady_clock::now();
+    bool done = false;
+    while (!done)
+    {
+      done = true;
+      bool added = false;
+      for (size_t i = 0; i < streams.size(); i++)
+      {
+        if (written[i] >= totalFrames)
+          continue;
+        done = false;
+        if (streams[i]->GetSpace() == 0)
+          continue;
+
+        const unsigned int offset = written[i] % format.m_frames;
+        const uint8_t* data = written[i] < signalFrame ? silence.data() : tone.data();
+        const bool signal = written[i] == signalFrame;
+        if (signal)
+          signalTime[i] = std::chrono::steady_clock::now();
+
+        written[i] += streams[i]->AddData(&data, offset, format.m_frames - offset, nullptr);
+        if (signal)
+          reportedDelay[i] = streams[i]->GetDelay();
+        added = true;
+      }
+      if (!done && !added)
+        KODI::TIME::Sleep(1ms);
+    }
+    for (auto& stream : streams)
+      stream->Drain(true);
+
+    const double cpu = GetCPUSeconds(cpuStart);
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::fixed << std::setprecision(2) << format.m_sampleRate << " Hz "
+              << format.m_channelLayout.Count() << "ch "
+              << CAEUtil::DataFormatToStr(format.m_dataFormat) << ", " << engines.size()
+              << " engine(s): " << 1000.0 * cpu / AUDIO_SECONDS << " ms cpu per second of audio, "
+              << wall.count() * CLOCK_SPEED / AUDIO_SECONDS << "x real time" << std::endl;
+
+    for (size_t i = 0; i < engines.size(); i++)
+    {
+      const CAESinkOffline::Stats stats = CAESinkOffline::GetStats(devices[i]);
+      EXPECT_GT(stats.frames, 0u);
+      EXPECT_TRUE(stats.hasSignal);
+
+      // measured in real time, scaled back to audio time of the device clock
+      const std::chrono::duration<double, std::milli> latency = stats.signalTime - signalTime[i];
+      std::cout << "  engine " << i << ": latency " << latency.count() * CLOCK_SPEED
+                << " ms (reported " << reportedDelay[i] * 1000.0 << " ms), " << stats.underruns
+                << " underruns, " << engines[i]->GetStageGrowth()
+                << " pool or queue growths in processing stages" << std::endl;
+    }
+    streams.clear();
+  }
+
+  void RunEngines(const AEAudioFormat& format, bool dual, bool oneThread)
+  {
+    m_settings->SetBool(CSettings::SETTING_AUDIOOUTPUT2_ENABLED, dual);
+
+    CActiveAE engine;
+    CActiveAE engine2(true);
+    if (dual && oneThread)
+      engine2.SetHostEngine(&engine);
+
+    CServiceBroker::RegisterAE(&engine, &engine2);
+    engine.Start();
+    engine2.Start();
+
+    std::vector<CActiveAE*> engines = {&engine};
+    if (dual)
+      engines.push_back(&engine2);
+    Play(engines, format);
+
+    engine.Shutdown();
+    engine2.Shutdown();
+    CServiceBroker::UnregisterAE();
+  }
+
+  std::shared_ptr<CSettings> m_settings;
+  std::string m_device;
+  std::string m_device2;
+  bool m_enabled2 = false;
+};
+
+TEST_F(TestActiveAEBenchmark, DISABLED_ResampleCost)
+{
+  const std::vector<ResampleChain> chains = {
+      {"44.1 kHz -> 48 kHz stereo", GetFormat(AE_FMT_S16NE, 44100, AE_CH_LAYOUT_2_0),
+       GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0)},
+      {"5.1 s16 -> float", GetFormat(AE_FMT_S16NE, 48000, AE_CH_LAYOUT_5_1),
+       GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_5_1)},
+      {"96 kHz -> 48 kHz 7.1", GetFormat(AE_FMT_FLOAT, 96000, AE_CH_LAYOUT_7_1),
+       GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_7_1)},
+      {"5.1 -> stereo downmix", GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_5_1),
+       GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0)},
+  };
+
+  for (const auto& chain : chains)
+  {
+    SCOPED_TRACE(chain.name);
+    CActiveAEBufferPool input(chain.input);
+    ASSERT_TRUE(input.Create(100));
+    CActiveAEBufferPoolResample resample(chain.input, chain.output, AE_QUALITY_MID);
+    ASSERT_TRUE(resample.Create(100, false, false));
+
+    const std::vector<uint8_t> tone = GetPeriod(chain.input, true);
+    const unsigned int periods = AUDIO_SECONDS * PERIODS_PER_SECOND;
+    unsigned int submitted = 0;
+    uint64_t frames = 0;
+
+    const uint64_t growth = CActiveAEBufferPool::GetGrowthCount();
+    const std::clock_t cpuStart = std::clock();
+    while (true)
+    {
+      if (submitted < periods && input.HasFreeBuffer())
+      {
+        CSampleBuffer* buffer = input.GetFreeBuffer();
+        std::memcpy(buffer->pkt->data[0], tone.data(), tone.size());
+        buffer->pkt->nb_samples = chain.input.m_frames;
+        resample.m_inputSamples.push_back(buffer);
+        submitted++;
+      }
+
+      const bool busy = resample.ResampleBuffers();
+      while (!resample.m_outputSamples.empty())
+      {
+        frames += resample.m_outputSamples.front()->pkt->nb_samples;
+        resample.m_outputSamples.front()->Return();
+        resample.m_outputSamples.pop_front();
+      }
+
+      if (!busy && submitted == periods)
+        break;
+    }
+    const double cpu = GetCPUSeconds(cpuStart);
+
+    // the resampler keeps a few frames for the next call
+    EXPECT_GE(frames, static_cast<uint64_t>(chain.output.m_sampleRate) * (AUDIO_SECONDS - 1));
+    std::cout << std::fixed << std::setprecision(3) << chain.name << ": "
+              << 1000.0 * cpu / AUDIO_SECONDS << " ms cpu per second of audio, "
+              << CActiveAEBufferPool::GetGrowthCount() - growth << " pool or queue growths"
+              << std::endl;
+  }
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_SingleEngine)
+{
+  RunEngines(GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0), false, false);
+  RunEngines(GetFormat(AE_FMT_S16NE, 44100, AE_CH_LAYOUT_2_0), false, false);
+  RunEngines(GetFormat(AE_FMT_S16NE, 48000, AE_CH_LAYOUT_5_1), false, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_DualEngine)
+{
+  RunEngines(GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0), true, false);
+  RunEngines(GetFormat(AE_FMT_S16NE, 48000, AE_CH_LAYOUT_5_1), true, false);
+}
+
+TEST_F(TestActiveAEBenchmark, DISABLED_DualEngineOneThread)
+{
+  RunEngines(GetFormat(AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_2_0), true, true);
+  RunEngines(GetFormat(AE_FMT_S16NE, 48000, AE_CH_LAYOUT_5_1), true, true);
+}
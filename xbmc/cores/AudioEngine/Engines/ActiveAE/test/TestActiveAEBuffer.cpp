@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+AEAudioFormat GetFormat(AEDataFormat dataFormat)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = CAEChannelInfo(AE_CH_LAYOUT_2_0);
+  format.m_frames = 1024;
+  format.m_frameSize = 2 * sizeof(float);
+  return format;
+}
+} // namespace
+
+TEST(TestActiveAEBuffer, PlanesAreAligned)
+{
+  CActiveAEBufferPool pool(GetFormat(AE_FMT_FLOATP));
+  ASSERT_TRUE(pool.Create(100));
+  ASSERT_GE(pool.m_allSamples.size(), 5u);
+  EXPECT_EQ(pool.GetFreeCount(), pool.m_allSamples.size());
+
+  for (auto* buffer : pool.m_allSamples)
+  {
+    ASSERT_EQ(buffer->pkt->planes, 2);
+    EXPECT_EQ(buffer->pkt->max_nb_samples, 1024);
+    for (int i = 0; i < buffer->pkt->planes; i++)
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->pkt->data[i]) % 16, 0u);
+  }
+}
+
+TEST(TestActiveAEBuffer, NoGrowthInSteadyState)
+{
+  CActiveAEBufferPool pool(GetFormat(AE_FMT_FLOAT));
+  ASSERT_TRUE(pool.Create(100));
+
+  CSampleQueue queue;
+  queue.reserve(pool.m_allSamples.size());
+
+  const uint64_t growth = CActiveAEBufferPool::GetGrowthCount();
+  for (int i = 0; i < 1000; i++)
+  {
+    while (pool.HasFreeBuffer())
+      queue.push_back(pool.GetFreeBuffer());
+    EXPECT_EQ(queue.size(), pool.m_allSamples.size());
+    while (!queue.empty())
+    {
+      queue.front()->Return();
+      queue.pop_front();
+    }
+  }
+  EXPECT_EQ(CActiveAEBufferPool::GetGrowthCount(), growth);
+  EXPECT_EQ(pool.GetFreeCount(), pool.m_allSamples.size());
+}
+
+TEST(TestActiveAEBuffer, SlabIsReused)
+{
+  auto pool = std::make_unique<CActiveAEBufferPool>(GetFormat(AE_FMT_FLOAT));
+  ASSERT_TRUE(pool->Create(100));
+  pool.reset();
+
+  // same size as before, the planes of the destroyed pool are picked up
+  const uint64_t growth = CActiveAEBufferPool::GetGrowthCount();
+  pool = std::make_unique<CActiveAEBufferPool>(GetFormat(AE_FMT_FLOAT));
+  ASSERT_TRUE(pool->Create(100));
+  EXPECT_EQ(CActiveAEBufferPool::GetGrowthCount(), growth);
+}
+
+TEST(TestActiveAEBuffer, QueueKeepsOrderWhileGrowing)
+{
+  std::vector<CSampleBuffer> buffers(100);
+  CSampleQueue queue;
+
+  // wrap around before growing
+  for (int i = 0; i < 10; i++)
+    queue.push_back(&buffers[0]);
+  for (int i = 0; i < 10; i++)
+    queue.pop_front();
+
+  for (auto& buffer : buffers)
+    queue.push_back(&buffer);
+  ASSERT_EQ(queue.size(), buffers.size());
+
+  size_t i = 0;
+  for (auto* buffer : queue)
+    EXPECT_EQ(buffer, &buffers[i++]);
+
+  for (auto& buffer : buffers)
+  {
+    EXPECT_EQ(queue.front(), &buffer);
+    queue.pop_front();
+  }
+  EXPECT_TRUE(queue.empty());
+}
@@ -235,6 +235,7 @@ public:
 
   /**
    * Sets the resamplling on/ff
+   * @param mode 0: off, 1: resample to the clock, 2: ratio is controlled by the caller via SetResampleRatio
    */
   virtual void SetResampleMode(int mode) = 0;
 
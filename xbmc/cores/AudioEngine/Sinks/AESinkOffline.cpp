@@ -0,0 +1,229 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkOffline.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "threads/CriticalSection.h"
+#include "utils/XTimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace
+{
+// 10 ms periods, 4 of them are buffered by the simulated device
+constexpr unsigned int PERIODS_PER_SECOND = 100;
+constexpr unsigned int BUFFER_PERIODS = 4;
+
+// everything below counts as silence, -96 dB
+constexpr float SIGNAL_THRESHOLD = 1.6e-5f;
+
+CCriticalSection statsLock;
+std::map<std::string, CAESinkOffline::Stats> deviceStats;
+double clockSpeed = 1.0;
+
+bool IsNullDevice(const std::string& device)
+{
+  return device.empty() || device == "null" || device == "null2";
+}
+} // namespace
+
+CAESinkOffline::~CAESinkOffline()
+{
+  Deinitialize();
+}
+
+void CAESinkOffline::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "OFFLINE";
+  entry.createFunc = CAESinkOffline::Create;
+  entry.enumerateFunc = CAESinkOffline::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkOffline::Create(std::string& device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkOffline();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkOffline::EnumerateDevicesEx(AEDeviceInfoList& list, bool force)
+{
+  // two devices, so that both engines can be opened at the same time
+  for (const char* name : {"null", "null2"})
+  {
+    CAEDeviceInfo info;
+    info.m_deviceName = name;
+    info.m_displayName = std::string("Offline ") + name;
+    info.m_deviceType = AE_DEVTYPE_PCM;
+    info.m_channels = CAEChannelInfo(AE_CH_LAYOUT_7_1);
+    info.m_sampleRates = {44100, 48000, 88200, 96000, 176400, 192000};
+    info.m_dataFormats.push_back(AE_FMT_FLOAT);
+    info.m_wantsIECPassthrough = false;
+    list.push_back(info);
+  }
+}
+
+void CAESinkOffline::SetSpeed(double speed)
+{
+  std::unique_lock<CCriticalSection> lock(statsLock);
+  clockSpeed = speed;
+}
+
+CAESinkOffline::Stats CAESinkOffline::GetStats(const std::string& device)
+{
+  std::unique_lock<CCriticalSection> lock(statsLock);
+  auto it = deviceStats.find(device);
+  if (it == deviceStats.end())
+    return Stats();
+  return it->second;
+}
+
+void CAESinkOffline::ResetStats()
+{
+  std::unique_lock<CCriticalSection> lock(statsLock);
+  deviceStats.clear();
+}
+
+bool CAESinkOffline::Initialize(AEAudioFormat& format, std::string& device)
+{
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    CLog::Log(LOGERROR, "CAESinkOffline::{} - passthrough is not supported", __FUNCTION__);
+    return false;
+  }
+
+  if (!IsNullDevice(device))
+  {
+    if (!m_file.OpenForWrite(device, true))
+    {
+      CLog::Log(LOGERROR, "CAESinkOffline::{} - failed to open {}", __FUNCTION__, device);
+      return false;
+    }
+    m_fileOpen = true;
+  }
+
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_frames = format.m_sampleRate / PERIODS_PER_SECOND;
+  format.m_frameSize = format.m_channelLayout.Count() * sizeof(float);
+
+  m_format = format;
+  m_device = device;
+  m_bufferFrames = format.m_frames * BUFFER_PERIODS;
+  m_written = m_played = m_clockBase = 0;
+  m_clockStart = std::chrono::steady_clock::now();
+
+  std::unique_lock<CCriticalSection> lock(statsLock);
+  m_speed = clockSpeed;
+
+  CLog::Log(LOGINFO, "CAESinkOffline::{} - device: {}, rate: {}, channels: {}, speed: {:.1f}",
+            __FUNCTION__, m_device, m_format.m_sampleRate, m_format.m_channelLayout.Count(),
+            m_speed);
+  return true;
+}
+
+void CAESinkOffline::Deinitialize()
+{
+  if (m_fileOpen)
+  {
+    m_file.Close();
+    m_fileOpen = false;
+  }
+}
+
+void CAESinkOffline::UpdateClock()
+{
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed = now - m_clockStart;
+  const uint64_t played =
+      m_clockBase + static_cast<uint64_t>(elapsed.count() * m_format.m_sampleRate * m_speed);
+
+  if (played < m_written)
+  {
+    m_played = played;
+    return;
+  }
+
+  // the device ran dry, its clock restarts with the next period
+  if (m_played < m_written)
+  {
+    std::unique_lock<CCriticalSection> lock(statsLock);
+    deviceStats[m_device].underruns++;
+  }
+  m_played = m_clockBase = m_written;
+  m_clockStart = now;
+}
+
+void CAESinkOffline::GetDelay(AEDelayStatus& status)
+{
+  UpdateClock();
+  status.SetDelay(static_cast<double>(m_written - m_played) / m_format.m_sampleRate);
+}
+
+double CAESinkOffline::GetCacheTotal()
+{
+  return static_cast<double>(m_bufferFrames) / m_format.m_sampleRate;
+}
+
+bool CAESinkOffline::HasSignal(const uint8_t* data, unsigned int frames) const
+{
+  const float* samples = reinterpret_cast<const float*>(data);
+  const unsigned int count = frames * m_format.m_channelLayout.Count();
+  return std::any_of(samples, samples + count,
+                     [](float sample) { return std::fabs(sample) > SIGNAL_THRESHOLD; });
+}
+
+unsigned int CAESinkOffline::AddPackets(uint8_t** data, unsigned int frames, unsigned int offset)
+{
+  // block until the simulated device has room for the whole packet
+  frames = std::min(frames, m_bufferFrames);
+  UpdateClock();
+  while (m_written - m_played + frames > m_bufferFrames)
+  {
+    const uint64_t missing = m_written - m_played + frames - m_bufferFrames;
+    KODI::TIME::Sleep(std::chrono::microseconds(
+        static_cast<int64_t>(missing * 1000000 / (m_format.m_sampleRate * m_speed)) + 1));
+    UpdateClock();
+  }
+
+  const uint8_t* buffer = data[0] + offset * m_format.m_frameSize;
+  if (m_fileOpen)
+    m_file.Write(buffer, frames * m_format.m_frameSize);
+
+  const bool signal = HasSignal(buffer, frames);
+  m_written += frames;
+
+  std::unique_lock<CCriticalSection> lock(statsLock);
+  Stats& stats = deviceStats[m_device];
+  stats.frames += frames;
+  if (signal && !stats.hasSignal)
+  {
+    stats.hasSignal = true;
+    stats.signalTime = std::chrono::steady_clock::now();
+  }
+  return frames;
+}
+
+void CAESinkOffline::Drain()
+{
+  UpdateClock();
+  const uint64_t pending = m_written - m_played;
+  KODI::TIME::Sleep(std::chrono::microseconds(
+      static_cast<int64_t>(pending * 1000000 / (m_format.m_sampleRate * m_speed))));
+  m_played = m_clockBase = m_written;
+  m_clockStart = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "filesystem/File.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Sink without audio hardware, used to benchmark the engine
+ *
+ * The sink consumes samples at the pace of a simulated device clock that
+ * runs at a configurable multiple of real time. Device "null" and "null2"
+ * discard the samples, any other device name is taken as a file the raw
+ * samples are written to.
+ */
+class CAESinkOffline : public IAESink
+{
+public:
+  struct Stats
+  {
+    uint64_t frames = 0; // frames consumed by the simulated device
+    unsigned int underruns = 0;
+    bool hasSignal = false; // at least one non-silent frame was consumed
+    std::chrono::steady_clock::time_point signalTime; // arrival of the first non-silent frame
+  };
+
+  const char* GetName() override { return "OFFLINE"; }
+
+  CAESinkOffline() = default;
+  ~CAESinkOffline() override;
+
+  static void Register();
+  static IAESink* Create(std::string& device, AEAudioFormat& desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList& list, bool force = false);
+
+  /*!
+   * \brief Set the speed of the simulated clock, 1.0 is real time
+   */
+  static void SetSpeed(double speed);
+
+  /*!
+   * \brief Statistics of all sinks opened for device since the last ResetStats()
+   */
+  static Stats GetStats(const std::string& device);
+  static void ResetStats();
+
+  bool Initialize(AEAudioFormat& format, std::string& device) override;
+  void Deinitialize() override;
+
+  void GetDelay(AEDelayStatus& status) override;
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t** data, unsigned int frames, unsigned int offset) override;
+  void Drain() override;
+
+private:
+  void UpdateClock();
+  bool HasSignal(const uint8_t* data, unsigned int frames) const;
+
+  AEAudioFormat m_format;
+  std::string m_device;
+  XFILE::CFile m_file;
+  bool m_fileOpen = false;
+  double m_speed = 1.0;
+  unsigned int m_bufferFrames = 0;
+  uint64_t m_written = 0;
+  uint64_t m_played = 0;
+  uint64_t m_clockBase = 0;
+  std::chrono::steady_clock::time_point m_clockStart;
+};
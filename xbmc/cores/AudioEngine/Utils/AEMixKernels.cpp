@@ -0,0 +1,341 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEMixKernels.h"
+
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AE_MIX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AE_TARGET(x)
+#else
+#define AE_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
+#if defined(HAS_NEON) && (defined(__arm__) || defined(__aarch64__))
+#define AE_MIX_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+// the soft clamp reaches +-1.0 at +-3.0, inputs are limited to that range
+constexpr float CLAMP_LIMIT = 3.0f;
+
+inline float SoftClamp(float x)
+{
+  if (x < -CLAMP_LIMIT)
+    return -1.0f;
+  else if (x > CLAMP_LIMIT)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+//------------------------------------------------------------------------------
+// scalar reference
+//------------------------------------------------------------------------------
+
+void MulArrayC(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+bool MulAddArrayC(float* data, const float* add, float mul, uint32_t count)
+{
+  bool clip = false;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    data[i] += add[i] * mul;
+    if (std::fabs(data[i]) > 1.0f)
+      clip = true;
+  }
+  return clip;
+}
+
+void ClampArrayC(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] = SoftClamp(data[i]);
+}
+
+const AEMixKernels kernelsC = {"C", MulArrayC, MulAddArrayC, ClampArrayC};
+
+#if defined(AE_MIX_X86)
+//------------------------------------------------------------------------------
+// SSE, baseline of all x86 cpus supported
+//------------------------------------------------------------------------------
+
+AE_TARGET("sse") void MulArraySSE(float* data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  for (; i < count; i++)
+    data[i] *= mul;
+}
+
+AE_TARGET("sse") bool MulAddArraySSE(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 peak = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 out = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, out);
+    peak = _mm_max_ps(peak, _mm_andnot_ps(sign, out));
+  }
+  bool clip = _mm_movemask_ps(_mm_cmpgt_ps(peak, _mm_set1_ps(1.0f))) != 0;
+  return MulAddArrayC(data + i, add + i, mul, count - i) || clip;
+}
+
+AE_TARGET("sse") void ClampArraySSE(float* data, uint32_t count)
+{
+  const __m128 lo = _mm_set1_ps(-CLAMP_LIMIT);
+  const __m128 hi = _mm_set1_ps(CLAMP_LIMIT);
+  const __m128 c1 = _mm_set1_ps(27.0f);
+  const __m128 c2 = _mm_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 num = _mm_mul_ps(x, _mm_add_ps(c1, y));
+    __m128 den = _mm_add_ps(c1, _mm_mul_ps(c2, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(num, den));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsSSE = {"SSE", MulArraySSE, MulAddArraySSE, ClampArraySSE};
+
+//------------------------------------------------------------------------------
+// AVX2 + FMA
+//------------------------------------------------------------------------------
+
+AE_TARGET("avx2,fma") void MulArrayAVX2(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  _mm256_zeroupper();
+  MulArrayC(data + i, mul, count - i);
+}
+
+AE_TARGET("avx2,fma") bool MulAddArrayAVX2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 peak = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 out = _mm256_fmadd_ps(_mm256_loadu_ps(add + i), m, _mm256_loadu_ps(data + i));
+    _mm256_storeu_ps(data + i, out);
+    peak = _mm256_max_ps(peak, _mm256_andnot_ps(sign, out));
+  }
+  bool clip = _mm256_movemask_ps(_mm256_cmp_ps(peak, _mm256_set1_ps(1.0f), _CMP_GT_OQ)) != 0;
+  _mm256_zeroupper();
+  return MulAddArrayC(data + i, add + i, mul, count - i) || clip;
+}
+
+AE_TARGET("avx2,fma") void ClampArrayAVX2(float* data, uint32_t count)
+{
+  const __m256 lo = _mm256_set1_ps(-CLAMP_LIMIT);
+  const __m256 hi = _mm256_set1_ps(CLAMP_LIMIT);
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c1, y));
+    __m256 den = _mm256_fmadd_ps(c2, y, c1);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(num, den));
+  }
+  _mm256_zeroupper();
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsAVX2 = {"AVX2", MulArrayAVX2, MulAddArrayAVX2, ClampArrayAVX2};
+
+//------------------------------------------------------------------------------
+// AVX-512F, tails are handled with masked loads and stores
+//------------------------------------------------------------------------------
+
+AE_TARGET("avx512f") void MulArrayAVX512(float* data, float mul, uint32_t count)
+{
+  const __m512 m = _mm512_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+    _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), m));
+  if (i < count)
+  {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+    __m512 x = _mm512_maskz_loadu_ps(mask, data + i);
+    _mm512_mask_storeu_ps(data + i, mask, _mm512_mul_ps(x, m));
+  }
+  _mm256_zeroupper();
+}
+
+AE_TARGET("avx512f") bool MulAddArrayAVX512(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m512 m = _mm512_set1_ps(mul);
+  __m512 peak = _mm512_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m512 out = _mm512_fmadd_ps(_mm512_loadu_ps(add + i), m, _mm512_loadu_ps(data + i));
+    _mm512_storeu_ps(data + i, out);
+    peak = _mm512_max_ps(peak, _mm512_abs_ps(out));
+  }
+  if (i < count)
+  {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+    __m512 out = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, add + i), m,
+                                 _mm512_maskz_loadu_ps(mask, data + i));
+    _mm512_mask_storeu_ps(data + i, mask, out);
+    peak = _mm512_max_ps(peak, _mm512_abs_ps(out));
+  }
+  bool clip = _mm512_cmp_ps_mask(peak, _mm512_set1_ps(1.0f), _CMP_GT_OQ) != 0;
+  _mm256_zeroupper();
+  return clip;
+}
+
+AE_TARGET("avx512f") inline __m512 SoftClampAVX512(__m512 x)
+{
+  const __m512 c1 = _mm512_set1_ps(27.0f);
+  x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-CLAMP_LIMIT)), _mm512_set1_ps(CLAMP_LIMIT));
+  __m512 y = _mm512_mul_ps(x, x);
+  __m512 num = _mm512_mul_ps(x, _mm512_add_ps(c1, y));
+  __m512 den = _mm512_fmadd_ps(_mm512_set1_ps(9.0f), y, c1);
+  return _mm512_div_ps(num, den);
+}
+
+AE_TARGET("avx512f") void ClampArrayAVX512(float* data, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+    _mm512_storeu_ps(data + i, SoftClampAVX512(_mm512_loadu_ps(data + i)));
+  if (i < count)
+  {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+    __m512 x = _mm512_maskz_loadu_ps(mask, data + i);
+    _mm512_mask_storeu_ps(data + i, mask, SoftClampAVX512(x));
+  }
+  _mm256_zeroupper();
+}
+
+const AEMixKernels kernelsAVX512 = {"AVX-512", MulArrayAVX512, MulAddArrayAVX512,
+                                    ClampArrayAVX512};
+#endif
+
+#if defined(AE_MIX_NEON)
+//------------------------------------------------------------------------------
+// NEON
+//------------------------------------------------------------------------------
+
+inline float32x4_t DivNEON(float32x4_t num, float32x4_t den)
+{
+#if defined(__aarch64__)
+  return vdivq_f32(num, den);
+#else
+  // reciprocal estimate plus two newton-raphson steps
+  float32x4_t r = vrecpeq_f32(den);
+  r = vmulq_f32(vrecpsq_f32(den, r), r);
+  r = vmulq_f32(vrecpsq_f32(den, r), r);
+  return vmulq_f32(num, r);
+#endif
+}
+
+void MulArrayNEON(float* data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulArrayC(data + i, mul, count - i);
+}
+
+bool MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t out = vmlaq_n_f32(vld1q_f32(data + i), vld1q_f32(add + i), mul);
+    vst1q_f32(data + i, out);
+    peak = vmaxq_f32(peak, vabsq_f32(out));
+  }
+  uint32x4_t over = vcgtq_f32(peak, vdupq_n_f32(1.0f));
+  uint32x2_t over2 = vorr_u32(vget_low_u32(over), vget_high_u32(over));
+  bool clip = (vget_lane_u32(over2, 0) | vget_lane_u32(over2, 1)) != 0;
+  return MulAddArrayC(data + i, add + i, mul, count - i) || clip;
+}
+
+void ClampArrayNEON(float* data, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-CLAMP_LIMIT);
+  const float32x4_t hi = vdupq_n_f32(CLAMP_LIMIT);
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t num = vmulq_f32(x, vaddq_f32(c1, y));
+    float32x4_t den = vmlaq_n_f32(c1, y, 9.0f);
+    vst1q_f32(data + i, DivNEON(num, den));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsNEON = {"NEON", MulArrayNEON, MulAddArrayNEON, ClampArrayNEON};
+#endif
+} // namespace
+
+const AEMixKernels& AEMixKernels::GetReference()
+{
+  return kernelsC;
+}
+
+std::vector<const AEMixKernels*> AEMixKernels::GetSupported(unsigned int cpuFeatures)
+{
+  std::vector<const AEMixKernels*> kernels{&kernelsC};
+#if defined(AE_MIX_X86)
+  if (cpuFeatures & CPU_FEATURE_SSE)
+    kernels.push_back(&kernelsSSE);
+  if (cpuFeatures & CPU_FEATURE_AVX2)
+    kernels.push_back(&kernelsAVX2);
+  if (cpuFeatures & CPU_FEATURE_AVX512)
+    kernels.push_back(&kernelsAVX512);
+#endif
+#if defined(AE_MIX_NEON)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+    kernels.push_back(&kernelsNEON);
+#endif
+  return kernels;
+}
+
+const AEMixKernels& AEMixKernels::Get()
+{
+  static const AEMixKernels* kernels =
+      GetSupported(CCPUInfo::GetCPUInfo()->GetCPUFeatures()).back();
+  return *kernels;
+}
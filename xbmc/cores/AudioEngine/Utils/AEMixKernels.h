@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief Float kernels of the mix, volume and clamp path of ActiveAE
+ *
+ * There is one set per instruction set, Get() returns the best one the
+ * cpu supports. The scalar set is the reference for all others.
+ */
+struct AEMixKernels
+{
+  const char* name;
+
+  //! data *= mul
+  void (*MulArray)(float* data, float mul, uint32_t count);
+
+  /*!
+   * data += add * mul, fused with the clip check of the final mix
+   * \return true if at least one result is outside [-1.0, 1.0]
+   */
+  bool (*MulAddArray)(float* data, const float* add, float mul, uint32_t count);
+
+  //! soft clamp data to [-1.0, 1.0], see CAEUtil::SoftClamp
+  void (*ClampArray)(float* data, uint32_t count);
+
+  /*!
+   * \brief Kernels for this cpu, selected on first use
+   */
+  static const AEMixKernels& Get();
+
+  static const AEMixKernels& GetReference();
+
+  /*!
+   * \brief All kernel sets that can run with the given CpuFeature flags,
+   * reference first and best last
+   */
+  static std::vector<const AEMixKernels*> GetSupported(unsigned int cpuFeatures);
+};
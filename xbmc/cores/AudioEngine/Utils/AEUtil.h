@@ -160,10 +160,12 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief mix, volume and clamp kernels, dispatched to the best
+   instruction set of the cpu, see AEMixKernels
+   */
+  static void MulArray(float *data, const float mul, uint32_t count);
+  /*! \return true if a mixed sample is outside [-1.0, 1.0] and needs clamping */
+  static bool MulAddArray(float *data, const float *add, const float mul, uint32_t count);
   static void ClampArray(float *data, uint32_t count);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int SAMPLE_RATE = 192000;
+// 10 ms period plus 3 frames, so every kernel runs into its tail handling
+constexpr uint32_t FRAMES = SAMPLE_RATE / 100 + 3;
+constexpr float TOLERANCE = 1e-5f;
+
+std::vector<float> GetSamples(uint32_t count, float range, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count);
+  for (auto& sample : samples)
+    sample = dist(gen);
+  return samples;
+}
+
+std::vector<const AEMixKernels*> GetKernels()
+{
+  return AEMixKernels::GetSupported(CCPUInfo::GetCPUInfo()->GetCPUFeatures());
+}
+} // namespace
+
+class TestAEMixKernels : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(TestAEMixKernels, MatchesReference)
+{
+  const uint32_t count = FRAMES * GetParam();
+  const AEMixKernels& ref = AEMixKernels::GetReference();
+  const std::vector<float> src = GetSamples(count, 0.7f, 1);
+  const std::vector<float> dst = GetSamples(count, 0.7f, 2);
+
+  for (const auto* kernels : GetKernels())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    // volume
+    std::vector<float> expected(dst);
+    std::vector<float> result(dst);
+    ref.MulArray(expected.data(), 0.5f, count);
+    kernels->MulArray(result.data(), 0.5f, count);
+    for (uint32_t i = 0; i < count; i++)
+      ASSERT_NEAR(result[i], expected[i], TOLERANCE);
+
+    // mix, with and without clipping
+    for (float volume : {0.4f, 1.0f})
+    {
+      expected = dst;
+      result = dst;
+      bool expectedClip = ref.MulAddArray(expected.data(), src.data(), volume, count);
+      bool clip = kernels->MulAddArray(result.data(), src.data(), volume, count);
+      EXPECT_EQ(clip, expectedClip);
+      for (uint32_t i = 0; i < count; i++)
+        ASSERT_NEAR(result[i], expected[i], TOLERANCE);
+
+      // clamp
+      ref.ClampArray(expected.data(), count);
+      kernels->ClampArray(result.data(), count);
+      for (uint32_t i = 0; i < count; i++)
+      {
+        ASSERT_NEAR(result[i], expected[i], TOLERANCE);
+        ASSERT_LE(std::fabs(result[i]), 1.0f);
+      }
+    }
+  }
+}
+
+TEST_P(TestAEMixKernels, ClipDetectedInTail)
+{
+  const uint32_t count = FRAMES * GetParam();
+  const std::vector<float> src(count, 0.0f);
+
+  for (const auto* kernels : GetKernels())
+  {
+    SCOPED_TRACE(kernels->name);
+    std::vector<float> dst(count, 0.5f);
+    EXPECT_FALSE(kernels->MulAddArray(dst.data(), src.data(), 1.0f, count));
+    dst[count - 1] = -1.5f;
+    EXPECT_TRUE(kernels->MulAddArray(dst.data(), src.data(), 1.0f, count));
+  }
+}
+
+// timings only, run it with --gtest_also_run_disabled_tests
+TEST_P(TestAEMixKernels, DISABLED_Benchmark)
+{
+  // one second of audio, mixed from two streams, volume and clamp
+  const uint32_t count = FRAMES * GetParam();
+  const std::vector<float> src = GetSamples(count, 1.0f, 3);
+  std::vector<float> dst = GetSamples(count, 1.0f, 4);
+
+  for (const auto* kernels : GetKernels())
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int period = 0; period < 100; period++)
+    {
+      kernels->MulArray(dst.data(), 0.9f, count);
+      if (kernels->MulAddArray(dst.data(), src.data(), 0.9f, count))
+        kernels->ClampArray(dst.data(), count);
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << GetParam() << "ch " << kernels->name << ": " << duration.count() << " us"
+              << std::endl;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Channels, TestAEMixKernels, ::testing::Values(2, 6, 8));
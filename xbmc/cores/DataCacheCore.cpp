@@ -48,6 +48,12 @@ void CDataCacheCore::Reset()
 
     m_contentInfo.Reset();
   }
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_demuxSection);
+
+    m_demuxPrefetchInfo = SDemuxPrefetchInfo();
+  }
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -316,6 +322,43 @@ int CDataCacheCore::GetAudioBitsPerSample(bool bAudio2)
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::AddAudioDriftSample(const SAudioDriftSample& sample)
+{
+  std::unique_lock<CCriticalSection> lock(m_audio2PlayerSection);
+
+  m_audioDriftHistory.push_back(sample);
+  if (m_audioDriftHistory.size() > MAX_AUDIO_DRIFT_SAMPLES)
+    m_audioDriftHistory.pop_front();
+}
+
+std::vector<SAudioDriftSample> CDataCacheCore::GetAudioDriftHistory()
+{
+  std::unique_lock<CCriticalSection> lock(m_audio2PlayerSection);
+
+  return {m_audioDriftHistory.begin(), m_audioDriftHistory.end()};
+}
+
+void CDataCacheCore::ResetAudioDriftHistory()
+{
+  std::unique_lock<CCriticalSection> lock(m_audio2PlayerSection);
+
+  m_audioDriftHistory.clear();
+}
+
+void CDataCacheCore::SetDemuxPrefetchInfo(const SDemuxPrefetchInfo& info)
+{
+  std::unique_lock<CCriticalSection> lock(m_demuxSection);
+
+  m_demuxPrefetchInfo = info;
+}
+
+SDemuxPrefetchInfo CDataCacheCore::GetDemuxPrefetchInfo()
+{
+  std::unique_lock<CCriticalSection> lock(m_demuxSection);
+
+  return m_demuxPrefetchInfo;
+}
+
 void CDataCacheCore::SetEditList(const std::vector<EDL::Edit>& editList)
 {
   std::unique_lock<CCriticalSection> lock(m_contentSection);
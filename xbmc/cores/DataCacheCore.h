@@ -13,9 +13,28 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
+struct SAudioDriftSample
+{
+  double error; // ms between the 2nd and the 1st audio output
+  double ratio; // resample ratio of the 2nd output
+  double correction; // part of the ratio applied by the drift control
+};
+
+struct SDemuxPrefetchInfo
+{
+  bool active = false; // packets are read ahead on the demux thread
+  int level = 0; // fill level of the read-ahead buffer in percent
+  unsigned int packets = 0;
+  int bytes = 0;
+  uint64_t underruns = 0; // the player found nothing read ahead
+  uint64_t busy = 0; // the player found the demuxer in a read
+};
+
 class CDataCacheCore
 {
 public:
@@ -68,6 +87,25 @@ public:
   void SetAudioBitsPerSample(int bitsPerSample, bool bAudio2 = false);
   int GetAudioBitsPerSample(bool bAudio2 = false);
 
+  /*!
+   * @brief Append a sample of the drift control between the two audio outputs
+   * @param sample the error, ratio and correction of the last update
+   */
+  void AddAudioDriftSample(const SAudioDriftSample& sample);
+
+  /*!
+   * @brief Get the recent history of the drift control, oldest sample first
+   * @return up to MAX_AUDIO_DRIFT_SAMPLES samples
+   */
+  std::vector<SAudioDriftSample> GetAudioDriftHistory();
+  void ResetAudioDriftHistory();
+
+  static constexpr size_t MAX_AUDIO_DRIFT_SAMPLES = 600;
+
+  // demux info
+  void SetDemuxPrefetchInfo(const SDemuxPrefetchInfo& info);
+  SDemuxPrefetchInfo GetDemuxPrefetchInfo();
+
   // content info
 
   /*!
@@ -221,6 +259,10 @@ protected:
     int sampleRate;
     int bitsPerSample;
   } m_playerAudioInfo, m_playerAudio2Info;
+  std::deque<SAudioDriftSample> m_audioDriftHistory;
+
+  CCriticalSection m_demuxSection;
+  SDemuxPrefetchInfo m_demuxPrefetchInfo;
 
   mutable CCriticalSection m_contentSection;
   struct SContentInfo
@@ -26,6 +26,7 @@ struct TextCacheStruct_t;
 class TiXmlElement;
 class CStreamDetails;
 class CAction;
+class CVariant;
 class IPlayerCallback;
 
 class CPlayerOptions
@@ -256,6 +257,7 @@ public:
   {
     return false;
   }
+  virtual bool GetRenderTrace(CVariant& trace) const { return false; }
 
   // video and audio settings
   virtual CVideoSettings GetVideoSettings() const { return CVideoSettings(); }
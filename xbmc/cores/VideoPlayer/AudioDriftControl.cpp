@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AudioDriftControl.h"
+
+#include <algorithm>
+#include <cmath>
+
+void CAudioDriftControl::Reset()
+{
+  m_errorTime = 0;
+  m_integral = 0.0;
+  m_error = 0.0;
+  m_correction = 0.0;
+  m_ratio = 1.0;
+}
+
+bool CAudioDriftControl::Update(const CAESyncInfo& info1, const CAESyncInfo& info2)
+{
+  // the engines reset the ratio while they skip or pad, start over once both are in sync
+  if (info1.state != CAESyncInfo::SYNC_INSYNC || info2.state != CAESyncInfo::SYNC_INSYNC)
+  {
+    m_errorTime = 0;
+    m_integral = 0.0;
+    return false;
+  }
+
+  if (info2.errortime == m_errorTime)
+    return false;
+  m_errorTime = info2.errortime;
+
+  // errors are in ms, positive if the stream plays ahead of the clock
+  m_error = info2.error - info1.error;
+
+  //reset the integral on big errors, the engine resyncs those by itself
+  if (std::fabs(m_error) > 1000)
+    m_integral = 0.0;
+  else if (std::fabs(m_error) > 1)
+    m_integral += m_error / 1000 / 50;
+
+  m_integral = std::clamp(m_integral, -MAX_CORRECTION, MAX_CORRECTION);
+
+  double proportional = m_error / 1000 / 2;
+
+  m_correction = std::clamp(proportional + m_integral, -MAX_CORRECTION, MAX_CORRECTION);
+
+  // follow the ratio of the 1st stream, it is 1.0 unless that one resamples to the clock
+  double base = info1.rr > 0.0 ? info1.rr : 1.0;
+  m_ratio = base + m_correction;
+
+  return true;
+}
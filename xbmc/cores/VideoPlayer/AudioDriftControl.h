@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+
+/*!
+ * \brief PI controller that keeps the 2nd audio output locked to the 1st one.
+ *
+ * Both engines report their sync error against the player clock. The
+ * difference of the two is the drift between the outputs, which is corrected
+ * by steering the resample ratio of the 2nd stream around the ratio the 1st
+ * stream currently runs at.
+ */
+class CAudioDriftControl
+{
+public:
+  CAudioDriftControl() = default;
+
+  void Reset();
+
+  /*!
+   * \brief Feed the latest sync info of both streams
+   * \return true if a new ratio for the 2nd stream was calculated
+   */
+  bool Update(const CAESyncInfo& info1, const CAESyncInfo& info2);
+
+  double GetRatio() const { return m_ratio; }
+  double GetError() const { return m_error; }
+  double GetCorrection() const { return m_correction; }
+
+  static constexpr double MAX_CORRECTION = 0.01;
+
+private:
+  unsigned int m_errorTime = 0;
+  double m_integral = 0.0;
+  double m_error = 0.0;
+  double m_correction = 0.0;
+  double m_ratio = 1.0;
+};
@@ -80,6 +80,7 @@ void CAudioSinkAE::Destroy(bool finish)
   }
 
   m_pAudioStream = NULL;
+  m_syncInfo = {};
   m_sampleRate = 0;
   m_iBitsPerSample = 0;
   m_bPassthrough = false;
@@ -97,6 +98,7 @@ unsigned int CAudioSinkAE::AddPackets(const DVDAudioFrame &audioframe)
     return 0;
 
   CAESyncInfo info = m_pAudioStream->GetSyncInfo();
+  m_syncInfo = info;
   if (info.state == CAESyncInfo::SYNC_INSYNC)
   {
     unsigned int newTime = info.errortime;
@@ -316,6 +318,21 @@ void CAudioSinkAE::SetResampleMode(int mode)
   }
 }
 
+void CAudioSinkAE::SetResampleRatio(double ratio)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (m_pAudioStream)
+  {
+    m_pAudioStream->SetResampleRatio(ratio);
+  }
+}
+
+CAESyncInfo CAudioSinkAE::GetSyncInfo()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  return m_syncInfo;
+}
+
 double CAudioSinkAE::GetClock()
 {
   if (m_pClock)
@@ -54,6 +54,13 @@ public:
   double GetResampleRatio();
 
   void SetResampleMode(int mode);
+  void SetResampleRatio(double ratio);
+
+  /*!
+   * \brief Returns the sync info of the stream as of the last call to AddPackets
+   */
+  CAESyncInfo GetSyncInfo();
+
   void Flush();
   void Drain();
   void AbortAddPackets();
@@ -70,6 +77,7 @@ protected:
   double m_syncError;
   unsigned int m_syncErrorTime;
   double m_resampleRatio = 0.0; // invalid
+  CAESyncInfo m_syncInfo = {};
   CCriticalSection m_critSection;
 
   AEDataFormat m_dataFormat;
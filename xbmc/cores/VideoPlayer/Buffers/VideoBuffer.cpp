@@ -8,10 +8,156 @@
 
 #include "VideoBuffer.h"
 
+#include "utils/MemUtils.h"
+
 #include <mutex>
 #include <string.h>
 #include <utility>
 
+#if defined(TARGET_LINUX)
+#include <sys/mman.h>
+#endif
+
+extern "C" {
+#include <libavutil/buffer.h>
+}
+
+namespace
+{
+void FreeAVBuffer(void* opaque, uint8_t* data)
+{
+  auto* memory = static_cast<std::shared_ptr<CVideoBufferMemory>*>(opaque);
+  (*memory)->Release(data);
+  delete memory;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+// CVideoBufferMemory
+//-----------------------------------------------------------------------------
+
+std::shared_ptr<CVideoBufferMemory> CVideoBufferMemory::GetInstance()
+{
+  static CCriticalSection section;
+  static std::weak_ptr<CVideoBufferMemory> instance;
+
+  std::unique_lock<CCriticalSection> lock(section);
+  std::shared_ptr<CVideoBufferMemory> memory = instance.lock();
+  if (!memory)
+  {
+    memory = std::shared_ptr<CVideoBufferMemory>(new CVideoBufferMemory());
+    instance = memory;
+  }
+  return memory;
+}
+
+CVideoBufferMemory::~CVideoBufferMemory()
+{
+  for (auto& bucket : m_free)
+  {
+    for (uint8_t* data : bucket.second)
+      FreeBlock(data);
+  }
+}
+
+size_t CVideoBufferMemory::GetBlockSize(size_t size)
+{
+  if (size <= MIN_BLOCK_SIZE)
+    return MIN_BLOCK_SIZE;
+
+  // four buckets per power of two, at most a quarter of a block is unused
+  size_t base = MIN_BLOCK_SIZE;
+  while (base * 2 < size)
+    base *= 2;
+  const size_t step = base / 4;
+  return (size + step - 1) / step * step;
+}
+
+uint8_t* CVideoBufferMemory::AllocateBlock(size_t blockSize)
+{
+  // the size is kept in front of the block
+  const size_t alignTo = blockSize >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : ALIGNMENT;
+  auto* base = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(blockSize + ALIGNMENT, alignTo));
+  if (!base)
+    return nullptr;
+
+#if defined(TARGET_LINUX) && defined(MADV_HUGEPAGE)
+  if (blockSize >= HUGE_PAGE_SIZE)
+    madvise(base, (blockSize + ALIGNMENT) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#endif
+
+  *reinterpret_cast<size_t*>(base) = blockSize;
+  return base + ALIGNMENT;
+}
+
+void CVideoBufferMemory::FreeBlock(uint8_t* data)
+{
+  KODI::MEMORY::AlignedFree(data - ALIGNMENT);
+}
+
+uint8_t* CVideoBufferMemory::Allocate(size_t size)
+{
+  const size_t blockSize = GetBlockSize(size);
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_stats.requests++;
+
+    auto it = m_free.find(blockSize);
+    if (it != m_free.end() && !it->second.empty())
+    {
+      uint8_t* data = it->second.back();
+      it->second.pop_back();
+      m_stats.hits++;
+      m_stats.retainedBytes -= blockSize;
+      return data;
+    }
+  }
+
+  return AllocateBlock(blockSize);
+}
+
+void CVideoBufferMemory::Release(uint8_t* data)
+{
+  if (!data)
+    return;
+
+  const size_t blockSize = *reinterpret_cast<size_t*>(data - ALIGNMENT);
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    if (m_stats.retainedBytes + blockSize <= MAX_RETAINED_BYTES)
+    {
+      m_free[blockSize].push_back(data);
+      m_stats.retainedBytes += blockSize;
+      return;
+    }
+  }
+
+  FreeBlock(data);
+}
+
+AVBufferRef* CVideoBufferMemory::AllocateAVBuffer(size_t size)
+{
+  uint8_t* data = Allocate(size);
+  if (!data)
+    return nullptr;
+
+  auto* memory = new std::shared_ptr<CVideoBufferMemory>(shared_from_this());
+  AVBufferRef* buffer = av_buffer_create(data, size, FreeAVBuffer, memory, 0);
+  if (!buffer)
+  {
+    delete memory;
+    Release(data);
+  }
+  return buffer;
+}
+
+CVideoBufferMemory::Stats CVideoBufferMemory::GetStats()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  return m_stats;
+}
+
 //-----------------------------------------------------------------------------
 // CVideoBuffer
 //-----------------------------------------------------------------------------
@@ -177,11 +323,12 @@ CVideoBufferSysMem::CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFo
   m_pixFormat = format;
   m_size = size;
   memset(&m_image, 0, sizeof(YuvImage));
+  m_memory = CVideoBufferMemory::GetInstance();
 }
 
 CVideoBufferSysMem::~CVideoBufferSysMem()
 {
-  delete[] m_data;
+  m_memory->Release(m_data);
 }
 
 uint8_t* CVideoBufferSysMem::GetMemPtr()
@@ -267,8 +414,8 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
 
 bool CVideoBufferSysMem::Alloc()
 {
-  m_data = new uint8_t[m_size];
-  return true;
+  m_data = m_memory->Allocate(m_size);
+  return m_data != nullptr;
 }
 
 
@@ -302,7 +449,11 @@ CVideoBuffer* CVideoBufferPoolSysMem::Get()
   {
     int id = m_all.size();
     buf = new CVideoBufferSysMem(*this, id, m_pixFormat, m_size);
-    buf->Alloc();
+    if (!buf->Alloc())
+    {
+      delete buf;
+      return nullptr;
+    }
     m_all.push_back(buf);
     m_used.push_back(id);
   }
@@ -374,7 +525,7 @@ std::shared_ptr<IVideoBufferPool> CVideoBufferPoolSysMem::CreatePool()
 // CVideoBufferManager
 //-----------------------------------------------------------------------------
 
-CVideoBufferManager::CVideoBufferManager()
+CVideoBufferManager::CVideoBufferManager() : m_memory(CVideoBufferMemory::GetInstance())
 {
   std::unique_lock<CCriticalSection> lock(m_critSection);
   RegisterPoolFactory("SysMem", &CVideoBufferPoolSysMem::CreatePool);
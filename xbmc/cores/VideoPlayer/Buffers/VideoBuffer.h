@@ -21,6 +21,8 @@ extern "C" {
 #include <libavutil/pixfmt.h>
 }
 
+struct AVBufferRef;
+
 struct YuvImage
 {
   static const int MAX_PLANES = 3;
@@ -46,6 +48,58 @@ class CVideoBuffer;
 class IVideoBufferPool;
 class CVideoBufferManager;
 
+/*!
+ * \brief Size bucketed frame memory, shared by all pools and decoders
+ *
+ * Blocks go back to their bucket when a buffer or a frame releases them, a
+ * new pool or a reopened codec at a similar frame size takes them from there
+ * instead of the heap. Blocks of 2 MiB and more are backed by transparent
+ * huge pages where the system supports them. Blocks are 64 byte aligned.
+ */
+class CVideoBufferMemory : public std::enable_shared_from_this<CVideoBufferMemory>
+{
+public:
+  struct Stats
+  {
+    uint64_t requests = 0;
+    uint64_t hits = 0; // requests served from a bucket
+    uint64_t retainedBytes = 0; // free blocks held in the buckets
+  };
+
+  //! the memory lives as long as anyone holds a reference
+  static std::shared_ptr<CVideoBufferMemory> GetInstance();
+  ~CVideoBufferMemory();
+
+  uint8_t* Allocate(size_t size);
+  void Release(uint8_t* data);
+
+  /*!
+   * \brief Allocate a block owned by an ffmpeg buffer, for get_buffer2
+   *
+   * The block goes back to its bucket with the last reference to the buffer.
+   */
+  AVBufferRef* AllocateAVBuffer(size_t size);
+
+  Stats GetStats();
+
+  static constexpr size_t ALIGNMENT = 64;
+  static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+  //! free blocks above this go back to the heap
+  static constexpr size_t MAX_RETAINED_BYTES = 256 * 1024 * 1024;
+
+private:
+  CVideoBufferMemory() = default;
+
+  static size_t GetBlockSize(size_t size);
+  static uint8_t* AllocateBlock(size_t blockSize);
+  static void FreeBlock(uint8_t* data);
+
+  CCriticalSection m_critSection;
+  std::map<size_t, std::vector<uint8_t*>> m_free;
+  Stats m_stats;
+};
+
 typedef void (CVideoBufferManager::*ReadyToDispose)(IVideoBufferPool *pool);
 
 class IVideoBufferPool : public std::enable_shared_from_this<IVideoBufferPool>
@@ -134,6 +188,7 @@ protected:
   int m_size = 0;
   uint8_t *m_data = nullptr;
   YuvImage m_image;
+  std::shared_ptr<CVideoBufferMemory> m_memory;
 };
 
 //-----------------------------------------------------------------------------
@@ -185,8 +240,12 @@ public:
   CVideoBuffer* Get(AVPixelFormat format, int size, IVideoBufferPool **pPool);
   void ReadyForDisposal(IVideoBufferPool *pool);
 
+  //! frame memory, kept over pool releases
+  std::shared_ptr<CVideoBufferMemory> GetMemory() { return m_memory; }
+
 protected:
   CCriticalSection m_critSection;
+  std::shared_ptr<CVideoBufferMemory> m_memory;
   std::list<std::shared_ptr<IVideoBufferPool>> m_pools;
   std::list<std::shared_ptr<IVideoBufferPool>> m_discardedPools;
   std::map<std::string, CreatePoolFunc> m_poolFactories;
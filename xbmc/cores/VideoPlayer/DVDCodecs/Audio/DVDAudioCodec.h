@@ -117,7 +117,19 @@ public:
    * should return the ffmpeg profile value
    */
   virtual int GetProfile() { return 0; }
-  
+
+  /*
+   * returns true if the decoded frames do not depend on the output device,
+   * so a single instance can feed both audio outputs
+   */
+  virtual bool CanShareOutput() { return false; }
+
+  /*
+   * returns the codec delivering the frames of the 2nd audio output if this
+   * codec feeds it from its own AddData, owned by this codec
+   */
+  virtual CDVDAudioCodec* GetSecondaryOutput() { return nullptr; }
+
   void SetAudio2(bool bAudio2){ m_bAudio2 = bAudio2; };
   
 protected:
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDAudioCodecDual.h"
+
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDStreamInfo.h"
+#include "utils/log.h"
+
+CDVDAudioCodecDual::CDVDAudioCodecDual(CProcessInfo &processInfo, CAEStreamInfo::DataType streamType)
+  : CDVDAudioCodec(processInfo),
+    m_passthrough(processInfo, streamType),
+    m_decoder(processInfo)
+{
+  m_decoder.SetAudio2(true);
+}
+
+CDVDAudioCodecDual::~CDVDAudioCodecDual()
+{
+  Dispose();
+}
+
+bool CDVDAudioCodecDual::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options)
+{
+  if (!m_passthrough.Open(hints, options))
+    return false;
+
+  if (!m_decoder.Open(hints, options))
+  {
+    CLog::Log(LOGDEBUG, "CDVDAudioCodecDual::Open() Unable to open decoder for 2nd output");
+    m_passthrough.Dispose();
+    return false;
+  }
+
+  return true;
+}
+
+void CDVDAudioCodecDual::Dispose()
+{
+  m_passthrough.Dispose();
+  m_decoder.Dispose();
+}
+
+bool CDVDAudioCodecDual::AddData(const DemuxPacket &packet)
+{
+  // the decoder may refuse the packet until its frames are fetched, in that
+  // case the packet is added again later and must not reach the parser yet
+  if (!m_decoder.AddData(packet))
+    return false;
+
+  return m_passthrough.AddData(packet);
+}
+
+void CDVDAudioCodecDual::GetData(DVDAudioFrame &frame)
+{
+  m_passthrough.GetData(frame);
+}
+
+void CDVDAudioCodecDual::Reset()
+{
+  m_passthrough.Reset();
+  m_decoder.Reset();
+}
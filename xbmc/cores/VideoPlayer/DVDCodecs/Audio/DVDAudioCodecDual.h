@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDAudioCodec.h"
+#include "DVDAudioCodecFFmpeg.h"
+#include "DVDAudioCodecPassthrough.h"
+
+class CProcessInfo;
+
+/*!
+ * \brief Passthrough for the 1st audio output and decoded pcm for the 2nd one.
+ *
+ * Each demux packet is added once: the stream parser of the passthrough codec
+ * packs it for the 1st sink, and the very same packet buffer is handed to the
+ * ffmpeg decoder for the 2nd sink. The decoder reads the frame headers again,
+ * the IEC packer needs the sync frames and the bitstream info of the stream
+ * parser while ffmpeg only takes whole packets, so neither can be fed from the
+ * other. Frames of the 2nd output are fetched from GetSecondaryOutput().
+ */
+class CDVDAudioCodecDual : public CDVDAudioCodec
+{
+public:
+  CDVDAudioCodecDual(CProcessInfo &processInfo, CAEStreamInfo::DataType streamType);
+  ~CDVDAudioCodecDual() override;
+
+  bool Open(CDVDStreamInfo &hints, CDVDCodecOptions &options) override;
+  void Dispose() override;
+  bool AddData(const DemuxPacket &packet) override;
+  void GetData(DVDAudioFrame &frame) override;
+  void Reset() override;
+  AEAudioFormat GetFormat() override { return m_passthrough.GetFormat(); }
+  bool NeedPassthrough() override { return true; }
+  std::string GetName() override { return m_passthrough.GetName(); }
+  int GetBufferSize() override { return m_passthrough.GetBufferSize(); }
+  CDVDAudioCodec* GetSecondaryOutput() override { return &m_decoder; }
+
+private:
+  CDVDAudioCodecPassthrough m_passthrough;
+  CDVDAudioCodecFFmpeg m_decoder;
+};
@@ -153,6 +153,9 @@ bool CDVDAudioCodecFFmpeg::AddData(const DemuxPacket &packet)
 
   avpkt->data = packet.pData;
   avpkt->size = packet.iSize;
+  // lets the decoder keep the demuxer buffer instead of copying it
+  if (packet.m_buffer)
+    avpkt->buf = av_buffer_ref(packet.m_buffer);
   avpkt->dts = (packet.dts == DVD_NOPTS_VALUE)
                    ? AV_NOPTS_VALUE
                    : static_cast<int64_t>(packet.dts / DVD_TIME_BASE * AV_TIME_BASE);
@@ -37,6 +37,7 @@ public:
   enum AVMatrixEncoding GetMatrixEncoding() override;
   enum AVAudioServiceType GetAudioServiceType() override;
   int GetProfile() override;
+  bool CanShareOutput() override { return true; }
 
 protected:
   int GetData(uint8_t** dst);
@@ -9,6 +9,7 @@
 #include "DVDFactoryCodec.h"
 
 #include "Audio/DVDAudioCodec.h"
+#include "Audio/DVDAudioCodecDual.h"
 #include "Audio/DVDAudioCodecFFmpeg.h"
 #include "Audio/DVDAudioCodecPassthrough.h"
 #include "DVDStreamInfo.h"
@@ -43,11 +44,18 @@ CCriticalSection videoCodecSection, audioCodecSection;
 
 std::unique_ptr<CDVDVideoCodec> CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo& hint,
                                                                    CProcessInfo& processInfo)
+{
+  CDVDCodecOptions options;
+  return CreateVideoCodec(hint, processInfo, options);
+}
+
+std::unique_ptr<CDVDVideoCodec> CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo& hint,
+                                                                   CProcessInfo& processInfo,
+                                                                   CDVDCodecOptions& options)
 {
   std::unique_lock<CCriticalSection> lock(videoCodecSection);
 
   std::unique_ptr<CDVDVideoCodec> pCodec;
-  CDVDCodecOptions options;
 
   // addon handler for this stream ?
 
@@ -215,6 +223,28 @@ std::unique_ptr<CDVDAudioCodec> CDVDFactoryCodec::CreateAudioCodec(
   return nullptr;
 }
 
+std::unique_ptr<CDVDAudioCodec> CDVDFactoryCodec::CreateAudioCodecDual(
+    CDVDStreamInfo& hint,
+    CProcessInfo& processInfo,
+    bool allowdtshddecode,
+    CAEStreamInfo::DataType ptStreamType)
+{
+  if (ptStreamType == CAEStreamInfo::STREAM_TYPE_NULL)
+    return nullptr;
+
+  CDVDCodecOptions options;
+  options.m_keys.emplace_back("ptstreamtype", StringUtils::SizeToString(ptStreamType));
+  if (!allowdtshddecode)
+    options.m_keys.emplace_back("allowdtshddecode", "0");
+
+  std::unique_ptr<CDVDAudioCodec> pCodec =
+      std::make_unique<CDVDAudioCodecDual>(processInfo, ptStreamType);
+  if (pCodec->Open(hint, options))
+    return pCodec;
+
+  return nullptr;
+}
+
 void CDVDFactoryCodec::RegisterHWAudioCodec(const std::string& id, CreateHWAudioCodec createFunc)
 {
   std::unique_lock<CCriticalSection> lock(audioCodecSection);
@@ -42,6 +42,9 @@ class CDVDFactoryCodec
 public:
   static std::unique_ptr<CDVDVideoCodec> CreateVideoCodec(CDVDStreamInfo& hint,
                                                           CProcessInfo& processInfo);
+  static std::unique_ptr<CDVDVideoCodec> CreateVideoCodec(CDVDStreamInfo& hint,
+                                                          CProcessInfo& processInfo,
+                                                          CDVDCodecOptions& options);
 
   static IHardwareDecoder* CreateVideoCodecHWAccel(const std::string& id,
                                                    CDVDStreamInfo& hint,
@@ -54,6 +57,15 @@ public:
                                                           bool allowdtshddecode,
                                                           CAEStreamInfo::DataType ptStreamType, bool bAudio2 = false);
 
+  /*!
+   * \brief Create a codec that passes the stream through to the 1st audio output and
+   * decodes the same packets to pcm for the 2nd one.
+   */
+  static std::unique_ptr<CDVDAudioCodec> CreateAudioCodecDual(CDVDStreamInfo& hint,
+                                                              CProcessInfo& processInfo,
+                                                              bool allowdtshddecode,
+                                                              CAEStreamInfo::DataType ptStreamType);
+
   static std::unique_ptr<CDVDOverlayCodec> CreateOverlayCodec(CDVDStreamInfo& hint);
 
   static void RegisterHWVideoCodec(const std::string& id, CreateHWVideoCodec createFunc);
@@ -23,10 +23,12 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
 extern "C" {
+#include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 #include <libavutil/mastering_display_metadata.h>
 #include <libavfilter/avfilter.h>
@@ -269,7 +271,7 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = GetBuffer;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -303,10 +305,86 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel* cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  const AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+  if (!ctx || !desc || (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL)) ||
+      !(avctx->codec->capabilities & AV_CODEC_CAP_DR1))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  int width = frame->width;
+  int height = frame->height;
+  int strideAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, strideAlign);
+
+  // widen the picture until all strides are aligned for the decoder and for
+  // the texture upload of the renderers, aligning the strides one by one
+  // breaks assumptions of some decoders
+  int linesizes[4];
+  bool aligned;
+  do
+  {
+    if (av_image_fill_linesizes(linesizes, format, width) < 0)
+      return avcodec_default_get_buffer2(avctx, frame, flags);
+    width += width & ~(width - 1);
+
+    aligned = true;
+    for (int i = 0; i < 4; i++)
+    {
+      const int align =
+          std::max(strideAlign[i], static_cast<int>(CVideoBufferMemory::ALIGNMENT));
+      if (linesizes[i] % align)
+        aligned = false;
+    }
+  } while (!aligned);
+
+  ptrdiff_t strides[4];
+  for (int i = 0; i < 4; i++)
+    strides[i] = linesizes[i];
+
+  size_t planeSizes[4];
+  if (av_image_fill_plane_sizes(planeSizes, format, height, strides) < 0)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  // all planes in one block, each one padded like the pools of ffmpeg do it
+  size_t offsets[4];
+  size_t size = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    offsets[i] = size;
+    if (planeSizes[i])
+    {
+      const size_t padded = planeSizes[i] + 16 + CVideoBufferMemory::ALIGNMENT - 1;
+      size += padded - padded % CVideoBufferMemory::ALIGNMENT;
+    }
+  }
+
+  AVBufferRef* buffer = ctx->m_frameMemory->AllocateAVBuffer(size);
+  if (!buffer)
+    return AVERROR(ENOMEM);
+
+  frame->buf[0] = buffer;
+  for (int i = 0; i < 4; i++)
+  {
+    frame->data[i] = planeSizes[i] ? buffer->data + offsets[i] : nullptr;
+    frame->linesize[i] = linesizes[i];
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
-: CDVDVideoCodec(processInfo), m_postProc(processInfo)
+: CDVDVideoCodec(processInfo),
+  m_postProc(processInfo),
+  m_threading(CServiceBroker::GetCPUInfo()->GetCPUCount())
 {
   m_videoBufferPool = std::make_shared<CVideoBufferPoolFFmpeg>();
+  m_frameMemory = processInfo.GetVideoBufferManager().GetMemory();
 
   m_decoderState = STATE_NONE;
 }
@@ -366,6 +444,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->debug = 0;
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
+  m_pCodecContext->get_buffer2 = GetBuffer;
   m_pCodecContext->codec_tag = hints.codec_tag;
 
   // setup threading model
@@ -374,15 +453,25 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     if (m_decoderState == STATE_NONE)
     {
       m_decoderState = STATE_HW_SINGLE;
+      m_processInfo.SetVideoDecoderThreading("");
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      const double fps = hints.fpsrate > 0 && hints.fpsscale > 0
+                             ? static_cast<double>(hints.fpsrate) / hints.fpsscale
+                             : 0.0;
+      m_threading.SetAudio2Decoding(m_processInfo.GetAudio2Decoding());
+      const CDVDVideoCodecThreading::CDecision threading =
+          m_threading.Select(hints.codec, pCodec->capabilities, hints.width, hints.height, fps);
+      m_pCodecContext->thread_count = threading.threads;
+      if (threading.type == CDVDVideoCodecThreading::Type::SLICE)
+        m_pCodecContext->thread_type = FF_THREAD_SLICE;
+      else if (threading.type == CDVDVideoCodecThreading::Type::FRAME)
+        m_pCodecContext->thread_type = FF_THREAD_FRAME;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with {} threads",
-                num_threads);
+      m_processInfo.SetVideoDecoderThreading(threading.ToString());
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open with threading {} (level {})",
+                threading.ToString(), m_threading.GetLevel());
     }
   }
   else
@@ -585,6 +674,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
 
   avpkt->data = packet.pData;
   avpkt->size = packet.iSize;
+  // lets the decoder keep the demuxer buffer instead of copying it
+  if (packet.m_buffer)
+    avpkt->buf = av_buffer_ref(packet.m_buffer);
   avpkt->dts = (packet.dts == DVD_NOPTS_VALUE)
                    ? AV_NOPTS_VALUE
                    : static_cast<int64_t>(packet.dts / DVD_TIME_BASE * AV_TIME_BASE);
@@ -763,6 +855,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
+  bool dropped = false;
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
@@ -770,6 +863,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         framePTS != AV_NOPTS_VALUE &&
         framePTS > (m_dropCtrl.m_lastPTS + m_dropCtrl.m_diffPTS * 1.5))
     {
+      dropped = true;
       m_droppedFrames++;
       if (m_interlaced)
         m_droppedFrames++;
@@ -777,6 +871,26 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   }
   m_dropCtrl.Process(framePTS, m_pCodecContext->skip_frame > AVDISCARD_DEFAULT);
 
+  // keeps dropping, try to spread the decoding over more cores
+  if (m_decoderState == STATE_SW_MULTI)
+  {
+    int window = 300;
+    if (m_dropCtrl.m_state == CDropControl::VALID)
+      window = static_cast<int>(6000000 / m_dropCtrl.m_diffPTS);
+    if (m_threading.AddFrame(dropped, window))
+    {
+      CLog::Log(LOGINFO, "CDVDVideoCodecFFmpeg - dropping frames, reopen with more threads");
+      return VC_REOPEN;
+    }
+
+    // the audio of the 2nd output is decoded on its own now, or no longer is
+    if (m_threading.SetAudio2Decoding(m_processInfo.GetAudio2Decoding()))
+    {
+      CLog::Log(LOGINFO, "CDVDVideoCodecFFmpeg - 2nd audio decoder changed, reopen");
+      return VC_REOPEN;
+    }
+  }
+
   if (m_pDecodedFrame->key_frame)
   {
     m_started = true;
@@ -929,6 +1043,7 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_filters = "";
   FilterClose();
   m_dropCtrl.Reset(false);
+  m_threading.ResetStats();
 }
 
 void CDVDVideoCodecFFmpeg::Reopen()
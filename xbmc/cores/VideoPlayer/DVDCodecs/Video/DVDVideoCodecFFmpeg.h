@@ -11,6 +11,7 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoCodecThreading.h"
 #include "DVDVideoPPFFmpeg.h"
 #include <string>
 #include <vector>
@@ -48,6 +49,7 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -63,6 +65,7 @@ protected:
   AVFrame* m_pDecodedFrame = nullptr;;
   AVCodecContext* m_pCodecContext = nullptr;;
   std::shared_ptr<CVideoBufferPoolFFmpeg> m_videoBufferPool;
+  std::shared_ptr<CVideoBufferMemory> m_frameMemory;
 
   std::string m_filters;
   std::string m_filters_next;
@@ -98,6 +101,7 @@ protected:
   double m_DAR = 1.0;
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
+  CDVDVideoCodecThreading m_threading;
 
   struct CDropControl
   {
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoCodecThreading.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// frames per second if the stream does not tell
+constexpr double DEFAULT_FPS = 25.0;
+// the decoder should not need more than 2/3 of its threads
+constexpr double HEADROOM = 1.5;
+// drops in more than 1 of this many frames count as too many
+constexpr int DROP_RATIO = 50;
+constexpr int MIN_DROPS = 3;
+} // namespace
+
+std::string CDVDVideoCodecThreading::CDecision::ToString() const
+{
+  switch (type)
+  {
+    case Type::SLICE:
+      return "slice/" + std::to_string(threads);
+    case Type::FRAME:
+      return "frame/" + std::to_string(threads);
+    case Type::CODEC:
+      return "codec/" + std::to_string(threads);
+    default:
+      return "single";
+  }
+}
+
+CDVDVideoCodecThreading::CDVDVideoCodecThreading(int cpuCount) : m_cpuCount(std::max(1, cpuCount))
+{
+}
+
+double CDVDVideoCodecThreading::GetPixelRatePerCore(AVCodecID codec)
+{
+  // megapixels per second one core decodes, rough numbers, only the ratios matter
+  switch (codec)
+  {
+    case AV_CODEC_ID_MPEG1VIDEO:
+    case AV_CODEC_ID_MPEG2VIDEO:
+    case AV_CODEC_ID_MPEG4:
+    case AV_CODEC_ID_H263:
+    case AV_CODEC_ID_MJPEG:
+      return 150.0;
+    case AV_CODEC_ID_HEVC:
+    case AV_CODEC_ID_VP9:
+      return 40.0;
+    case AV_CODEC_ID_AV1:
+      return 30.0;
+    case AV_CODEC_ID_H264:
+    case AV_CODEC_ID_VC1:
+    case AV_CODEC_ID_WMV3:
+    case AV_CODEC_ID_VP8:
+    default:
+      return 60.0;
+  }
+}
+
+CDVDVideoCodecThreading::CDecision CDVDVideoCodecThreading::Select(
+    AVCodecID codec, int capabilities, int width, int height, double fps)
+{
+  m_codec = codec;
+  m_capabilities = capabilities;
+  m_pixelRate = static_cast<double>(width) * height * (fps > 0.0 ? fps : DEFAULT_FPS) / 1000000.0;
+
+  m_decision = Compute(m_level);
+  ResetStats();
+  return m_decision;
+}
+
+CDVDVideoCodecThreading::CDecision CDVDVideoCodecThreading::Compute(int level) const
+{
+  const int needed = std::max(
+      1, static_cast<int>(std::ceil(m_pixelRate * HEADROOM / GetPixelRatePerCore(m_codec))));
+
+  // leave cores for audio decoding and the render thread, unless it drops anyway
+  int reserved = m_cpuCount >= 4 ? 2 : (m_cpuCount >= 2 ? 1 : 0);
+  if (m_audio2Decoding && m_cpuCount > reserved + 1)
+    reserved++;
+  const int cores = level > 0 ? m_cpuCount : m_cpuCount - reserved;
+  const int limit = std::max(1, std::min(cores, MAX_THREADS));
+  const int threads = std::min(needed << level, limit);
+
+  const bool frame = m_capabilities & AV_CODEC_CAP_FRAME_THREADS;
+  const bool slice = m_capabilities & AV_CODEC_CAP_SLICE_THREADS;
+  const bool other = m_capabilities & AV_CODEC_CAP_OTHER_THREADS;
+
+  CDecision decision;
+  if (other && threads > 1)
+  {
+    decision.type = Type::CODEC;
+    decision.threads = threads;
+  }
+  else if (threads == 1 && slice && limit > 1)
+  {
+    // one core is enough, slices still cut the time per frame without adding any delay
+    decision.type = Type::SLICE;
+    decision.threads = 2;
+  }
+  else if (threads > 1 && frame)
+  {
+    decision.type = Type::FRAME;
+    decision.threads = threads;
+  }
+  else if (threads > 1 && slice)
+  {
+    decision.type = Type::SLICE;
+    decision.threads = threads;
+  }
+  return decision;
+}
+
+bool CDVDVideoCodecThreading::AddFrame(bool dropped, int window)
+{
+  m_frames++;
+  if (dropped)
+    m_dropped++;
+
+  if (m_frames < window)
+    return false;
+
+  const bool tooMany = m_dropped >= MIN_DROPS && m_dropped * DROP_RATIO > m_frames;
+  ResetStats();
+  if (!tooMany || m_level >= MAX_LEVEL)
+    return false;
+
+  // only worth a reopen if the next level changes anything
+  if (Compute(m_level + 1) == m_decision)
+    return false;
+
+  m_level++;
+  return true;
+}
+
+bool CDVDVideoCodecThreading::SetAudio2Decoding(bool decoding)
+{
+  if (decoding == m_audio2Decoding)
+    return false;
+
+  m_audio2Decoding = decoding;
+  return m_codec != AV_CODEC_ID_NONE && !(Compute(m_level) == m_decision);
+}
+
+void CDVDVideoCodecThreading::ResetStats()
+{
+  m_frames = 0;
+  m_dropped = 0;
+}
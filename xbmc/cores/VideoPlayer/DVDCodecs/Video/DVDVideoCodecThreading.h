@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/*!
+ * \brief Threading policy of the ffmpeg software video decoder
+ *
+ * The thread count follows the pixel rate of the stream and the cost of the
+ * codec, instead of the number of cores, and leaves cores for the audio decoders
+ * and the render thread. Slice threading is used for light streams where the
+ * codec supports it, it does not add the latency of frame threading.
+ *
+ * The decoder reports every frame and whether the player made it drop frames.
+ * If it keeps dropping, the policy steps up: frame threading, more threads and
+ * finally the reserved cores. The decoder has to be reopened to apply that.
+ */
+class CDVDVideoCodecThreading
+{
+public:
+  enum class Type
+  {
+    SINGLE,
+    SLICE,
+    FRAME,
+    CODEC, //!< the codec does its own threading, e.g. libdav1d
+  };
+
+  struct CDecision
+  {
+    Type type = Type::SINGLE;
+    int threads = 1;
+
+    bool operator==(const CDecision& other) const
+    {
+      return type == other.type && threads == other.threads;
+    }
+    std::string ToString() const;
+  };
+
+  static constexpr int MAX_THREADS = 16;
+  static constexpr int MAX_LEVEL = 2;
+
+  explicit CDVDVideoCodecThreading(int cpuCount);
+
+  /*!
+   * \param capabilities AV_CODEC_CAP_* flags of the decoder
+   * \param fps frame rate, 0 if unknown
+   */
+  CDecision Select(AVCodecID codec, int capabilities, int width, int height, double fps);
+
+  /*!
+   * \brief Count a decoded frame
+   * \param dropped the decoder skipped frames before this one
+   * \param window frames to judge the drop rate on, a few seconds of video
+   * \return true if the decision should be raised, the decoder needs a reopen
+   */
+  bool AddFrame(bool dropped, int window);
+
+  /*!
+   * \brief A 2nd audio decoder for dual audio started or stopped, it gets a core of its own
+   * \return true if the decision changes, the decoder needs a reopen
+   */
+  bool SetAudio2Decoding(bool decoding);
+
+  void ResetStats();
+  const CDecision& GetDecision() const { return m_decision; }
+  int GetLevel() const { return m_level; }
+
+private:
+  CDecision Compute(int level) const;
+  static double GetPixelRatePerCore(AVCodecID codec);
+
+  int m_cpuCount;
+  int m_level = 0;
+  bool m_audio2Decoding = false;
+  AVCodecID m_codec = AV_CODEC_ID_NONE;
+  int m_capabilities = 0;
+  double m_pixelRate = 0.0; //!< in megapixels per second
+  CDecision m_decision;
+  int m_frames = 0;
+  int m_dropped = 0;
+};
@@ -9,9 +9,11 @@
 #pragma once
 
 #include "DVDDemux.h"
+#include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 
 #include <map>
+#include <memory>
 #include <vector>
 
 extern "C" {
@@ -57,7 +59,7 @@ protected:
   std::map<int, std::shared_ptr<CDemuxStream>> m_streams;
   int m_displayTime;
   double m_dtsAtDisplayTime;
-  std::unique_ptr<DemuxPacket> m_packet;
+  std::unique_ptr<DemuxPacket, DemuxPacketDeleter> m_packet;
   int m_videoStreamPlaying = -1;
 
 private:
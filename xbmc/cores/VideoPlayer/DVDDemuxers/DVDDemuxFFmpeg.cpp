@@ -1125,7 +1125,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
               if (m_pkt.pkt.stream_index ==
                   (int)m_pFormatContext->programs[m_program]->stream_index[i])
               {
-                pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+                pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
                 break;
               }
             }
@@ -1134,7 +1134,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
               bReturnEmpty = true;
           }
           else
-            pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+            pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
         }
         else
           bReturnEmpty = true;
@@ -1148,13 +1148,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             m_pkt.pkt.pts = AV_NOPTS_VALUE;
           }
 
-          // copy contents into our own packet
-          pPacket->iSize = m_pkt.pkt.size;
-
-          // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-          if (m_pkt.pkt.data)
-            memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
           pPacket->pts =
               ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
           pPacket->dts =
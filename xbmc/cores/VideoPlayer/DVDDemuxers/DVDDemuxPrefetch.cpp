@@ -0,0 +1,176 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxPrefetch.h"
+
+#include "DVDDemux.h"
+#include "DVDDemuxUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace std::chrono_literals;
+
+CDVDDemuxPrefetch::CDVDDemuxPrefetch(CDVDDemux& demuxer, CCriticalSection& demuxSection)
+  : CThread("DemuxPrefetch"), m_demuxer(demuxer), m_demuxSection(demuxSection)
+{
+}
+
+CDVDDemuxPrefetch::~CDVDDemuxPrefetch()
+{
+  StopThread();
+
+  for (const SQueuedPacket& queued : m_packets)
+    CDVDDemuxUtils::FreeDemuxPacket(queued.packet);
+}
+
+void CDVDDemuxPrefetch::Start()
+{
+  CLog::Log(LOGINFO, "CDVDDemuxPrefetch::{} - reading up to {} packets ahead", __FUNCTION__,
+            MAX_PACKETS);
+  Create();
+}
+
+bool CDVDDemuxPrefetch::Read(DemuxPacket*& packet, bool& oldStream)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  if (m_packets.empty())
+    return false;
+
+  packet = m_packets.front().packet;
+  oldStream = m_packets.front().oldStream;
+  m_packets.pop_front();
+  if (packet)
+    m_bytes -= packet->iSize;
+
+  // the player has seen the empty read or the stream change, go on
+  if (m_packets.empty())
+    m_blocked = false;
+
+  m_wakeEvent.Set();
+  return true;
+}
+
+void CDVDDemuxPrefetch::Flush()
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  for (const SQueuedPacket& queued : m_packets)
+    CDVDDemuxUtils::FreeDemuxPacket(queued.packet);
+  m_packets.clear();
+  m_bytes = 0;
+  m_blocked = false;
+
+  m_wakeEvent.Set();
+}
+
+bool CDVDDemuxPrefetch::HasPacket()
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  return !m_packets.empty();
+}
+
+void CDVDDemuxPrefetch::WaitForPacket(std::chrono::milliseconds timeout, bool busy)
+{
+  if (busy)
+    m_busy++;
+  else
+    m_underruns++;
+
+  m_wakeEvent.Set();
+  m_packetEvent.Wait(timeout);
+}
+
+SDemuxPrefetchInfo CDVDDemuxPrefetch::GetInfo()
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  SDemuxPrefetchInfo info;
+  info.active = true;
+  info.packets = static_cast<unsigned int>(m_packets.size());
+  info.bytes = m_bytes;
+  info.level = std::max(100 * static_cast<int>(m_packets.size()) / static_cast<int>(MAX_PACKETS),
+                        static_cast<int>(100LL * m_bytes / MAX_BYTES));
+  info.underruns = m_underruns;
+  info.busy = m_busy;
+  return info;
+}
+
+bool CDVDDemuxPrefetch::StreamReplaced(const DemuxPacket& packet)
+{
+  const CDemuxStream* stream = m_demuxer.GetStream(packet.demuxerId, packet.iStreamId);
+  const int changes = stream ? stream->changes : 0;
+
+  const auto seen = m_streams.find({packet.demuxerId, packet.iStreamId});
+  if (seen == m_streams.end())
+  {
+    m_streams.emplace(std::make_pair(packet.demuxerId, packet.iStreamId),
+                      SStreamSeen{stream, changes});
+    return false;
+  }
+
+  // a replacement is allocated before the old stream is deleted, the pointers differ
+  const bool replaced = seen->second.stream != stream || seen->second.changes != changes;
+  seen->second = {stream, changes};
+  return replaced;
+}
+
+bool CDVDDemuxPrefetch::IsFull() const
+{
+  return m_blocked || m_packets.size() >= MAX_PACKETS || m_bytes >= MAX_BYTES;
+}
+
+void CDVDDemuxPrefetch::Process()
+{
+  while (!m_bStop)
+  {
+    {
+      std::unique_lock<CCriticalSection> lock(m_section);
+      if (IsFull())
+      {
+        lock.unlock();
+        AbortableWait(m_wakeEvent, 100ms);
+        continue;
+      }
+    }
+
+    // the player is using the demuxer, it wakes us once it lets go
+    std::unique_lock<CCriticalSection> demuxLock(m_demuxSection, std::try_to_lock);
+    if (!demuxLock.owns_lock())
+    {
+      AbortableWait(m_wakeEvent, 5ms);
+      continue;
+    }
+
+    DemuxPacket* packet = m_demuxer.Read();
+    const bool replaced = packet && packet->iStreamId >= 0 && StreamReplaced(*packet);
+
+    // queue it before the player can get hold of the demuxer, a seek
+    // flushes everything read up to here
+    std::unique_lock<CCriticalSection> lock(m_section);
+    if (replaced)
+    {
+      // the stream the packets before were read for is gone, the player must not
+      // reopen it with them. Nothing more is read until it has seen the change.
+      for (SQueuedPacket& queued : m_packets)
+      {
+        if (queued.packet && queued.packet->demuxerId == packet->demuxerId &&
+            queued.packet->iStreamId == packet->iStreamId)
+          queued.oldStream = true;
+      }
+    }
+    m_packets.push_back({packet, false});
+    if (packet)
+      m_bytes += packet->iSize;
+    if (!packet || packet->iStreamId == DMX_SPECIALID_STREAMCHANGE || replaced)
+      m_blocked = true;
+    m_packetEvent.Set();
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/DataCacheCore.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <utility>
+
+class CDVDDemux;
+class CDemuxStream;
+struct DemuxPacket;
+
+/*!
+ * \brief Reads packets of a demuxer ahead on its own thread
+ *
+ * The demuxer is shared with the player thread, both hold the demux section
+ * while they use it. The player takes the packets read ahead with Read, it
+ * never waits on a read in progress unless it has to touch the demuxer.
+ *
+ * Reading stops after an empty read or a stream change, until the player
+ * has taken that packet. The player sees them in the same order as if it had
+ * read the demuxer itself.
+ *
+ * The demuxer also replaces a stream in place when its codec or format changes
+ * during a read. Packets read before are then marked, they still belong to the
+ * stream as it was and the player must not take the change from them.
+ */
+class CDVDDemuxPrefetch : private CThread
+{
+public:
+  CDVDDemuxPrefetch(CDVDDemux& demuxer, CCriticalSection& demuxSection);
+  ~CDVDDemuxPrefetch() override;
+
+  void Start();
+
+  /*!
+   * \brief Take the oldest packet read ahead, the demux section must be held
+   * \param packet nullptr if the demuxer had nothing to return
+   * \param oldStream true if a later read replaced or changed the stream of the packet
+   * \return false if nothing has been read ahead yet
+   */
+  bool Read(DemuxPacket*& packet, bool& oldStream);
+
+  /*!
+   * \brief Drop everything read ahead, after a seek or a reset of the demuxer
+   *
+   * The demux section must be held, reading goes on from the new position.
+   */
+  void Flush();
+
+  //! true if Read has something to return
+  bool HasPacket();
+
+  /*!
+   * \brief Wait until a packet has been read ahead
+   * \param busy the player found the demuxer in use by a read
+   */
+  void WaitForPacket(std::chrono::milliseconds timeout, bool busy);
+
+  //! the player released the demuxer
+  void Wake() { m_wakeEvent.Set(); }
+
+  SDemuxPrefetchInfo GetInfo();
+
+  static constexpr size_t MAX_PACKETS = 256;
+  static constexpr int MAX_BYTES = 8 * 1024 * 1024;
+
+private:
+  void Process() override;
+  bool IsFull() const;
+  //! true if the read of packet replaced or changed a stream seen before
+  bool StreamReplaced(const DemuxPacket& packet);
+
+  CDVDDemux& m_demuxer;
+  CCriticalSection& m_demuxSection;
+
+  CCriticalSection m_section;
+  struct SQueuedPacket
+  {
+    DemuxPacket* packet;
+    bool oldStream;
+  };
+  std::deque<SQueuedPacket> m_packets;
+  int m_bytes = 0;
+  //! an empty read or a stream change is waiting for the player
+  bool m_blocked = false;
+
+  struct SStreamSeen
+  {
+    const CDemuxStream* stream; //!< only compared, it may be gone
+    int changes;
+  };
+  //! the streams as of the last read, by demuxer and stream id, demux thread only
+  std::map<std::pair<int64_t, int>, SStreamSeen> m_streams;
+
+  CEvent m_wakeEvent;
+  CEvent m_packetEvent;
+  std::atomic<uint64_t> m_underruns{0};
+  std::atomic<uint64_t> m_busy{0};
+};
@@ -8,20 +8,41 @@
 
 #include "DVDDemuxUtils.h"
 
+#include "DemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/DemuxCrypto.h"
-#include "utils/MemUtils.h"
 #include "utils/log.h"
 
+#include <new>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+namespace
+{
+DemuxPacket* NewDemuxPacket()
+{
+  void* header = CDemuxPacketPool::GetInstance().Allocate(sizeof(DemuxPacket));
+  if (!header)
+    return nullptr;
+  return new (header) DemuxPacket();
+}
+
+void DeleteDemuxPacket(DemuxPacket* pPacket)
+{
+  pPacket->~DemuxPacket();
+  CDemuxPacketPool::GetInstance().Release(pPacket);
+}
+} // namespace
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
+    if (pPacket->m_buffer)
+      av_buffer_unref(&pPacket->m_buffer);
+    else if (pPacket->pData)
+      CDemuxPacketPool::GetInstance().Release(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket* avPkt = av_packet_alloc();
@@ -44,14 +65,19 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
       }
     }
     if (pPacket->cryptoInfo)
-      delete pPacket->cryptoInfo;
-    delete pPacket;
+    {
+      static_cast<DemuxCryptoInfo*>(pPacket->cryptoInfo)->~DemuxCryptoInfo();
+      CDemuxPacketPool::GetInstance().Release(pPacket->cryptoInfo);
+    }
+    DeleteDemuxPacket(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  DemuxPacket* pPacket = NewDemuxPacket();
+  if (!pPacket)
+    return NULL;
 
   if (iDataSize > 0)
   {
@@ -64,7 +90,8 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    pPacket->pData = static_cast<uint8_t*>(
+        CDemuxPacketPool::GetInstance().Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE));
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -82,10 +109,56 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
 {
   DemuxPacket *ret(AllocateDemuxPacket(iDataSize));
   if (ret && encryptedSubsampleCount > 0)
-    ret->cryptoInfo = new DemuxCryptoInfo(encryptedSubsampleCount);
+  {
+    // info and both subsample arrays share one block
+    const size_t clearOffset = sizeof(DemuxCryptoInfo);
+    const size_t cipherOffset =
+        (clearOffset + encryptedSubsampleCount * sizeof(uint16_t) + 3) & ~static_cast<size_t>(3);
+    uint8_t* block = static_cast<uint8_t*>(CDemuxPacketPool::GetInstance().Allocate(
+        cipherOffset + encryptedSubsampleCount * sizeof(uint32_t)));
+    if (!block)
+    {
+      FreeDemuxPacket(ret);
+      return NULL;
+    }
+    ret->cryptoInfo = new (block)
+        DemuxCryptoInfo(encryptedSubsampleCount, reinterpret_cast<uint16_t*>(block + clearOffset),
+                        reinterpret_cast<uint32_t*>(block + cipherOffset));
+  }
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(const AVPacket& src)
+{
+  // packets of lavf demuxers carry the padding required by the decoders, hold a
+  // reference instead of copying them
+  if (src.buf && src.data && src.data >= src.buf->data &&
+      src.data + src.size + AV_INPUT_BUFFER_PADDING_SIZE <= src.buf->data + src.buf->size)
+  {
+    DemuxPacket* pPacket = NewDemuxPacket();
+    if (!pPacket)
+      return nullptr;
+
+    pPacket->m_buffer = av_buffer_ref(src.buf);
+    if (pPacket->m_buffer)
+    {
+      pPacket->pData = src.data;
+      pPacket->iSize = src.size;
+      return pPacket;
+    }
+    DeleteDemuxPacket(pPacket);
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(src.size);
+  if (!pPacket)
+    return nullptr;
+
+  pPacket->iSize = src.size;
+  if (src.data)
+    memcpy(pPacket->pData, src.data, src.size);
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket* avPkt = av_packet_alloc();
@@ -19,6 +19,16 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   * \brief Packet holding the data of src, references the buffer of src if it is
+   * reference counted and padded, copies the data otherwise
+   */
+  static DemuxPacket* AllocateDemuxPacket(const AVPacket& src);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
 };
 
+struct DemuxPacketDeleter
+{
+  void operator()(DemuxPacket* pPacket) const { CDVDDemuxUtils::FreeDemuxPacket(pPacket); }
+};
+
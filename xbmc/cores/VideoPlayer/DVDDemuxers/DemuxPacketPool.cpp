@@ -0,0 +1,336 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxPacketPool.h"
+
+#include "utils/MemUtils.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+// keeps the payload behind it 16 byte aligned
+constexpr size_t HEADER_SIZE = 16;
+
+struct BlockHeader
+{
+  int sizeClass; // -1 for blocks above MAX_BLOCK_SIZE
+};
+
+BlockHeader* GetHeader(void* ptr)
+{
+  return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - HEADER_SIZE);
+}
+
+// about 1 MiB per class and thread, about 16 MiB per class in the shared lists, all of them
+// within CDemuxPacketPool::MAX_RETAINED_BYTES
+unsigned int GetCacheLimit(size_t blockSize)
+{
+  return std::clamp(static_cast<unsigned int>((1 << 20) / blockSize), 2u, 64u);
+}
+
+unsigned int GetSharedLimit(size_t blockSize)
+{
+  return std::clamp(static_cast<unsigned int>((16 << 20) / blockSize), 4u, 512u);
+}
+
+thread_local bool cacheDestroyed = false;
+} // namespace
+
+/*!
+ * \brief Free blocks of one thread, handed back to the pool when the thread ends
+ */
+class CDemuxPacketPoolCache
+{
+public:
+  //! nullptr while the thread is shutting down
+  static CDemuxPacketPoolCache* Get()
+  {
+    if (cacheDestroyed)
+      return nullptr;
+    thread_local CDemuxPacketPoolCache cache;
+    return &cache;
+  }
+
+  ~CDemuxPacketPoolCache()
+  {
+    cacheDestroyed = true;
+    for (int i = 0; i < CDemuxPacketPool::SIZE_CLASSES; i++)
+    {
+      if (m_counts[i])
+        m_pool.Give(i, m_heads[i], GetTail(i), m_counts[i]);
+    }
+  }
+
+  void* Pop(int sizeClass)
+  {
+    if (!m_heads[sizeClass])
+    {
+      const unsigned int batch =
+          GetCacheLimit(CDemuxPacketPool::GetBlockSize(sizeClass)) / 2;
+      m_counts[sizeClass] += m_pool.Take(sizeClass, m_heads[sizeClass], batch);
+      if (!m_heads[sizeClass])
+        return nullptr;
+    }
+
+    CDemuxPacketPool::FreeBlock* block = m_heads[sizeClass];
+    m_heads[sizeClass] = block->next;
+    m_counts[sizeClass]--;
+    return block;
+  }
+
+  void Push(int sizeClass, void* ptr)
+  {
+    auto* block = static_cast<CDemuxPacketPool::FreeBlock*>(ptr);
+    block->next = m_heads[sizeClass];
+    m_heads[sizeClass] = block;
+    m_counts[sizeClass]++;
+
+    // hand half of the cache over in one go, another thread most likely
+    // allocates what this one releases
+    const unsigned int limit = GetCacheLimit(CDemuxPacketPool::GetBlockSize(sizeClass));
+    if (m_counts[sizeClass] > limit)
+    {
+      const unsigned int keep = limit / 2;
+      CDemuxPacketPool::FreeBlock* last = m_heads[sizeClass];
+      for (unsigned int i = 1; i < keep; i++)
+        last = last->next;
+
+      CDemuxPacketPool::FreeBlock* head = last->next;
+      last->next = nullptr;
+      m_pool.Give(sizeClass, head, GetTail(head), m_counts[sizeClass] - keep);
+      m_counts[sizeClass] = keep;
+    }
+  }
+
+private:
+  CDemuxPacketPoolCache() : m_pool(CDemuxPacketPool::GetInstance()) {}
+
+  CDemuxPacketPool::FreeBlock* GetTail(int sizeClass) { return GetTail(m_heads[sizeClass]); }
+
+  static CDemuxPacketPool::FreeBlock* GetTail(CDemuxPacketPool::FreeBlock* head)
+  {
+    while (head->next)
+      head = head->next;
+    return head;
+  }
+
+  CDemuxPacketPool& m_pool;
+  CDemuxPacketPool::FreeBlock* m_heads[CDemuxPacketPool::SIZE_CLASSES] = {};
+  unsigned int m_counts[CDemuxPacketPool::SIZE_CLASSES] = {};
+};
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Trim();
+}
+
+int CDemuxPacketPool::GetSizeClass(size_t size)
+{
+  if (size > MAX_BLOCK_SIZE)
+    return -1;
+
+  int sizeClass = 0;
+  while (GetBlockSize(sizeClass) < size)
+    sizeClass++;
+  return sizeClass;
+}
+
+void* CDemuxPacketPool::Allocate(size_t size)
+{
+  m_requests.fetch_add(1, std::memory_order_relaxed);
+
+  const int sizeClass = GetSizeClass(size);
+  if (sizeClass < 0)
+  {
+    auto* header =
+        static_cast<BlockHeader*>(KODI::MEMORY::AlignedMalloc(HEADER_SIZE + size, HEADER_SIZE));
+    if (!header)
+      return nullptr;
+    header->sizeClass = -1;
+    return reinterpret_cast<uint8_t*>(header) + HEADER_SIZE;
+  }
+
+  void* ptr = nullptr;
+  CDemuxPacketPoolCache* cache = CDemuxPacketPoolCache::Get();
+  if (cache)
+  {
+    ptr = cache->Pop(sizeClass);
+  }
+  else
+  {
+    FreeBlock* head = nullptr;
+    if (Take(sizeClass, head, 1))
+      ptr = head;
+  }
+
+  if (ptr)
+  {
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    m_retainedBytes.fetch_sub(GetBlockSize(sizeClass), std::memory_order_relaxed);
+    return ptr;
+  }
+
+  return AllocateBlock(sizeClass);
+}
+
+void CDemuxPacketPool::Release(void* ptr)
+{
+  if (!ptr)
+    return;
+
+  BlockHeader* header = GetHeader(ptr);
+  const int sizeClass = header->sizeClass;
+  if (sizeClass < 0)
+  {
+    KODI::MEMORY::AlignedFree(header);
+    return;
+  }
+
+  const size_t blockSize = GetBlockSize(sizeClass);
+  if (m_retainedBytes.fetch_add(blockSize, std::memory_order_relaxed) + blockSize >
+      MAX_RETAINED_BYTES)
+  {
+    // make room in the shared lists, a quarter more than needed so that this isn't done on every
+    // release. The thread caches can't be freed from here, without room the block is freed
+    TrimTo(MAX_RETAINED_BYTES / 4 * 3);
+    if (m_retainedBytes.load(std::memory_order_relaxed) > MAX_RETAINED_BYTES)
+    {
+      m_retainedBytes.fetch_sub(blockSize, std::memory_order_relaxed);
+      KODI::MEMORY::AlignedFree(header);
+      return;
+    }
+  }
+
+  CDemuxPacketPoolCache* cache = CDemuxPacketPoolCache::Get();
+  if (cache)
+  {
+    cache->Push(sizeClass, ptr);
+  }
+  else
+  {
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = nullptr;
+    Give(sizeClass, block, block, 1);
+  }
+}
+
+CDemuxPacketPool::Stats CDemuxPacketPool::GetStats() const
+{
+  Stats stats;
+  stats.requests = m_requests.load(std::memory_order_relaxed);
+  stats.hits = m_hits.load(std::memory_order_relaxed);
+  stats.retainedBytes = m_retainedBytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void CDemuxPacketPool::Trim()
+{
+  TrimTo(0);
+}
+
+void CDemuxPacketPool::TrimTo(uint64_t bytes)
+{
+  for (int i = SIZE_CLASSES - 1; i >= 0; i--)
+  {
+    if (m_retainedBytes.load(std::memory_order_relaxed) <= bytes)
+      return;
+
+    FreeBlock* head = nullptr;
+    {
+      std::unique_lock<CCriticalSection> lock(m_lists[i].lock);
+      while (m_lists[i].head && m_retainedBytes.load(std::memory_order_relaxed) > bytes)
+      {
+        FreeBlock* block = m_lists[i].head;
+        m_lists[i].head = block->next;
+        block->next = head;
+        head = block;
+        m_lists[i].count--;
+        m_retainedBytes.fetch_sub(GetBlockSize(i), std::memory_order_relaxed);
+      }
+    }
+    FreeBlocks(head);
+  }
+}
+
+void* CDemuxPacketPool::AllocateBlock(int sizeClass)
+{
+  auto* header = static_cast<BlockHeader*>(
+      KODI::MEMORY::AlignedMalloc(HEADER_SIZE + GetBlockSize(sizeClass), HEADER_SIZE));
+  if (!header)
+    return nullptr;
+
+  header->sizeClass = sizeClass;
+  return reinterpret_cast<uint8_t*>(header) + HEADER_SIZE;
+}
+
+void CDemuxPacketPool::FreeBlocks(FreeBlock* head)
+{
+  while (head)
+  {
+    FreeBlock* next = head->next;
+    KODI::MEMORY::AlignedFree(GetHeader(head));
+    head = next;
+  }
+}
+
+unsigned int CDemuxPacketPool::Take(int sizeClass, FreeBlock*& head, unsigned int count)
+{
+  FreeList& list = m_lists[sizeClass];
+  std::unique_lock<CCriticalSection> lock(list.lock);
+
+  unsigned int taken = 0;
+  while (list.head && taken < count)
+  {
+    FreeBlock* block = list.head;
+    list.head = block->next;
+    block->next = head;
+    head = block;
+    taken++;
+  }
+  list.count -= taken;
+  return taken;
+}
+
+void CDemuxPacketPool::Give(int sizeClass, FreeBlock* head, FreeBlock* tail, unsigned int count)
+{
+  FreeList& list = m_lists[sizeClass];
+  FreeBlock* excess = nullptr;
+  unsigned int excessCount = 0;
+  {
+    std::unique_lock<CCriticalSection> lock(list.lock);
+    tail->next = list.head;
+    list.head = head;
+    list.count += count;
+
+    // the shared list is bounded, the rest goes back to the heap
+    const unsigned int limit = GetSharedLimit(GetBlockSize(sizeClass));
+    while (list.count > limit)
+    {
+      FreeBlock* block = list.head;
+      list.head = block->next;
+      block->next = excess;
+      excess = block;
+      list.count--;
+      excessCount++;
+    }
+  }
+
+  if (excess)
+  {
+    m_retainedBytes.fetch_sub(excessCount * GetBlockSize(sizeClass), std::memory_order_relaxed);
+    FreeBlocks(excess);
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * \brief Size classed block pool for demux packets, their payloads and crypto info
+ *
+ * Packets are allocated on the demux thread and released on the decoder
+ * threads. Every thread keeps a small cache per size class, caches exchange
+ * blocks with the shared lists in batches, so the lock of the pool is only
+ * taken every few packets. Blocks are 16 byte aligned. The free blocks kept
+ * for reuse are bounded by MAX_RETAINED_BYTES.
+ */
+class CDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    uint64_t requests = 0;
+    uint64_t hits = 0; // requests served without going to the heap
+    uint64_t retainedBytes = 0; // free blocks held by the pool and the thread caches
+
+    double GetHitRate() const { return requests ? static_cast<double>(hits) / requests : 0.0; }
+  };
+
+  static CDemuxPacketPool& GetInstance();
+
+  void* Allocate(size_t size);
+
+  /*!
+   * \brief Give a block back, may be called from any thread
+   */
+  void Release(void* ptr);
+
+  Stats GetStats() const;
+
+  /*!
+   * \brief Free the blocks held by the shared lists, thread caches are kept
+   */
+  void Trim();
+
+  static constexpr int SIZE_CLASSES = 16;
+  static constexpr size_t MIN_BLOCK_SIZE = 128;
+  //! blocks above this size go straight to the heap
+  static constexpr size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE << (SIZE_CLASSES - 1);
+  //! free blocks kept by the shared lists and the thread caches of all size classes together
+  static constexpr uint64_t MAX_RETAINED_BYTES = 64 << 20;
+
+private:
+  friend class CDemuxPacketPoolCache;
+
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  struct FreeList
+  {
+    CCriticalSection lock;
+    FreeBlock* head = nullptr;
+    unsigned int count = 0;
+  };
+
+  CDemuxPacketPool() = default;
+  ~CDemuxPacketPool();
+
+  static int GetSizeClass(size_t size);
+  static size_t GetBlockSize(int sizeClass) { return MIN_BLOCK_SIZE << sizeClass; }
+  void* AllocateBlock(int sizeClass);
+  void FreeBlocks(FreeBlock* head);
+
+  /*!
+   * \brief Free blocks of the shared lists, largest first, until at most bytes are retained
+   */
+  void TrimTo(uint64_t bytes);
+
+  /*!
+   * \brief Move up to count blocks of the shared list to the list at head
+   * \return number of blocks moved
+   */
+  unsigned int Take(int sizeClass, FreeBlock*& head, unsigned int count);
+
+  /*!
+   * \brief Give a chain of count blocks to the shared list
+   */
+  void Give(int sizeClass, FreeBlock* head, FreeBlock* tail, unsigned int count);
+
+  FreeList m_lists[SIZE_CLASSES];
+  std::atomic<uint64_t> m_requests{0};
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_retainedBytes{0};
+};
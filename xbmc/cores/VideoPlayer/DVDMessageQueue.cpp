@@ -17,6 +17,23 @@
 
 using namespace std::chrono_literals;
 
+namespace
+{
+DemuxPacket* GetDemuxPacket(const std::shared_ptr<CDVDMsg>& msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return nullptr;
+  return static_cast<CDVDMsgDemuxerPacket*>(msg.get())->GetPacket();
+}
+
+double GetPacketTime(const DemuxPacket* packet)
+{
+  if (packet->dts != DVD_NOPTS_VALUE)
+    return packet->dts;
+  return packet->pts;
+}
+} // namespace
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -24,7 +41,7 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
 
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
-  m_TimeSize = 1.0 / 4.0; /* 4 seconds */
+  m_maxTimeSize = 4.0;
   m_iMaxDataSize = 0;
 }
 
@@ -42,28 +59,50 @@ void CDVDMessageQueue::Init()
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_drain = false;
+  m_producer = std::thread::id();
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   std::unique_lock<CCriticalSection> lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
+  m_messages.remove_if([this, type](const DVDMessageListItem &item){
+    if (type != CDVDMsg::NONE && !item.message->IsType(type))
+      return false;
+    DemuxPacket* packet = GetDemuxPacket(item.message);
+    if (packet)
+      m_iDataSize -= packet->iSize;
+    return true;
   });
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
 
+  m_listCount = m_messages.size() + m_prioMessages.size();
+
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
+    FlushPacketSlots();
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
   }
 }
 
+void CDVDMessageQueue::FlushPacketSlots()
+{
+  // keep the lock-free path of Get out while the slots are emptied here
+  m_flushPending = true;
+  while (m_consumerBusy)
+    std::this_thread::yield();
+
+  PacketSlot slot;
+  while (m_packets.Pop(slot))
+    m_iDataSize -= slot.size;
+
+  m_flushPending = false;
+}
+
 void CDVDMessageQueue::Abort()
 {
   std::unique_lock<CCriticalSection> lock(m_section);
@@ -83,6 +122,7 @@ void CDVDMessageQueue::End()
   m_bInitialized = false;
   m_iDataSize = 0;
   m_bAbortRequest = false;
+  m_producer = std::thread::id();
 }
 
 MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg, int priority)
@@ -99,6 +139,16 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
                                          int priority,
                                          bool front)
 {
+  // packets of the producer thread take the preallocated slots, without the lock
+  if (pMsg && priority == 0 && front && m_bInitialized && pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    const std::thread::id self = std::this_thread::get_id();
+    std::thread::id none;
+    if ((m_producer.load() == self || m_producer.compare_exchange_strong(none, self)) &&
+        PutPacketSlot(pMsg))
+      return MSGQ_OK;
+  }
+
   std::unique_lock<CCriticalSection> lock(m_section);
 
   if (!m_bInitialized)
@@ -126,30 +176,22 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
   }
   else
   {
-    if (m_messages.empty())
-    {
-      m_iDataSize = 0;
-      m_TimeBack = DVD_NOPTS_VALUE;
-      m_TimeFront = DVD_NOPTS_VALUE;
-    }
-
+    // the list stays sorted, newest at the front
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.emplace_front(pMsg, priority, m_sequence++);
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.emplace_back(pMsg, priority, --m_backSequence);
   }
+  m_listCount++;
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  DemuxPacket* packet = GetDemuxPacket(pMsg);
+  if (packet && priority == 0)
   {
-    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg.get())->GetPacket();
-    if (packet)
-    {
-      m_iDataSize += packet->iSize;
-      if (front)
-        UpdateTimeFront();
-      else
-        UpdateTimeBack();
-    }
+    m_iDataSize += packet->iSize;
+    if (front)
+      UpdateTimeFront(GetPacketTime(packet));
+    else
+      UpdateTimeBack(GetPacketTime(packet));
   }
 
   // inform waiter for new packet
@@ -158,10 +200,42 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
   return MSGQ_OK;
 }
 
+bool CDVDMessageQueue::PutPacketSlot(const std::shared_ptr<CDVDMsg>& pMsg)
+{
+  DemuxPacket* packet = GetDemuxPacket(pMsg);
+  if (!packet)
+    return false;
+
+  PacketSlot slot;
+  slot.message = pMsg;
+  slot.sequence = m_sequence++;
+  slot.size = packet->iSize;
+  slot.time = GetPacketTime(packet);
+
+  // account before the slot is visible, Get subtracts as soon as it takes it
+  m_iDataSize += slot.size;
+  const double time = slot.time;
+  if (!m_packets.Push(std::move(slot)))
+  {
+    m_iDataSize -= packet->iSize;
+    return false;
+  }
+  UpdateTimeFront(time);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_waiting.load(std::memory_order_relaxed))
+    m_hEvent.Set();
+
+  return true;
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
                                          unsigned int iTimeoutInMilliSeconds,
                                          int& priority)
 {
+  if (priority == 0 && m_bInitialized && !m_bAbortRequest && GetPacketSlot(pMsg))
+    return MSGQ_OK;
+
   std::unique_lock<CCriticalSection> lock(m_section);
 
   int ret = 0;
@@ -174,26 +248,33 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    const bool prio = priority > 0 || !m_prioMessages.empty();
+    std::list<DVDMessageListItem> &msgs = prio ? m_prioMessages : m_messages;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    // the oldest normal message is either in the packet slots or in the list
+    const PacketSlot* slot = prio ? nullptr : m_packets.Front();
+    if (slot && (msgs.empty() || slot->sequence < msgs.back().sequence))
+    {
+      TakePacketSlot(pMsg);
+      priority = 0;
+      ret = MSGQ_OK;
+      break;
+    }
+    else if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
     {
       DVDMessageListItem& item(msgs.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      DemuxPacket* packet = GetDemuxPacket(item.message);
+      if (packet && item.priority == 0)
       {
-        DemuxPacket* packet =
-            std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-        }
+        m_iDataSize -= packet->iSize;
+        UpdateTimeBack(GetPacketTime(packet));
       }
 
       pMsg = std::move(item.message);
       msgs.pop_back();
-      UpdateTimeBack();
+      m_listCount--;
       ret = MSGQ_OK;
       break;
     }
@@ -204,11 +285,22 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
     }
     else
     {
+      m_waiting = true;
       m_hEvent.Reset();
+
+      // a packet may have been put without the lock in the meantime
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!prio && m_packets.Front())
+      {
+        m_waiting = false;
+        continue;
+      }
       lock.unlock();
 
       // wait for a new message
-      if (!m_hEvent.Wait(std::chrono::milliseconds(iTimeoutInMilliSeconds)))
+      const bool signaled = m_hEvent.Wait(std::chrono::milliseconds(iTimeoutInMilliSeconds));
+      m_waiting = false;
+      if (!signaled)
         return MSGQ_TIMEOUT;
 
       lock.lock();
@@ -221,50 +313,49 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
   return (MsgQueueReturnCode)ret;
 }
 
-void CDVDMessageQueue::UpdateTimeFront()
+bool CDVDMessageQueue::GetPacketSlot(std::shared_ptr<CDVDMsg>& pMsg)
 {
-  if (!m_messages.empty())
-  {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
-    {
-      DemuxPacket* packet =
-          std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
+  bool taken = false;
 
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
-    }
+  // Flush empties the slots from another thread, it waits until we are out
+  m_consumerBusy = true;
+  if (!m_flushPending && m_packets.Front() && m_listCount == 0)
+  {
+    TakePacketSlot(pMsg);
+    taken = true;
   }
+  m_consumerBusy = false;
+
+  return taken;
 }
 
-void CDVDMessageQueue::UpdateTimeBack()
+void CDVDMessageQueue::TakePacketSlot(std::shared_ptr<CDVDMsg>& pMsg)
 {
-  if (!m_messages.empty())
-  {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
-    {
-      DemuxPacket* packet =
-          std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
+  PacketSlot slot;
+  m_packets.Pop(slot);
+  m_iDataSize -= slot.size;
+  UpdateTimeBack(slot.time);
+  pMsg = std::move(slot.message);
+}
 
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
-      }
-    }
-  }
+void CDVDMessageQueue::UpdateTimeFront(double time)
+{
+  if (time == DVD_NOPTS_VALUE)
+    return;
+
+  m_TimeFront = time;
+  double none = DVD_NOPTS_VALUE;
+  m_TimeBack.compare_exchange_strong(none, time);
+}
+
+void CDVDMessageQueue::UpdateTimeBack(double time)
+{
+  if (time == DVD_NOPTS_VALUE)
+    return;
+
+  m_TimeBack = time;
+  double none = DVD_NOPTS_VALUE;
+  m_TimeFront.compare_exchange_strong(none, time);
 }
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
@@ -285,6 +376,8 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(item.message->IsType(type))
       count++;
   }
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    count += static_cast<unsigned>(m_packets.GetSize());
 
   return count;
 }
@@ -309,43 +402,41 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
-  std::unique_lock<CCriticalSection> lock(m_section);
-
-  if (m_iDataSize > m_iMaxDataSize)
-    return 100;
-  if (m_iDataSize == 0)
+  const int dataSize = m_iDataSize;
+  if (dataSize <= 0)
     return 0;
+  if (dataSize > m_iMaxDataSize)
+    return 100;
 
-  if (IsDataBased())
-  {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
-  }
+  // byte budget
+  int level = static_cast<int>(100LL * dataSize / m_iMaxDataSize);
 
-  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
+  // time budget, as long as the packets carry timestamps
+  const double front = m_TimeFront;
+  const double back = m_TimeBack;
+  if (back != DVD_NOPTS_VALUE && front != DVD_NOPTS_VALUE && front > back)
+    level = std::max(level, static_cast<int>(ceil(100.0 * (front - back) /
+                                                  (m_maxTimeSize * DVD_TIME_BASE))));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
-  {
-    CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
-    return 1;
-  }
-
-  return level;
+  return std::clamp(level, 1, 100);
 }
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  std::unique_lock<CCriticalSection> lock(m_section);
-
-  if (IsDataBased())
+  const double front = m_TimeFront;
+  const double back = m_TimeBack;
+  if (back == DVD_NOPTS_VALUE || front == DVD_NOPTS_VALUE || front <= back)
     return 0;
   else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+    return (int)((front - back) / DVD_TIME_BASE);
 }
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  const double front = m_TimeFront;
+  const double back = m_TimeBack;
+  return (back == DVD_NOPTS_VALUE  ||
+          front == DVD_NOPTS_VALUE ||
+          front <= back);
 }
@@ -11,15 +11,18 @@
 #include "DVDMessage.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 
 #include <algorithm>
 #include <atomic>
 #include <list>
 #include <string>
+#include <thread>
 
 struct DVDMessageListItem
 {
-  DVDMessageListItem(std::shared_ptr<CDVDMsg> msg, int prio) : message(std::move(msg))
+  DVDMessageListItem(std::shared_ptr<CDVDMsg> msg, int prio, int64_t seq = 0)
+    : message(std::move(msg)), sequence(seq)
   {
     priority = prio;
   }
@@ -31,6 +34,7 @@ struct DVDMessageListItem
 
   std::shared_ptr<CDVDMsg> message;
   int priority;
+  int64_t sequence; // order of normal messages across the list and the packet ring
 };
 
 enum MsgQueueReturnCode
@@ -45,6 +49,18 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/*!
+ * \brief Message queue between the demuxer and a stream player
+ *
+ * Demux packets put by one producer thread go through a ring of preallocated
+ * slots, Put and Get of those do not take the lock of the queue. All other
+ * messages, priority messages, messages put back and packets of other threads
+ * use the locked lists. Normal messages carry a sequence number, so that Get
+ * returns them in the order they were put no matter where they were stored.
+ * Get must only be called from a single consumer thread.
+ *
+ * The level is the larger of the byte budget and the time budget in use.
+ */
 class CDVDMessageQueue
 {
 public:
@@ -73,7 +89,7 @@ public:
     return Get(pMsg, iTimeoutInMilliSeconds, priority);
   }
 
-  int GetDataSize() const { return m_iDataSize; }
+  int GetDataSize() const { return std::max(0, m_iDataSize.load()); }
   int GetTimeSize() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
   bool ReceivedAbortRequest() { return m_bAbortRequest; }
@@ -83,34 +99,64 @@ public:
   bool IsFull() const { return GetLevel() == 100; }
   int GetLevel() const;
 
+  //! byte budget, the queue is full above it
   void SetMaxDataSize(int iMaxDataSize) { m_iMaxDataSize = iMaxDataSize; }
-  void SetMaxTimeSize(double sec) { m_TimeSize  = 1.0 / std::max(1.0, sec); }
+  //! time budget in seconds, used while the packets carry timestamps
+  void SetMaxTimeSize(double sec) { m_maxTimeSize = std::max(1.0, sec); }
   int GetMaxDataSize() const { return m_iMaxDataSize; }
-  double GetMaxTimeSize() const { return m_TimeSize; }
+  double GetMaxTimeSize() const { return m_maxTimeSize; }
   bool IsInited() const { return m_bInitialized; }
   bool IsDataBased() const;
 
+  //! number of preallocated packet slots
+  static constexpr size_t PACKET_SLOTS = 1024;
+
 private:
+  struct PacketSlot
+  {
+    std::shared_ptr<CDVDMsg> message;
+    int64_t sequence = 0;
+    int size = 0;
+    double time = 0.0;
+  };
+
   MsgQueueReturnCode Put(const std::shared_ptr<CDVDMsg>& pMsg, int priority, bool front);
-  void UpdateTimeFront();
-  void UpdateTimeBack();
+  bool PutPacketSlot(const std::shared_ptr<CDVDMsg>& pMsg);
+  bool GetPacketSlot(std::shared_ptr<CDVDMsg>& pMsg);
+  void TakePacketSlot(std::shared_ptr<CDVDMsg>& pMsg);
+  void FlushPacketSlots();
+  void UpdateTimeFront(double time);
+  void UpdateTimeBack(double time);
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest = false;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
-  double m_TimeSize;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
+  double m_maxTimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+  //! messages in both lists, lets Get skip the lock when they are empty
+  std::atomic<size_t> m_listCount{0};
+
+  XbmcThreads::CSPSCQueue<PacketSlot> m_packets{PACKET_SLOTS};
+  //! the only thread allowed to fill the packet slots, claimed by the first packet
+  std::atomic<std::thread::id> m_producer;
+  std::atomic<int64_t> m_sequence{0};
+  int64_t m_backSequence = 0;
+  //! handshake between Flush and the lock-free path of Get
+  std::atomic<bool> m_consumerBusy{false};
+  std::atomic<bool> m_flushPending{false};
+  //! set while Get waits, so that the lock-free path of Put knows to signal
+  std::atomic<bool> m_waiting{false};
 };
 
@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDThumbnailer.h"
+
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDFileInfo.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDStreamInfo.h"
+#include "FileItem.h"
+#include "Process/ProcessInfo.h"
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "URL.h"
+#include "Util.h"
+#include "pictures/Picture.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+namespace
+{
+int DegreeToOrientation(int degrees)
+{
+  switch (degrees)
+  {
+    case 90:
+      return 5;
+    case 180:
+      return 2;
+    case 270:
+      return 7;
+    default:
+      return 0;
+  }
+}
+
+// the largest lowres decoders support, each step halves the size
+constexpr int MAX_LOWRES = 3;
+
+int GetLowres(int width, unsigned int imageRes)
+{
+  int lowres = 0;
+  while (lowres < MAX_LOWRES && width > 0 &&
+         static_cast<unsigned int>(width >> (lowres + 1)) >= imageRes)
+    lowres++;
+  return lowres;
+}
+} // namespace
+
+CDVDThumbnailer::CDVDThumbnailer() = default;
+
+CDVDThumbnailer::~CDVDThumbnailer()
+{
+  Close();
+}
+
+bool CDVDThumbnailer::Open(const CFileItem& fileItem, CStreamDetails* pStreamDetails)
+{
+  Close();
+
+  m_redactPath = CURL::GetRedacted(fileItem.GetPath());
+
+  CFileItem item(fileItem);
+  item.SetMimeTypeForInternetFile();
+  m_inputStream = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!m_inputStream)
+  {
+    CLog::Log(LOGERROR, "InputStream: Error creating stream for {}", m_redactPath);
+    return false;
+  }
+
+  if (!m_inputStream->Open())
+  {
+    CLog::Log(LOGERROR, "InputStream: Error opening, {}", m_redactPath);
+    return false;
+  }
+
+  try
+  {
+    m_demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_inputStream, true));
+    if (!m_demuxer)
+    {
+      CLog::Log(LOGERROR, "{} - Error creating demuxer", __FUNCTION__);
+      return false;
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - Exception thrown when opening demuxer", __FUNCTION__);
+    m_demuxer.reset();
+    return false;
+  }
+
+  if (pStreamDetails)
+  {
+    const std::string& strPath = item.GetPath();
+    CDVDFileInfo::DemuxerToStreamDetails(m_inputStream, m_demuxer.get(), *pStreamDetails, strPath);
+
+    //extern subtitles
+    std::vector<std::string> filenames;
+    std::string video_path;
+    if (strPath.empty())
+      video_path = m_inputStream->GetFileName();
+    else
+      video_path = strPath;
+
+    CUtil::ScanForExternalSubtitles(video_path, filenames);
+
+    for (unsigned int i = 0; i < filenames.size(); i++)
+    {
+      // if vobsub subtitle:
+      if (URIUtils::GetExtension(filenames[i]) == ".idx")
+      {
+        std::string strSubFile;
+        if (CUtil::FindVobSubPair(filenames, filenames[i], strSubFile))
+          CDVDFileInfo::AddExternalSubtitleToDetails(video_path, *pStreamDetails, filenames[i],
+                                                     strSubFile);
+      }
+      else
+      {
+        if (!CUtil::IsVobSub(filenames, filenames[i]))
+          CDVDFileInfo::AddExternalSubtitleToDetails(video_path, *pStreamDetails, filenames[i]);
+      }
+    }
+  }
+
+  int64_t demuxerId = -1;
+  for (CDemuxStream* pStream : m_demuxer->GetStreams())
+  {
+    if (pStream)
+    {
+      // ignore if it's a picture attachment (e.g. jpeg artwork)
+      if (pStream->type == STREAM_VIDEO && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
+      {
+        m_videoStream = pStream->uniqueId;
+        demuxerId = pStream->demuxerId;
+      }
+      else
+        m_demuxer->EnableStream(pStream->demuxerId, pStream->uniqueId, false);
+    }
+  }
+
+  if (m_videoStream == -1)
+    return true;
+
+  m_processInfo.reset(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  m_processInfo->SetPixFormats(pixFmts);
+
+  CDVDStreamInfo hint(*m_demuxer->GetStream(demuxerId, m_videoStream), true);
+  hint.codecOptions = CODEC_FORCE_SOFTWARE;
+
+  // a still image needs neither the frames in between nor full quality filtering
+  CDVDCodecOptions options;
+  options.m_keys.emplace_back("skip_frame", "noref");
+  options.m_keys.emplace_back("skip_loop_filter", "all");
+  const int lowres = GetLowres(
+      hint.width, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+  if (lowres > 0)
+    options.m_keys.emplace_back("lowres", std::to_string(lowres));
+
+  m_videoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *m_processInfo, options);
+  if (!m_videoCodec)
+    m_videoStream = -1;
+
+  m_forcedAspect = hint.forced_aspect ? hint.aspect : 0.0;
+  m_orientation = DegreeToOrientation(hint.orientation);
+  return true;
+}
+
+void CDVDThumbnailer::Close()
+{
+  m_videoCodec.reset();
+  m_processInfo.reset();
+  m_demuxer.reset();
+  m_inputStream.reset();
+  m_videoStream = -1;
+  m_packetsTried = 0;
+  m_codecDirty = false;
+
+  if (m_swsContext)
+  {
+    sws_freeContext(m_swsContext);
+    m_swsContext = nullptr;
+  }
+}
+
+bool CDVDThumbnailer::ExtractThumb(int64_t pos, CTextureDetails& details)
+{
+  if (m_videoStream == -1)
+    return false;
+
+  int nTotalLen = m_demuxer->GetStreamLength();
+  int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+
+  CLog::Log(LOGDEBUG, "{} - seeking to pos {}ms (total: {}ms) in {}", __FUNCTION__, nSeekTo,
+            nTotalLen, m_redactPath);
+
+  if (!m_demuxer->SeekTime(static_cast<double>(nSeekTo), true))
+    return false;
+
+  // drop whatever is left of the last position
+  if (m_codecDirty)
+    m_videoCodec->Reset();
+  m_codecDirty = true;
+
+  VideoPicture picture = {};
+  if (!DecodePicture(picture))
+  {
+    CLog::Log(LOGDEBUG, "{} - decode failed in {} after {} packets.", __FUNCTION__, m_redactPath,
+              m_packetsTried);
+    return false;
+  }
+
+  return CachePicture(picture, details);
+}
+
+bool CDVDThumbnailer::DecodePicture(VideoPicture& picture)
+{
+  CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = m_demuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = m_demuxer->Read();
+    m_packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != m_videoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    m_videoCodec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+    {
+      iDecoderState = m_videoCodec->GetPicture(&picture);
+    }
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+    {
+      if (!(picture.iFlags & DVP_FLAG_DROPPED))
+        break;
+    }
+
+  } while (abort_index--);
+
+  return iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
+bool CDVDThumbnailer::CachePicture(const VideoPicture& picture, CTextureDetails& details)
+{
+  unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if (m_forcedAspect != 0.0)
+    aspect = m_forcedAspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  // the context of the last picture is reused if the geometry is the same
+  m_swsContext = sws_getCachedContext(m_swsContext, picture.iWidth, picture.iHeight,
+                                      AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA,
+                                      SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+  if (!m_swsContext)
+    return false;
+
+  // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
+  int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
+  uint8_t* pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
+  if (!pOutBuf)
+    return false;
+
+  uint8_t* planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  uint8_t* src[4] = {planes[0], planes[1], planes[2], 0};
+  int srcStride[] = {stride[0], stride[1], stride[2], 0};
+  uint8_t* dst[] = {pOutBuf, 0, 0, 0};
+  int dstStride[] = {(int)nWidth * 4, 0, 0, 0};
+  sws_scale(m_swsContext, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+  details.width = nWidth;
+  details.height = nHeight;
+  CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, m_orientation, nWidth, nHeight,
+                         CTextureCache::GetCachedPath(details.file));
+  av_free(pOutBuf);
+  return true;
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+class CDVDDemux;
+class CDVDInputStream;
+class CDVDVideoCodec;
+class CFileItem;
+class CProcessInfo;
+class CStreamDetails;
+class CTextureDetails;
+struct SwsContext;
+struct VideoPicture;
+
+/*!
+ * \brief Extracts thumbnails from one file, at any number of positions
+ *
+ * The input stream, demuxer and decoder are opened once and reused for every
+ * position, the scaler is only set up again when the picture size changes.
+ * Decoding is single threaded and in software, it skips non reference frames
+ * and the loop filter, and uses a reduced resolution where the codec supports
+ * it and the picture is still large enough for the cached image.
+ */
+class CDVDThumbnailer
+{
+public:
+  CDVDThumbnailer();
+  ~CDVDThumbnailer();
+
+  /*!
+   * \brief Open the file and its video stream
+   * \param[out] pStreamDetails filled in from the demuxer and external subtitles, if not null
+   * \return false if the file can't be opened, a file without video opens fine
+   */
+  bool Open(const CFileItem& item, CStreamDetails* pStreamDetails);
+  void Close();
+
+  /*!
+   * \brief Decode the picture at a position and cache it as details.file
+   * \param pos position in ms, -1 for a third of the duration
+   */
+  bool ExtractThumb(int64_t pos, CTextureDetails& details);
+
+  int GetPacketsTried() const { return m_packetsTried; }
+
+private:
+  bool DecodePicture(VideoPicture& picture);
+  bool CachePicture(const VideoPicture& picture, CTextureDetails& details);
+
+  std::string m_redactPath;
+  std::shared_ptr<CDVDInputStream> m_inputStream;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::unique_ptr<CDVDVideoCodec> m_videoCodec;
+  int m_videoStream = -1;
+  double m_forcedAspect = 0.0;
+  int m_orientation = 0;
+  int m_packetsTried = 0;
+  bool m_codecDirty = false; //!< the codec holds frames of the last position
+
+  SwsContext* m_swsContext = nullptr;
+};
@@ -57,13 +57,27 @@ struct DemuxCryptoInfo : DEMUX_CRYPTO_INFO
     cipherBytes = new uint32_t[numSubs];
   };
 
+  //! subsample arrays in memory of the caller, which outlives the info
+  DemuxCryptoInfo(const unsigned int numSubs, uint16_t* clear, uint32_t* cipher)
+    : m_ownsSubSamples(false)
+  {
+    numSubSamples = numSubs;
+    flags = 0;
+    clearBytes = clear;
+    cipherBytes = cipher;
+  }
+
   ~DemuxCryptoInfo()
   {
+    if (!m_ownsSubSamples)
+      return;
     delete[] clearBytes;
     delete[] cipherBytes;
   }
 
 private:
+  bool m_ownsSubSamples = true;
+
   DemuxCryptoInfo(const DemuxCryptoInfo&) = delete;
   DemuxCryptoInfo& operator=(const DemuxCryptoInfo&) = delete;
 };
@@ -14,6 +14,8 @@
 #define DMX_SPECIALID_STREAMINFO DEMUX_SPECIALID_STREAMINFO
 #define DMX_SPECIALID_STREAMCHANGE DEMUX_SPECIALID_STREAMCHANGE
 
+struct AVBufferRef;
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -43,6 +45,9 @@ extern "C"
 
     //! @brief PTS offset correction applied to the PTS and DTS.
     double m_ptsOffsetCorrection{0};
+
+    //! @brief FFmpeg buffer pData points into, nullptr if pData is owned by the packet.
+    AVBufferRef* m_buffer{nullptr};
   };
 
 #ifdef __cplusplus
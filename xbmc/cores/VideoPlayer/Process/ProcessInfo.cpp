@@ -65,6 +65,7 @@ void CProcessInfo::ResetVideoCodecInfo()
 
   m_videoIsHWDecoder = false;
   m_videoDecoderName = "unknown";
+  m_videoDecoderThreading.clear();
   m_videoDeintMethod = "unknown";
   m_videoPixelFormat = "unknown";
   m_videoStereoMode.clear();
@@ -116,6 +117,20 @@ bool CProcessInfo::IsVideoHwDecoder()
   return m_videoIsHWDecoder;
 }
 
+void CProcessInfo::SetVideoDecoderThreading(const std::string& threading)
+{
+  std::unique_lock<CCriticalSection> lock(m_videoCodecSection);
+
+  m_videoDecoderThreading = threading;
+}
+
+std::string CProcessInfo::GetVideoDecoderThreading()
+{
+  std::unique_lock<CCriticalSection> lock(m_videoCodecSection);
+
+  return m_videoDecoderThreading;
+}
+
 void CProcessInfo::SetVideoDeintMethod(const std::string &method)
 {
   std::unique_lock<CCriticalSection> lock(m_videoCodecSection);
@@ -352,6 +367,7 @@ void CProcessInfo::ResetAudioCodecInfo()
     m_dataCache->SetAudioChannels(m_audio2Channels, true);
     m_dataCache->SetAudioSampleRate(m_audio2SampleRate, true);
     m_dataCache->SetAudioBitsPerSample(m_audio2BitsPerSample, true);
+    m_dataCache->ResetAudioDriftHistory();
   }
  }
 }
@@ -496,6 +512,26 @@ int CProcessInfo::GetAudioBitsPerSample(bool bAudio2)
   return m_audioBitsPerSample;
 }
 
+void CProcessInfo::SetAudio2Decoding(bool decoding)
+{
+  std::unique_lock<CCriticalSection> lock(m_audio2CodecSection);
+
+  m_audio2Decoding = decoding;
+}
+
+bool CProcessInfo::GetAudio2Decoding()
+{
+  std::unique_lock<CCriticalSection> lock(m_audio2CodecSection);
+
+  return m_audio2Decoding;
+}
+
+void CProcessInfo::AddAudioDriftSample(const SAudioDriftSample& sample)
+{
+  if (m_dataCache)
+    m_dataCache->AddAudioDriftSample(sample);
+}
+
 bool CProcessInfo::AllowDTSHDDecode()
 {
   return true;
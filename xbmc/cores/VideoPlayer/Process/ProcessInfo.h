@@ -20,6 +20,7 @@
 
 class CProcessInfo;
 class CDataCacheCore;
+struct SAudioDriftSample;
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -36,6 +37,8 @@ public:
   void SetVideoDecoderName(const std::string &name, bool isHw);
   std::string GetVideoDecoderName();
   bool IsVideoHwDecoder();
+  void SetVideoDecoderThreading(const std::string& threading);
+  std::string GetVideoDecoderThreading();
   void SetVideoDeintMethod(const std::string &method);
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(const std::string &pixFormat);
@@ -70,6 +73,9 @@ public:
   int GetAudioSampleRate(bool bAudio2 = false);
   void SetAudioBitsPerSample(int bitsPerSample, bool bAudio2 = false);
   int GetAudioBitsPerSample(bool bAudio2 = false);
+  void SetAudio2Decoding(bool decoding);
+  bool GetAudio2Decoding();
+  void AddAudioDriftSample(const SAudioDriftSample& sample);
   virtual bool AllowDTSHDDecode();
   virtual bool WantsRawPassthrough(bool bAudio2 = false) { return false; }
 
@@ -127,6 +133,7 @@ protected:
   // player video info
   bool m_videoIsHWDecoder;
   std::string m_videoDecoderName;
+  std::string m_videoDecoderThreading;
   std::string m_videoDeintMethod;
   std::string m_videoPixelFormat;
   std::string m_videoStereoMode;
@@ -152,6 +159,7 @@ protected:
   std::string m_audio2Channels;
   int m_audio2SampleRate;
   int m_audio2BitsPerSample;
+  bool m_audio2Decoding = false; // a decoder of its own for the 2nd output
   CCriticalSection m_audio2CodecSection;
 
   // render info
@@ -12,9 +12,11 @@
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxCC.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxPrefetch.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDDemuxers/DemuxPacketPool.h"
 #include "DVDInputStreams/DVDFactoryInputStream.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDMessage.h"
@@ -875,6 +877,7 @@ bool CVideoPlayer::OpenDemuxStream()
 
 void CVideoPlayer::CloseDemuxer()
 {
+  StopDemuxPrefetch();
   m_pDemuxer.reset();
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
 
@@ -883,6 +886,34 @@ void CVideoPlayer::CloseDemuxer()
   CServiceBroker::GetDataCacheCore().SignalSubtitleInfoChange();
 }
 
+void CVideoPlayer::StartDemuxPrefetch()
+{
+  if (m_demuxPrefetch || !m_pDemuxer || !m_pInputStream)
+    return;
+
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDemuxPrefetch)
+    return;
+
+  // menus, live streams and inputstreams that demux talk to the player between reads
+  if (m_pInputStream->IsRealtime() || m_pInputStream->GetIDemux() ||
+      m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER) ||
+      std::dynamic_pointer_cast<CDVDInputStream::IMenus>(m_pInputStream))
+    return;
+
+  m_demuxPrefetch = std::make_unique<CDVDDemuxPrefetch>(*m_pDemuxer, m_demuxSection);
+  m_demuxPrefetch->Start();
+}
+
+void CVideoPlayer::StopDemuxPrefetch()
+{
+  if (!m_demuxPrefetch)
+    return;
+
+  std::unique_lock<CCriticalSection> demuxLock(m_demuxSection);
+  m_demuxPrefetch.reset();
+  CServiceBroker::GetDataCacheCore().SetDemuxPrefetchInfo({});
+}
+
 void CVideoPlayer::OpenDefaultStreams(bool reset)
 {
   // if input stream dictate, we will open later
@@ -1021,6 +1052,7 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
 bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  m_packetOfOldStream = false;
 
   // check if we should read from subtitle demuxer
   if (m_pSubtitleDemuxer && m_VideoPlayerSubtitle->AcceptsData())
@@ -1051,7 +1083,9 @@ bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
   }
 
   // read a data frame from stream.
-  if (m_pDemuxer)
+  if (m_demuxPrefetch)
+    m_demuxPrefetch->Read(packet, m_packetOfOldStream);
+  else if (m_pDemuxer)
     packet = m_pDemuxer->Read();
 
   if (packet)
@@ -1349,6 +1383,8 @@ void CVideoPlayer::Prepare()
     m_clock.Discontinuity(DVD_MSEC_TO_TIME(starttime));
   }
 
+  StartDemuxPrefetch();
+
   UpdatePlayState(0);
 
   SetCaching(CACHESTATE_FLUSH);
@@ -1414,6 +1450,8 @@ void CVideoPlayer::Process()
           !m_SelectionStreams.m_Streams.empty())
         OpenDefaultStreams();
 
+      StartDemuxPrefetch();
+
       UpdatePlayState(0);
     }
 
@@ -1426,6 +1464,17 @@ void CVideoPlayer::Process()
     // make sure we run subtitle process here
     m_VideoPlayerSubtitle->Process(m_clock.GetClock() + m_State.time_offset - m_VideoPlayerVideo->GetSubtitleDelay(), m_State.time_offset);
 
+    // with read-ahead, the demux thread holds the demuxer while it reads. Instead of
+    // waiting for a slow read, go on with messages and state updates.
+    std::unique_lock<CCriticalSection> demuxLock(m_demuxSection, std::defer_lock);
+    if (!m_demuxPrefetch)
+      demuxLock.lock();
+    else if (!demuxLock.try_lock())
+    {
+      m_demuxPrefetch->WaitForPacket(10ms, true);
+      continue;
+    }
+
     // tell demuxer if we want to fill buffers
     if (m_demuxerSpeed != DVD_PLAYSPEED_PAUSE)
     {
@@ -1455,6 +1504,9 @@ void CVideoPlayer::Process()
           m_pDemuxer->SetSpeed(DVD_PLAYSPEED_PAUSE);
         m_demuxerSpeed = DVD_PLAYSPEED_PAUSE;
       }
+      demuxLock.unlock();
+      if (m_demuxPrefetch)
+        m_demuxPrefetch->Wake();
       CThread::Sleep(10ms);
       continue;
     }
@@ -1469,6 +1521,14 @@ void CVideoPlayer::Process()
       m_demuxerSpeed = m_playSpeed;
     }
 
+    // nothing read ahead yet, let the demux thread have the demuxer
+    if (m_demuxPrefetch && !m_demuxPrefetch->HasPacket())
+    {
+      demuxLock.unlock();
+      m_demuxPrefetch->WaitForPacket(10ms, false);
+      continue;
+    }
+
     DemuxPacket* pPacket = NULL;
     CDemuxStream *pStream = NULL;
     ReadPacket(pPacket, pStream);
@@ -1658,6 +1718,10 @@ void CVideoPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 
 void CVideoPlayer::CheckStreamChanges(CCurrentStream& current, CDemuxStream* stream)
 {
+  // read ahead before its stream was replaced, the change comes with the packets after it
+  if (m_packetOfOldStream)
+    return;
+
   if (current.stream  != (void*)stream
   ||  current.changes != stream->changes)
   {
@@ -1807,6 +1871,11 @@ bool CVideoPlayer::GetCachingTimes(double& level, double& delay, double& offset)
   if (!m_pInputStream || !m_pDemuxer)
     return false;
 
+  // the input stream is in a read on the demux thread
+  std::unique_lock<CCriticalSection> demuxLock(m_demuxSection, std::defer_lock);
+  if (m_demuxPrefetch && !demuxLock.try_lock())
+    return false;
+
   XFILE::SCacheStatus status;
   if (!m_pInputStream->GetCacheStatus(&status))
     return false;
@@ -2561,6 +2630,7 @@ void CVideoPlayer::OnExit()
 
   // destroy objects
   m_renderManager.Flush(false, false);
+  StopDemuxPrefetch();
   m_pDemuxer.reset();
   m_pSubtitleDemuxer.reset();
   m_subtitleDemuxerMap.clear();
@@ -2574,6 +2644,12 @@ void CVideoPlayer::OnExit()
 
   m_messenger.End();
 
+  // all packets of this file are gone, keep only what the thread caches hold
+  const CDemuxPacketPool::Stats poolStats = CDemuxPacketPool::GetInstance().GetStats();
+  CLog::Log(LOGDEBUG, "CVideoPlayer::{} - packet pool hit rate: {:.1f}%, retained: {} KiB",
+            __FUNCTION__, poolStats.GetHitRate() * 100.0, poolStats.retainedBytes / 1024);
+  CDemuxPacketPool::GetInstance().Trim();
+
   CFFmpegLog::ClearLogLevel();
   m_bStop = true;
 
@@ -2592,9 +2668,16 @@ void CVideoPlayer::OnExit()
 void CVideoPlayer::HandleMessages()
 {
   std::shared_ptr<CDVDMsg> pMsg = nullptr;
+  std::unique_lock<CCriticalSection> demuxLock(m_demuxSection, std::defer_lock);
 
   while (m_messenger.Get(pMsg, 0) == MSGQ_OK)
   {
+    // sync messages go on during a slow read, everything else may use the demuxer
+    if (!demuxLock.owns_lock() && !pMsg->IsType(CDVDMsg::GENERAL_SYNCHRONIZE) &&
+        !pMsg->IsType(CDVDMsg::PLAYER_STARTED) && !pMsg->IsType(CDVDMsg::PLAYER_REPORT_STATE) &&
+        !pMsg->IsType(CDVDMsg::PLAYER_AVCHANGE) && !pMsg->IsType(CDVDMsg::PLAYER_ABORT))
+      demuxLock.lock();
+
     if (pMsg->IsType(CDVDMsg::PLAYER_OPENFILE) &&
         m_messenger.GetPacketCount(CDVDMsg::PLAYER_OPENFILE) == 0)
     {
@@ -2633,6 +2716,7 @@ void CVideoPlayer::HandleMessages()
 
       FlushBuffers(DVD_NOPTS_VALUE, true, true);
       m_renderManager.Flush(false, false);
+      StopDemuxPrefetch();
       m_pDemuxer.reset();
       m_pSubtitleDemuxer.reset();
       m_subtitleDemuxerMap.clear();
@@ -2781,6 +2865,8 @@ void CVideoPlayer::HandleMessages()
       // we need to reset the demuxer, probably because the streams have changed
       if(m_pDemuxer)
         m_pDemuxer->Reset();
+      if (m_demuxPrefetch)
+        m_demuxPrefetch->Flush();
       if(m_pSubtitleDemuxer)
         m_pSubtitleDemuxer->Reset();
     }
@@ -3928,6 +4014,13 @@ void CVideoPlayer::FlushBuffers(double pts, bool accurate, bool sync)
 {
   CLog::Log(LOGDEBUG, "CVideoPlayer::FlushBuffers - flushing buffers");
 
+  // whatever was read ahead is from before the seek
+  if (m_demuxPrefetch)
+  {
+    std::unique_lock<CCriticalSection> demuxLock(m_demuxSection);
+    m_demuxPrefetch->Flush();
+  }
+
   double startpts;
   if (accurate)
     startpts = pts;
@@ -4750,6 +4843,24 @@ void CVideoPlayer::UpdatePlayState(double timeout)
 
   SPlayerState state(m_State);
 
+  // the demux thread is in a slow read, only the clock moves on
+  std::unique_lock<CCriticalSection> demuxLock(m_demuxSection, std::defer_lock);
+  if (m_demuxPrefetch && !demuxLock.try_lock())
+  {
+    state.time = m_clock.GetClock(false) * 1000 / DVD_TIME_BASE;
+    if (m_Edl.HasCuts())
+      state.time = static_cast<double>(m_Edl.GetTimeWithoutCuts(state.time));
+    state.timestamp = m_clock.GetAbsoluteClock();
+
+    m_processInfo->SetPlayTimes(state.startTime, state.time, state.timeMin, state.timeMax);
+    if (IsCurrentThread())
+      CServiceBroker::GetDataCacheCore().SetDemuxPrefetchInfo(m_demuxPrefetch->GetInfo());
+
+    std::unique_lock<CCriticalSection> lock(m_StateSection);
+    m_State = state;
+    return;
+  }
+
   state.dts = DVD_NOPTS_VALUE;
   if (m_CurrentVideo.dts != DVD_NOPTS_VALUE)
     state.dts = m_CurrentVideo.dts;
@@ -4944,6 +5055,8 @@ void CVideoPlayer::UpdatePlayState(double timeout)
   }
 
   m_processInfo->SetPlayTimes(state.startTime, state.time, state.timeMin, state.timeMax);
+  if (demuxLock.owns_lock())
+    CServiceBroker::GetDataCacheCore().SetDemuxPrefetchInfo(m_demuxPrefetch->GetInfo());
 
   std::unique_lock<CCriticalSection> lock(m_StateSection);
   m_State = state;
@@ -5059,6 +5172,11 @@ bool CVideoPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned int m
   return m_renderManager.RenderCaptureGetPixels(captureId, millis, buffer, size);
 }
 
+bool CVideoPlayer::GetRenderTrace(CVariant& trace) const
+{
+  return m_renderManager.GetRenderTrace(trace);
+}
+
 void CVideoPlayer::VideoParamsChange()
 {
   m_messenger.Put(std::make_shared<CDVDMsg>(CDVDMsg::PLAYER_AVCHANGE));
@@ -97,6 +97,7 @@ class CDemuxStreamVideo;
 class CDemuxStreamAudio;
 class CStreamInfo;
 class CDVDDemuxCC;
+class CDVDDemuxPrefetch;
 class CVideoPlayer;
 
 #define DVDSTATE_NORMAL           0x00000001 // normal dvd state
@@ -344,6 +345,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) override;
   void RenderCaptureRelease(unsigned int captureId) override;
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) override;
+  bool GetRenderTrace(CVariant& trace) const override;
 
   // IDispResource interface
   void OnLostDisplay() override;
@@ -447,6 +449,8 @@ protected:
   bool OpenInputStream();
   bool OpenDemuxStream();
   void CloseDemuxer();
+  void StartDemuxPrefetch();
+  void StopDemuxPrefetch();
   void OpenDefaultStreams(bool reset = true);
 
   void UpdatePlayState(double timeout);
@@ -525,6 +529,13 @@ protected:
   std::unordered_map<int64_t, std::shared_ptr<CDVDDemux>> m_subtitleDemuxerMap;
   std::unique_ptr<CDVDDemuxCC> m_pCCDemuxer;
 
+  // held while m_pDemuxer and m_pInputStream are in use, the demux thread
+  // of m_demuxPrefetch reads with it
+  CCriticalSection m_demuxSection;
+  std::unique_ptr<CDVDDemuxPrefetch> m_demuxPrefetch;
+  //! the packet being processed was read ahead of a change of its stream
+  bool m_packetOfOldStream = false;
+
   CRenderManager m_renderManager;
 
   struct SDVDInfo
@@ -13,12 +13,15 @@
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/DataCacheCore.h"
 #include "cores/VideoPlayer/Interface/DemuxPacket.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cstring>
 #include <mutex>
 
 #ifdef TARGET_RASPBERRY_PI
@@ -54,6 +57,7 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 {
   m_pClock = pClock;
   m_bAudio2 = false;
+  m_bSharedDecode = false;
   m_audioClock = 0;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_stalled = true;
@@ -100,9 +104,15 @@ bool CVideoPlayerAudio::OpenStream(CDVDStreamInfo hints)
   {
     CAEStreamInfo::DataType streamType2 =
         m_audioSink2.GetPassthroughStreamType(hints.codec, hints.samplerate, hints.profile);
-    codec2 = CDVDFactoryCodec::CreateAudioCodec(
-        hints, m_processInfo, allowpassthrough, m_processInfo.AllowDTSHDDecode(), streamType2, m_bAudio2);
-    if( !codec2 )
+    MakeDualCodec(codec, hints, allowpassthrough, streamType, streamType2);
+    if (CanShareDecoder(codec.get(), allowpassthrough, streamType2))
+    {
+      // decode once and feed both sinks
+      CLog::Log(LOGINFO, "Sharing audio decoder between both outputs");
+    }
+    else if (!(codec2 = CDVDFactoryCodec::CreateAudioCodec(hints, m_processInfo, allowpassthrough,
+                                                         m_processInfo.AllowDTSHDDecode(),
+                                                         streamType2, m_bAudio2)))
     {
       CLog::Log(LOGERROR, "Unsupported 2nd audio codec");
       m_audioSink2.Destroy(true);
@@ -126,6 +136,11 @@ void CVideoPlayerAudio::OpenStream(CDVDStreamInfo& hints, std::unique_ptr<CDVDAu
 {
   m_pAudioCodec = std::move(codec);
   m_pAudioCodec2 = std::move(codec2);
+  m_bSharedDecode = m_bAudio2 && !m_pAudioCodec2;
+  UpdateAudio2Decoding();
+  m_driftControl.Reset();
+  m_audio2SyncOffset = DVD_MSEC_TO_TIME(CServiceBroker::GetSettingsComponent()->GetSettings()->GetInt(
+      CSettings::SETTING_AUDIOOUTPUT2_SYNCOFFSET));
 
   m_processInfo.ResetAudioCodecInfo();
 
@@ -220,6 +235,8 @@ void CVideoPlayerAudio::CloseStream(bool bWaitForBuffers)
   }
 
   m_bAudio2 = false;
+  m_bSharedDecode = false;
+  UpdateAudio2Decoding();
 }
 
 void CVideoPlayerAudio::OnStartup()
@@ -242,7 +259,10 @@ void CVideoPlayerAudio::UpdatePlayerInfo()
     s << ", rr:" << std::fixed << std::setprecision(5) << 1.0 / m_audioSink.GetResampleRatio();
 
   if (m_bAudio2)
+  {
     s << ", a1/a2:" << std::fixed << std::setprecision(3) << m_audiodiff;
+    s << ", rr2:" << std::fixed << std::setprecision(5) << 1.0 / m_driftControl.GetRatio();
+  }
 
   SInfo info;
   info.info        = s.str();
@@ -504,7 +524,7 @@ void CVideoPlayerAudio::Process()
         continue;
       }
 
-      if (m_bAudio2)
+      if (m_bAudio2 && m_pAudioCodec2)
         m_pAudioCodec2->AddData(*pPacket);
 
       m_audioStats.AddSampleBytes(pPacket->iSize);
@@ -524,6 +544,21 @@ void CVideoPlayerAudio::Process()
 
 bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudioFrame &audioframe2)
 {
+  // a switch can free the codec either frame points into, a replaced 2nd codec
+  // does not show in the result
+  auto switchCodec = [this, &audioframe, &audioframe2]() {
+    const CDVDAudioCodec* codec2 = GetAudioCodec2();
+    const bool switched = SwitchCodecIfNeeded();
+    if (switched || GetAudioCodec2() != codec2)
+    {
+      audioframe2.nb_frames = 0;
+      audioframe2.framesOut = 0;
+    }
+    if (switched)
+      audioframe.nb_frames = 0;
+    return switched;
+  };
+
   if (audioframe.nb_frames <= audioframe.framesOut)
   {
     audioframe.hasDownmix = false;
@@ -532,7 +567,7 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudio
 
     if (audioframe.nb_frames == 0)
     {
-      if(m_bAudio2)
+      if (m_bAudio2 && GetAudioCodec2())
         return ProcessDecoderOutput2(audioframe2);
       return false;
     }
@@ -554,11 +589,8 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudio
       // for this stream. See if we should enable/disable passthrough due
       // to it.
       m_streaminfo.samplerate = audioframe.format.m_sampleRate;
-      if (SwitchCodecIfNeeded())
-      {
-        audioframe.nb_frames = 0;
+      if (switchCodec())
         return false;
-      }
     }
 
     // if stream switches to realtime, disable pass through
@@ -566,28 +598,39 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudio
     if (m_processInfo.IsRealtimeStream() && m_synctype != SYNC_RESAMPLE)
     {
       m_synctype = SYNC_RESAMPLE;
-      if (SwitchCodecIfNeeded())
-      {
-        audioframe.nb_frames = 0;
+      if (switchCodec())
         return false;
-      }
     }
 
     // Display reset event has occurred
     // See if we should enable passthrough
     if (m_displayReset)
     {
-      if (SwitchCodecIfNeeded())
-      {
-        audioframe.nb_frames = 0;
+      if (switchCodec())
         return false;
-      }
     }
 
     // demuxer reads metatags that influence channel layout
     if (m_streaminfo.codec == AV_CODEC_ID_FLAC && m_streaminfo.channellayout)
       audioframe.format.m_channelLayout = CAEUtil::GetAEChannelLayout(m_streaminfo.channellayout);
 
+    // the 2nd output gets a copy of the planes, the sinks take them at their own pace
+    // and the next GetData reuses the frame of the codec
+    if (m_bSharedDecode && !GetAudioCodec2())
+    {
+      audioframe2 = audioframe;
+      audioframe2.framesOut = 0;
+      const size_t planeSize = static_cast<size_t>(audioframe.nb_frames) * audioframe.framesize /
+                               std::max(audioframe.planes, 1u);
+      m_audio2Planes.resize(planeSize * audioframe.planes);
+      for (unsigned int i = 0; i < audioframe.planes; i++)
+      {
+        audioframe2.data[i] = m_audio2Planes.data() + i * planeSize;
+        memcpy(audioframe2.data[i], audioframe.data[i], planeSize);
+      }
+      SetupAudioSink2(audioframe2);
+    }
+
     // we have successfully decoded an audio frame, setup renderer to match
     if (!m_audioSink.IsValidFormat(audioframe))
     {
@@ -684,7 +727,8 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudio
         m_processInfo.SetAudioChannels(audioframe2.format.m_channelLayout, true);
         m_processInfo.SetAudioSampleRate(audioframe2.format.m_sampleRate, true);
         m_processInfo.SetAudioBitsPerSample(audioframe2.bits_per_sample, true);
-        m_processInfo.SetAudioDecoderName(m_pAudioCodec2->GetName(), true);
+        m_processInfo.SetAudioDecoderName(
+            GetAudioCodec2() ? GetAudioCodec2()->GetName() : m_pAudioCodec->GetName(), true);
       }
       m_messageParent.Put(std::make_shared<CDVDMsg>(CDVDMsg::PLAYER_AVCHANGE));
     }
@@ -697,9 +741,14 @@ bool CVideoPlayerAudio::ProcessDecoderOutput2(DVDAudioFrame &audioframe2)
 {
   if (audioframe2.nb_frames <= audioframe2.framesOut)
   {
+    // in shared decode mode frames are handed over by ProcessDecoderOutput
+    CDVDAudioCodec* codec2 = GetAudioCodec2();
+    if (!codec2)
+      return false;
+
     audioframe2.hasDownmix = false;
 
-    m_pAudioCodec2->GetData(audioframe2);
+    codec2->GetData(audioframe2);
 
     if (audioframe2.nb_frames == 0)
     {
@@ -717,29 +766,7 @@ bool CVideoPlayerAudio::ProcessDecoderOutput2(DVDAudioFrame &audioframe2)
     if (m_streaminfo.codec == AV_CODEC_ID_FLAC && m_streaminfo.channellayout)
       audioframe2.format.m_channelLayout = CAEUtil::GetAEChannelLayout(m_streaminfo.channellayout);
 
-    // we have successfully decoded an audio frame, setup renderer to match
-    if (!m_audioSink2.IsValidFormat(audioframe2))
-    {
-      if (m_speed)
-        m_audioSink2.Drain();
-
-      m_audioSink2.Destroy(false);
-
-      if (!m_audioSink2.Create(audioframe2, m_streaminfo.codec, m_synctype == SYNC_RESAMPLE))
-        CLog::Log(LOGERROR, "{} - failed to create 2nd audio renderer", __FUNCTION__);
-
-      if (m_syncState == IDVDStreamPlayer::SYNC_INSYNC)
-        m_audioSink2.Resume();
-    }
-
-    m_audioSink2.SetDynamicRangeCompression(
-        static_cast<long>(m_processInfo.GetVideoSettings().m_VolumeAmplification * 100));
-
-    // downmix
-    double clev = audioframe2.hasDownmix ? audioframe2.centerMixLevel : M_SQRT1_2;
-    double curDB = 20 * log10(clev);
-    audioframe2.centerMixLevel = pow(10, (curDB + m_processInfo.GetVideoSettings().m_CenterMixLevel) / 20);
-    audioframe2.hasDownmix = true;
+    SetupAudioSink2(audioframe2);
   }
 
   bool bAudio2Dumb = CServiceBroker::GetActiveAE(true)->IsDumb();
@@ -747,7 +774,12 @@ bool CVideoPlayerAudio::ProcessDecoderOutput2(DVDAudioFrame &audioframe2)
 
   if(!bAudio2Disabled && !bAudio2Dumb && audioframe2.nb_frames > 0)
   {
-    int framesOutput = m_audioSink2.AddPackets(audioframe2);
+    // the engine syncs the 2nd output to the shifted timestamps
+    DVDAudioFrame shifted = audioframe2;
+    if (shifted.pts != DVD_NOPTS_VALUE)
+      shifted.pts += m_audio2SyncOffset;
+
+    int framesOutput = m_audioSink2.AddPackets(shifted);
     audioframe2.framesOut += framesOutput;
 	if(framesOutput == 0) audioframe2.framesOut = audioframe2.nb_frames;
   }
@@ -760,11 +792,98 @@ bool CVideoPlayerAudio::ProcessDecoderOutput2(DVDAudioFrame &audioframe2)
   	return false;
   }
 
+  // pass-through can't be resampled, the engine corrects by skipping and padding
+  if (!audioframe2.passthrough &&
+      m_driftControl.Update(m_audioSink.GetSyncInfo(), m_audioSink2.GetSyncInfo()))
+  {
+    m_audioSink2.SetResampleRatio(m_driftControl.GetRatio());
+    m_processInfo.AddAudioDriftSample(
+        {m_driftControl.GetError(), m_driftControl.GetRatio(), m_driftControl.GetCorrection()});
+  }
+
   m_audiodiff = (m_audioSink.GetDelay() - m_audioSink2.GetDelay()) / DVD_TIME_BASE;
 
   return true;
 }
 
+void CVideoPlayerAudio::SetupAudioSink2(DVDAudioFrame &audioframe2)
+{
+  // we have successfully decoded an audio frame, setup renderer to match
+  if (!m_audioSink2.IsValidFormat(audioframe2))
+  {
+    if (m_speed)
+      m_audioSink2.Drain();
+
+    m_audioSink2.Destroy(false);
+
+    // always resample pcm, the drift control steers the ratio of the 2nd output
+    if (!m_audioSink2.Create(audioframe2, m_streaminfo.codec, true))
+      CLog::Log(LOGERROR, "{} - failed to create 2nd audio renderer", __FUNCTION__);
+    else if (!audioframe2.passthrough)
+      m_audioSink2.SetResampleMode(2);
+
+    m_driftControl.Reset();
+
+    if (m_syncState == IDVDStreamPlayer::SYNC_INSYNC)
+      m_audioSink2.Resume();
+  }
+
+  m_audioSink2.SetDynamicRangeCompression(
+      static_cast<long>(m_processInfo.GetVideoSettings().m_VolumeAmplification * 100));
+
+  // downmix
+  double clev = audioframe2.hasDownmix ? audioframe2.centerMixLevel : M_SQRT1_2;
+  double curDB = 20 * log10(clev);
+  audioframe2.centerMixLevel = pow(10, (curDB + m_processInfo.GetVideoSettings().m_CenterMixLevel) / 20);
+  audioframe2.hasDownmix = true;
+}
+
+bool CVideoPlayerAudio::CanShareDecoder(CDVDAudioCodec* codec,
+                                        bool allowpassthrough,
+                                        CAEStreamInfo::DataType streamType2) const
+{
+  if (!codec)
+    return false;
+
+  // 2nd output would go passthrough, it needs its own codec
+  if (allowpassthrough && streamType2 != CAEStreamInfo::STREAM_TYPE_NULL)
+    return false;
+
+  if (codec->GetSecondaryOutput())
+    return true;
+
+  return !codec->NeedPassthrough() && codec->CanShareOutput();
+}
+
+void CVideoPlayerAudio::MakeDualCodec(std::unique_ptr<CDVDAudioCodec>& codec,
+                                      CDVDStreamInfo& hints,
+                                      bool allowpassthrough,
+                                      CAEStreamInfo::DataType streamType,
+                                      CAEStreamInfo::DataType streamType2)
+{
+  if (!codec || !codec->NeedPassthrough() || codec->GetSecondaryOutput())
+    return;
+
+  if (allowpassthrough && streamType2 != CAEStreamInfo::STREAM_TYPE_NULL)
+    return;
+
+  // passthrough on the 1st output and pcm on the 2nd one, let a single codec
+  // take the packets for both
+  std::unique_ptr<CDVDAudioCodec> dual = CDVDFactoryCodec::CreateAudioCodecDual(
+      hints, m_processInfo, m_processInfo.AllowDTSHDDecode(), streamType);
+  if (dual)
+    codec = std::move(dual);
+}
+
+CDVDAudioCodec* CVideoPlayerAudio::GetAudioCodec2() const
+{
+  if (m_pAudioCodec2)
+    return m_pAudioCodec2.get();
+  if (m_bSharedDecode && m_pAudioCodec)
+    return m_pAudioCodec->GetSecondaryOutput();
+  return nullptr;
+}
+
 void CVideoPlayerAudio::SetSyncType(bool passthrough)
 {
   if (passthrough && m_synctype == SYNC_RESAMPLE)
@@ -843,6 +962,14 @@ bool CVideoPlayerAudio::SwitchCodecIfNeeded()
   std::unique_ptr<CDVDAudioCodec> codec = CDVDFactoryCodec::CreateAudioCodec(
       m_streaminfo, m_processInfo, allowpassthrough, m_processInfo.AllowDTSHDDecode(), streamType);
 
+  CAEStreamInfo::DataType streamType2 = CAEStreamInfo::STREAM_TYPE_NULL;
+  if (m_bAudio2)
+  {
+    streamType2 = m_audioSink2.GetPassthroughStreamType(
+        m_streaminfo.codec, m_streaminfo.samplerate, m_streaminfo.profile);
+    MakeDualCodec(codec, m_streaminfo, allowpassthrough, streamType, streamType2);
+  }
+
   if (!codec || codec->NeedPassthrough() == m_pAudioCodec->NeedPassthrough())
   {
     // passthrough state has not changed
@@ -854,21 +981,49 @@ bool CVideoPlayerAudio::SwitchCodecIfNeeded()
 
   if (m_bAudio2)
   {
-    CAEStreamInfo::DataType streamType2 = m_audioSink2.GetPassthroughStreamType(
-        m_streaminfo.codec, m_streaminfo.samplerate, m_streaminfo.profile);
-    std::unique_ptr<CDVDAudioCodec> codec2 = CDVDFactoryCodec::CreateAudioCodec(
-        m_streaminfo, m_processInfo, allowpassthrough, m_processInfo.AllowDTSHDDecode(), streamType2, true);
-    if (!codec2 || codec2->NeedPassthrough() == m_pAudioCodec2->NeedPassthrough())
+    if (CanShareDecoder(m_pAudioCodec.get(), allowpassthrough, streamType2))
     {
-      // passthrough state has not changed
-    } else {
-      m_pAudioCodec2 = std::move(codec2);
+      if (m_pAudioCodec2)
+      {
+        CLog::Log(LOGINFO, "CVideoPlayerAudio: sharing audio decoder between both outputs");
+        m_pAudioCodec2->Dispose();
+        m_pAudioCodec2.reset();
+      }
+      m_bSharedDecode = true;
+    }
+    else
+    {
+      std::unique_ptr<CDVDAudioCodec> codec2 = CDVDFactoryCodec::CreateAudioCodec(
+          m_streaminfo, m_processInfo, allowpassthrough, m_processInfo.AllowDTSHDDecode(), streamType2, true);
+      if (!codec2 && !m_pAudioCodec2)
+      {
+        CLog::Log(LOGERROR, "CVideoPlayerAudio: unsupported 2nd audio codec");
+        m_audioSink2.Destroy(true);
+        m_bAudio2 = false;
+        m_bSharedDecode = false;
+      }
+      else if (!codec2 || (m_pAudioCodec2 && codec2->NeedPassthrough() == m_pAudioCodec2->NeedPassthrough()))
+      {
+        // passthrough state has not changed
+      } else {
+        m_pAudioCodec2 = std::move(codec2);
+        m_bSharedDecode = false;
+      }
     }
   }
+  UpdateAudio2Decoding();
 
   return bSwitched;
 }
 
+void CVideoPlayerAudio::UpdateAudio2Decoding()
+{
+  // a 2nd codec decoding pcm, or the pcm decoder a dual codec runs next to passthrough
+  const bool ownCodec = m_pAudioCodec2 && !m_pAudioCodec2->NeedPassthrough();
+  const bool dualCodec = m_pAudioCodec && m_pAudioCodec->GetSecondaryOutput();
+  m_processInfo.SetAudio2Decoding(m_bAudio2 && (ownCodec || dualCodec));
+}
+
 std::string CVideoPlayerAudio::GetPlayerInfo()
 {
   std::unique_lock<CCriticalSection> lock(m_info_section);
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "AudioDriftControl.h"
 #include "AudioSinkAE.h"
 #include "DVDClock.h"
 #include "DVDMessageQueue.h"
@@ -21,6 +22,7 @@
 #include <list>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 
 class CVideoPlayer;
@@ -73,6 +75,20 @@ protected:
 
   bool ProcessDecoderOutput(DVDAudioFrame &audioframe, DVDAudioFrame &audioframe2);
   bool ProcessDecoderOutput2(DVDAudioFrame &audioframe2);
+  void SetupAudioSink2(DVDAudioFrame &audioframe2);
+  //! Returns true if the 2nd output can be fed from the frames of codec,
+  //! in which case no 2nd decoder instance is created.
+  bool CanShareDecoder(CDVDAudioCodec* codec, bool allowpassthrough, CAEStreamInfo::DataType streamType2) const;
+  //! Replaces a passthrough codec by one that also decodes for the 2nd output
+  //! if the 2nd output wants pcm.
+  void MakeDualCodec(std::unique_ptr<CDVDAudioCodec>& codec, CDVDStreamInfo& hints, bool allowpassthrough,
+                     CAEStreamInfo::DataType streamType, CAEStreamInfo::DataType streamType2);
+  //! Codec delivering the frames of the 2nd output, nullptr if frames of
+  //! m_pAudioCodec are used directly.
+  CDVDAudioCodec* GetAudioCodec2() const;
+  //! Tells the video decoder whether the 2nd output has a pcm decoder of its
+  //! own, a 2nd codec or the one inside a dual codec, which then wants a core.
+  void UpdateAudio2Decoding();
   void UpdatePlayerInfo();
   void OpenStream(CDVDStreamInfo& hints, std::unique_ptr<CDVDAudioCodec> codec, std::unique_ptr<CDVDAudioCodec> codec2);
   //! Switch codec if needed. Called when the sample rate gotten from the
@@ -124,6 +140,10 @@ protected:
   bool m_disconLearning = false;
 
   bool   m_bAudio2;
+  bool   m_bSharedDecode; // 2nd output is fed from m_pAudioCodec
   double m_audiodiff;
+  CAudioDriftControl m_driftControl; // keeps the 2nd output locked to the 1st one
+  double m_audio2SyncOffset = 0.0; // delay of the 2nd output relative to the 1st one
+  std::vector<uint8_t> m_audio2Planes; // the 2nd output's copy of a frame of a shared decoder
 };
 
@@ -948,6 +948,10 @@ std::string CVideoPlayerVideo::GetPlayerInfo()
   s << ", drop:" << m_iDroppedFrames;
   s << ", skip:" << m_renderManager.GetSkippedFrames();
 
+  const std::string threading = m_processInfo.GetVideoDecoderThreading();
+  if (!threading.empty())
+    s << ", th:" << threading;
+
   int pc = m_ptsTracker.GetPatternLength();
   if (pc > 0)
     s << ", pc:" << pc;
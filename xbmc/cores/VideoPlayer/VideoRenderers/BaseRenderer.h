@@ -55,6 +55,13 @@ public:
   virtual bool Configure(const VideoPicture &picture, float fps, unsigned int orientation) = 0;
   virtual bool IsConfigured() = 0;
   virtual void AddVideoPicture(const VideoPicture &picture, int index) = 0;
+  /*!
+   * \brief Called after AddVideoPicture, before the buffer is queued for rendering
+   *
+   * The render thread is not held up meanwhile, it is the place for work that takes
+   * long, e.g. copying the picture for the upload.
+   */
+  virtual void PrepareVideoPicture(const VideoPicture& picture, int index) {}
   virtual bool IsPictureHW(const VideoPicture& picture) { return false; }
   virtual void UnInit() = 0;
   virtual bool Flush(bool saveBuffers) { return false; }
@@ -94,6 +94,8 @@ void CDebugRenderer::SetInfo(DEBUG_INFO_VIDEO& video, DEBUG_INFO_RENDER& render)
   m_adapter->AddSubtitle(video.metaPrim, 0., 5000000.);
   m_adapter->AddSubtitle(video.metaLight, 0., 5000000.);
   m_adapter->AddSubtitle(video.shader, 0., 5000000.);
+  if (!video.upload.empty())
+    m_adapter->AddSubtitle(video.upload, 0., 5000000.);
   m_adapter->AddSubtitle(render.renderFlags, 0., 5000000.);
   m_adapter->AddSubtitle(render.videoOutput, 0., 5000000.);
 }
@@ -29,10 +29,12 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/GLUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 #include "windowing/WinSystem.h"
 
+#include <algorithm>
 #include <locale.h>
 #include <mutex>
 
@@ -48,8 +50,12 @@
 //! is a multiple of 128 and deinterlacing is on
 #define PBO_OFFSET 16
 
+//! alignment of the planes in the upload ring, the ring starts at this offset too
+#define RING_ALIGNMENT 64
+
 using namespace Shaders;
 using namespace Shaders::GL;
+using namespace std::chrono_literals;
 
 static const GLubyte stipple_weave[] = {
   0x00, 0x00, 0x00, 0x00,
@@ -175,6 +181,7 @@ bool CLinuxRendererGL::ValidateRenderTarget()
     {
       DeleteTexture(i);
     }
+    DeleteUploadRing();
 
     // trigger update of video filters
     m_scalingMethodGui = (ESCALINGMETHOD)-1;
@@ -231,6 +238,10 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
   m_pixelRatio = 1.0;
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
+#if defined(GL_MAP_PERSISTENT_BIT)
+  m_streamingSupported =
+      m_pboSupported && CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage");
+#endif
 
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
@@ -283,6 +294,35 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.lightMetadata = picture.lightMetadata;
   if (picture.hasLightMetadata && picture.lightMetadata.MaxCLL)
     buf.hasLightMetadata = picture.hasLightMetadata;
+
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+  buf.copied = false;
+}
+
+void CLinuxRendererGL::PrepareVideoPicture(const VideoPicture& picture, int index)
+{
+  CPictureBuffer& buf = m_buffers[index];
+
+  // copy the picture to its slot of the upload ring right here, the render
+  // thread only has to start the upload then
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+  if (!buf.videoBuffer || buf.copied || !buf.streaming ||
+      picture.videoBuffer->GetFormat() != m_format ||
+      static_cast<unsigned int>(picture.iWidth) != buf.image.width ||
+      static_cast<unsigned int>(picture.iHeight) != buf.image.height)
+    return;
+
+  YuvImage dst = GetUploadSlotImage(buf);
+  buf.copying = true;
+  lock.unlock();
+
+  CopyVideoBuffer(dst, buf.videoBuffer);
+
+  lock.lock();
+  buf.copying = false;
+  buf.copied = true;
+  m_uploadStats.ringCopies++;
+  m_uploadEvent.Set();
 }
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
@@ -293,6 +333,54 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
     buf.videoBuffer->Release();
     buf.videoBuffer = nullptr;
   }
+
+  // the slot is written again by the next picture added to this buffer
+  if (buf.uploadFence)
+  {
+    glClientWaitSync(buf.uploadFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+    glDeleteSync(buf.uploadFence);
+    buf.uploadFence = nullptr;
+  }
+}
+
+bool CLinuxRendererGL::NeedBuffer(int idx)
+{
+  CPictureBuffer& buf = m_buffers[idx];
+  if (!buf.uploadFence)
+    return false;
+
+  GLint state;
+  GLsizei length;
+  glGetSynciv(buf.uploadFence, GL_SYNC_STATUS, 1, &length, &state);
+  if (state != GL_SIGNALED)
+    return true;
+
+  glDeleteSync(buf.uploadFence);
+  buf.uploadFence = nullptr;
+  return false;
+}
+
+DEBUG_INFO_VIDEO CLinuxRendererGL::GetDebugInfo(int idx)
+{
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+
+  // averaged over about a second
+  const auto now = std::chrono::steady_clock::now();
+  if (m_uploadInfo.empty() || now - m_uploadStats.start >= std::chrono::seconds(1))
+  {
+    const char* mode = m_streamingUsed ? "streaming" : m_pboUsed ? "pbo" : "direct";
+    const unsigned int uploads = std::max(m_uploadStats.uploads, 1u);
+    m_uploadInfo = StringUtils::Format(
+        "Upload: {}, avg: {:.2f} ms, max: {:.2f} ms, copied ahead: {}%", mode,
+        m_uploadStats.total.count() / uploads, m_uploadStats.peak.count(),
+        std::min(m_uploadStats.ringCopies, uploads) * 100 / uploads);
+    m_uploadStats = {};
+    m_uploadStats.start = now;
+  }
+
+  DEBUG_INFO_VIDEO info;
+  info.upload = m_uploadInfo;
+  return info;
 }
 
 void CLinuxRendererGL::GetPlaneTextureSize(CYuvPlane& plane)
@@ -438,6 +526,7 @@ bool CLinuxRendererGL::Flush(bool saveBuffers)
       ReleaseBuffer(i);
     DeleteTexture(i);
   }
+  DeleteUploadRing();
 
   delete m_pYUVShader;
   m_pYUVShader = nullptr;
@@ -960,6 +1049,10 @@ void CLinuxRendererGL::LoadShaders(int field)
   }
   else
     m_pboUsed = false;
+
+  m_streamingUsed = m_pboUsed && m_streamingSupported;
+  if (m_streamingUsed)
+    CLog::Log(LOGINFO, "GL: Using GL_ARB_buffer_storage for streaming upload");
 }
 
 void CLinuxRendererGL::UnInit()
@@ -975,6 +1068,7 @@ void CLinuxRendererGL::UnInit()
     ReleaseBuffer(i);
     DeleteTexture(i);
   }
+  DeleteUploadRing();
 
   DeleteCLUT();
 
@@ -1760,44 +1854,75 @@ void CLinuxRendererGL::DeleteTexture(int index)
     DeleteYV12Texture(index);
 }
 
+void CLinuxRendererGL::CopyVideoBuffer(YuvImage& dst, CVideoBuffer* videoBuffer)
+{
+  YuvImage src;
+  videoBuffer->GetPlanes(src.plane);
+  videoBuffer->GetStrides(src.stride);
+
+  if (m_format == AV_PIX_FMT_NV12)
+    CVideoBuffer::CopyNV12Picture(&dst, &src);
+  else if (m_format == AV_PIX_FMT_YUYV422 ||
+           m_format == AV_PIX_FMT_UYVY422)
+    CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+  else
+    CVideoBuffer::CopyPicture(&dst, &src);
+}
+
 bool CLinuxRendererGL::UploadTexture(int index)
 {
-  if (!m_buffers[index].videoBuffer)
+  CPictureBuffer& buf = m_buffers[index];
+  if (!buf.videoBuffer)
     return false;
 
   bool ret = true;
 
-  if (!m_buffers[index].loaded)
+  if (!buf.loaded)
   {
-    YuvImage &dst = m_buffers[index].image;
-    YuvImage src;
-    m_buffers[index].videoBuffer->GetPlanes(src.plane);
-    m_buffers[index].videoBuffer->GetStrides(src.stride);
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<CCriticalSection> lock(m_uploadSection);
 
-    UnBindPbo(m_buffers[index]);
+    if (buf.streaming)
+    {
+      // not copied ahead, the textures were recreated in between
+      if (!buf.copied)
+      {
+        YuvImage dst = GetUploadSlotImage(buf);
+        CopyVideoBuffer(dst, buf.videoBuffer);
+        buf.copied = true;
+      }
+    }
+    else
+    {
+      UnBindPbo(buf);
+      CopyVideoBuffer(buf.image, buf.videoBuffer);
+      BindPbo(buf);
+    }
 
     if (m_format == AV_PIX_FMT_NV12)
-    {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
-    }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
-    {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
-    }
     else
-    {
-      CVideoBuffer::CopyPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
+
+    // the slot must not be written before the upload has read it
+    if (buf.streaming)
+    {
+      if (buf.uploadFence)
+        glDeleteSync(buf.uploadFence);
+      buf.uploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     }
 
     if (ret)
-      m_buffers[index].loaded = true;
+      buf.loaded = true;
+
+    const std::chrono::duration<double, std::milli> duration =
+        std::chrono::steady_clock::now() - start;
+    m_uploadStats.total += duration;
+    m_uploadStats.peak = std::max(m_uploadStats.peak, duration);
+    m_uploadStats.uploads++;
   }
 
   if (ret)
@@ -1860,7 +1985,10 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
   im.planesize[2] = im.stride[2] * (im.height >> im.cshift_y);
 
   bool pboSetup = false;
-  if (m_pboUsed)
+  if (m_streamingUsed)
+    pboSetup = SetupUploadSlot(index);
+
+  if (!pboSetup && m_pboUsed)
   {
     pboSetup = true;
     glGenBuffers(3, pbo);
@@ -1912,7 +2040,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
         glGenTextures(1, &m_buffers[index].fields[f][p].id);
         VerifyGLState();
       }
-      m_buffers[index].fields[f][p].pbo = pbo[p];
+      m_buffers[index].fields[f][p].pbo = buf.streaming ? m_uploadRing.pbo : pbo[p];
     }
   }
 
@@ -2033,6 +2161,8 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
   YuvImage &im = m_buffers[index].image;
   GLuint *pbo = m_buffers[index].pbo;
 
+  ReleaseUploadSlot(index);
+
   if (m_buffers[index].fields[FIELD_FULL][0].id == 0)
     return;
 
@@ -2166,7 +2296,10 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
   im.planesize[2] = 0;
 
   bool pboSetup = false;
-  if (m_pboUsed)
+  if (m_streamingUsed)
+    pboSetup = SetupUploadSlot(index);
+
+  if (!pboSetup && m_pboUsed)
   {
     pboSetup = true;
     glGenBuffers(2, pbo);
@@ -2218,7 +2351,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
         glGenTextures(1, &buf.fields[f][p].id);
         VerifyGLState();
       }
-      buf.fields[f][p].pbo = pbo[p];
+      buf.fields[f][p].pbo = buf.streaming ? m_uploadRing.pbo : pbo[p];
     }
     buf.fields[f][2].id = buf.fields[f][1].id;
   }
@@ -2272,6 +2405,8 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
   YuvImage &im = buf.image;
   GLuint *pbo = buf.pbo;
 
+  ReleaseUploadSlot(index);
+
   if (buf.fields[FIELD_FULL][0].id == 0)
     return;
 
@@ -2362,6 +2497,8 @@ void CLinuxRendererGL::DeleteYUV422PackedTexture(int index)
   YuvImage &im = buf.image;
   GLuint *pbo = buf.pbo;
 
+  ReleaseUploadSlot(index);
+
   if (buf.fields[FIELD_FULL][0].id == 0)
     return;
 
@@ -2434,7 +2571,10 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
   im.planesize[2] = 0;
 
   bool pboSetup = false;
-  if (m_pboUsed)
+  if (m_streamingUsed)
+    pboSetup = SetupUploadSlot(index);
+
+  if (!pboSetup && m_pboUsed)
   {
     pboSetup = true;
     glGenBuffers(1, pbo);
@@ -2476,7 +2616,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
       glGenTextures(1, &buf.fields[f][0].id);
       VerifyGLState();
     }
-    buf.fields[f][0].pbo = pbo[0];
+    buf.fields[f][0].pbo = buf.streaming ? m_uploadRing.pbo : pbo[0];
     buf.fields[f][1].id = buf.fields[f][0].id;
     buf.fields[f][2].id = buf.fields[f][1].id;
   }
@@ -2641,6 +2781,129 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
+bool CLinuxRendererGL::CreateUploadRing(size_t slotSize)
+{
+#if defined(GL_MAP_PERSISTENT_BIT)
+  const int slots = std::max(m_NumYV12Buffers, 1);
+  const size_t size = RING_ALIGNMENT + slots * slotSize;
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  glGenBuffers(1, &m_uploadRing.pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadRing.pbo);
+  glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+  void* data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  if (!data)
+  {
+    CLog::Log(LOGWARNING, "GL: failed to map upload ring, using pixel buffer objects");
+    glDeleteBuffers(1, &m_uploadRing.pbo);
+    m_uploadRing = {};
+    m_streamingUsed = false;
+    return false;
+  }
+
+  m_uploadRing.data = static_cast<uint8_t*>(data);
+  m_uploadRing.slotSize = slotSize;
+  m_uploadRing.slots = slots;
+  CLog::Log(LOGDEBUG, "GL: upload ring with {} slots of {} bytes", slots, slotSize);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CLinuxRendererGL::DeleteUploadRing()
+{
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+
+  while (std::any_of(std::begin(m_buffers), std::end(m_buffers),
+                     [](const CPictureBuffer& buf) { return buf.copying; }))
+  {
+    lock.unlock();
+    m_uploadEvent.Wait(10ms);
+    lock.lock();
+  }
+
+  if (m_uploadRing.pbo)
+  {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadRing.pbo);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &m_uploadRing.pbo);
+  }
+  m_uploadRing = {};
+}
+
+bool CLinuxRendererGL::SetupUploadSlot(int index)
+{
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+  CPictureBuffer& buf = m_buffers[index];
+  YuvImage& im = buf.image;
+
+  size_t slotSize = 0;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+    slotSize += (im.planesize[p] + RING_ALIGNMENT - 1) / RING_ALIGNMENT * RING_ALIGNMENT;
+
+  if (!m_uploadRing.pbo && !CreateUploadRing(slotSize))
+    return false;
+
+  if (index >= m_uploadRing.slots || slotSize > m_uploadRing.slotSize)
+    return false;
+
+  // the planes hold offsets into the ring, like those of mapped pbos do
+  const size_t slot = RING_ALIGNMENT + index * m_uploadRing.slotSize;
+  size_t offset = slot;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+  {
+    im.plane[p] = im.planesize[p] ? reinterpret_cast<uint8_t*>(offset) : nullptr;
+    offset += (im.planesize[p] + RING_ALIGNMENT - 1) / RING_ALIGNMENT * RING_ALIGNMENT;
+  }
+  memset(m_uploadRing.data + slot, 0, slotSize);
+
+  buf.streaming = true;
+  buf.copied = false;
+  return true;
+}
+
+void CLinuxRendererGL::ReleaseUploadSlot(int index)
+{
+  std::unique_lock<CCriticalSection> lock(m_uploadSection);
+  CPictureBuffer& buf = m_buffers[index];
+
+  while (buf.copying)
+  {
+    lock.unlock();
+    m_uploadEvent.Wait(10ms);
+    lock.lock();
+  }
+
+  if (buf.uploadFence)
+  {
+    glDeleteSync(buf.uploadFence);
+    buf.uploadFence = nullptr;
+  }
+
+  if (buf.streaming)
+  {
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+      buf.image.plane[p] = nullptr;
+    buf.streaming = false;
+  }
+  buf.copied = false;
+}
+
+YuvImage CLinuxRendererGL::GetUploadSlotImage(const CPictureBuffer& buff) const
+{
+  YuvImage image = buff.image;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+  {
+    if (image.plane[p])
+      image.plane[p] = m_uploadRing.data + reinterpret_cast<uintptr_t>(image.plane[p]);
+  }
+  return image;
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <vector>
 
 #include "system_gl.h"
@@ -17,6 +18,8 @@
 #include "RenderInfo.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/Geometry.h"
 
 extern "C" {
@@ -66,15 +69,18 @@ public:
   bool Configure(const VideoPicture &picture, float fps, unsigned int orientation) override;
   bool IsConfigured() override { return m_bConfigured; }
   void AddVideoPicture(const VideoPicture &picture, int index) override;
+  void PrepareVideoPicture(const VideoPicture& picture, int index) override;
   void UnInit() override;
   bool Flush(bool saveBuffers) override;
   void SetBufferSize(int numBuffers) override { m_NumYV12Buffers = numBuffers; }
   void ReleaseBuffer(int idx) override;
+  bool NeedBuffer(int idx) override;
   void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
   void Update() override;
   bool RenderCapture(CRenderCapture* capture) override;
   CRenderInfo GetRenderInfo() override;
   bool ConfigChanged(const VideoPicture &picture) override;
+  DEBUG_INFO_VIDEO GetDebugInfo(int idx) override;
 
   // Feature support
   bool SupportsMultiPassRendering() override;
@@ -116,6 +122,13 @@ protected:
 
   void CalculateTextureSourceRects(int source, int num_planes);
 
+  // streaming upload
+  bool CreateUploadRing(size_t slotSize);
+  void DeleteUploadRing();
+  bool SetupUploadSlot(int index);
+  void ReleaseUploadSlot(int index);
+  void CopyVideoBuffer(YuvImage& dst, CVideoBuffer* videoBuffer);
+
   // renderers
   void RenderToFBO(int renderBuffer, int field, bool weave = false);
   void RenderFromFBO();
@@ -126,6 +139,7 @@ protected:
   struct CYuvPlane;
   struct CPictureBuffer;
 
+  YuvImage GetUploadSlotImage(const CPictureBuffer& buff) const;
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
   void LoadPlane(CYuvPlane& plane, int type,
@@ -186,6 +200,12 @@ protected:
     CVideoBuffer *videoBuffer;
     bool loaded;
 
+    // the planes are offsets into the upload ring
+    bool streaming = false;
+    bool copying = false;
+    bool copied = false;
+    GLsync uploadFence = nullptr;
+
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
     int m_srcBits = 8;
@@ -215,6 +235,31 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  bool m_streamingSupported = false;
+  bool m_streamingUsed = false;
+
+  // one persistently mapped buffer with a slot per picture buffer, pictures
+  // are copied to their slot on the thread that adds them
+  struct CUploadRing
+  {
+    GLuint pbo = 0;
+    uint8_t* data = nullptr;
+    size_t slotSize = 0;
+    int slots = 0;
+  } m_uploadRing;
+
+  struct CUploadStats
+  {
+    std::chrono::steady_clock::time_point start;
+    std::chrono::duration<double, std::milli> total{0};
+    std::chrono::duration<double, std::milli> peak{0};
+    unsigned int uploads = 0;
+    unsigned int ringCopies = 0; // copied by the thread adding the picture
+  } m_uploadStats;
+  std::string m_uploadInfo;
+
+  CCriticalSection m_uploadSection;
+  CEvent m_uploadEvent;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
@@ -0,0 +1,322 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LinuxRendererSW.h"
+
+#include "RenderCapture.h"
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+class CRenderCaptureSW : public CRenderCapture
+{
+public:
+  ~CRenderCaptureSW() override { delete[] m_pixels; }
+
+  void BeginRender() override
+  {
+    if (m_bufferSize != m_width * m_height * 4)
+    {
+      delete[] m_pixels;
+      m_bufferSize = m_width * m_height * 4;
+      m_pixels = new uint8_t[m_bufferSize];
+    }
+  }
+
+  void EndRender() override { SetState(CAPTURESTATE_DONE); }
+};
+} // namespace
+
+CBaseRenderer* CLinuxRendererSW::Create(CVideoBuffer* buffer)
+{
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoSoftwareRenderer)
+    return nullptr;
+
+  if (buffer && !CSWFrameScaler::IsSupported(buffer->GetFormat()))
+    return nullptr;
+
+  return new CLinuxRendererSW();
+}
+
+CLinuxRendererSW::~CLinuxRendererSW()
+{
+  UnInit();
+}
+
+bool CLinuxRendererSW::Configure(const VideoPicture& picture, float fps, unsigned int orientation)
+{
+  m_format = picture.videoBuffer->GetFormat();
+  if (!CSWFrameScaler::IsSupported(m_format))
+  {
+    CLog::Log(LOGERROR, "CLinuxRendererSW::{} - unsupported format: {}", __FUNCTION__,
+              static_cast<int>(m_format));
+    return false;
+  }
+
+  m_sourceWidth = picture.iWidth;
+  m_sourceHeight = picture.iHeight;
+  m_renderOrientation = orientation;
+  m_fps = fps;
+
+  // Calculate the input frame aspect ratio.
+  CalculateFrameAspectRatio(picture.iDisplayWidth, picture.iDisplayHeight);
+  SetViewMode(m_videoSettings.m_ViewMode);
+  ManageRenderArea();
+
+  CLog::Log(LOGINFO, "CLinuxRendererSW::{} - {}x{}, kernels: {}", __FUNCTION__, m_sourceWidth,
+            m_sourceHeight, m_scaler.GetKernelName());
+
+  m_bConfigured = true;
+  return true;
+}
+
+bool CLinuxRendererSW::ConfigChanged(const VideoPicture& picture)
+{
+  return picture.videoBuffer->GetFormat() != m_format;
+}
+
+void CLinuxRendererSW::AddVideoPicture(const VideoPicture& picture, int index)
+{
+  CPictureBuffer& buf = m_buffers[index];
+  if (buf.videoBuffer)
+  {
+    CLog::LogF(LOGERROR, "unreleased video buffer");
+    buf.videoBuffer->Release();
+  }
+  buf.videoBuffer = picture.videoBuffer;
+  buf.videoBuffer->Acquire();
+
+  // same guess as the gl shaders
+  buf.colorSpace = static_cast<AVColorSpace>(picture.color_space);
+  if (buf.colorSpace == AVCOL_SPC_UNSPECIFIED)
+  {
+    if (picture.iWidth > 1024 || picture.iHeight >= 600)
+      buf.colorSpace = AVCOL_SPC_BT709;
+    else
+      buf.colorSpace = AVCOL_SPC_BT470BG;
+  }
+  buf.fullRange = picture.color_range == 1;
+}
+
+void CLinuxRendererSW::ReleaseBuffer(int idx)
+{
+  CPictureBuffer& buf = m_buffers[idx];
+  if (buf.videoBuffer)
+  {
+    buf.videoBuffer->Release();
+    buf.videoBuffer = nullptr;
+  }
+}
+
+void CLinuxRendererSW::UnInit()
+{
+  for (int i = 0; i < NUM_BUFFERS; i++)
+    ReleaseBuffer(i);
+
+  m_renderBuffer = -1;
+  m_bConfigured = false;
+}
+
+bool CLinuxRendererSW::Flush(bool saveBuffers)
+{
+  if (!saveBuffers)
+  {
+    for (int i = 0; i < NUM_BUFFERS; i++)
+      ReleaseBuffer(i);
+    m_renderBuffer = -1;
+  }
+  return saveBuffers;
+}
+
+void CLinuxRendererSW::Update()
+{
+  if (!m_bConfigured)
+    return;
+  ManageRenderArea();
+}
+
+void CLinuxRendererSW::RenderUpdate(
+    int index, int index2, bool clear, unsigned int flags, unsigned int alpha)
+{
+  if (!m_bConfigured)
+    return;
+
+  m_renderBuffer = index2 >= 0 ? index2 : index;
+  ManageRenderArea();
+
+  const unsigned int width = static_cast<unsigned int>(std::lrint(m_viewRect.Width()));
+  const unsigned int height = static_cast<unsigned int>(std::lrint(m_viewRect.Height()));
+  if (width != m_frameWidth || height != m_frameHeight)
+  {
+    m_frameWidth = width;
+    m_frameHeight = height;
+    m_frameBuffer.resize(width * height * 4);
+    clear = true;
+  }
+
+  if (clear)
+    ClearFrameBuffer();
+
+  CRect dest = m_destRect;
+  dest -= m_viewRect.P1();
+
+  const auto start = std::chrono::steady_clock::now();
+  if (!RenderPicture(m_scaler, m_renderBuffer, dest, m_frameBuffer.data(), width, height))
+    return;
+
+  const std::chrono::duration<double, std::milli> duration =
+      std::chrono::steady_clock::now() - start;
+  m_renderStats.total += duration;
+  m_renderStats.peak = std::max(m_renderStats.peak, duration);
+  m_renderStats.frames++;
+}
+
+bool CLinuxRendererSW::RenderPicture(CSWFrameScaler& scaler,
+                                     int index,
+                                     const CRect& dest,
+                                     uint8_t* pixels,
+                                     unsigned int width,
+                                     unsigned int height)
+{
+  if (index < 0 || index >= NUM_BUFFERS || !m_buffers[index].videoBuffer)
+    return false;
+
+  const CPictureBuffer& buf = m_buffers[index];
+
+  // parts of the video outside of the frame buffer are cropped from the source
+  CRect clipped = dest;
+  clipped.Intersect(CRect(0, 0, static_cast<float>(width), static_cast<float>(height)));
+  if (clipped.IsEmpty())
+    return false;
+
+  const float scaleX = m_sourceRect.Width() / dest.Width();
+  const float scaleY = m_sourceRect.Height() / dest.Height();
+  CRect source = m_sourceRect;
+  source.x1 += (clipped.x1 - dest.x1) * scaleX;
+  source.x2 -= (dest.x2 - clipped.x2) * scaleX;
+  source.y1 += (clipped.y1 - dest.y1) * scaleY;
+  source.y2 -= (dest.y2 - clipped.y2) * scaleY;
+
+  const int dstX = static_cast<int>(std::lrint(clipped.x1));
+  const int dstY = static_cast<int>(std::lrint(clipped.y1));
+  const int dstWidth = static_cast<int>(std::lrint(clipped.x2)) - dstX;
+  const int dstHeight = static_cast<int>(std::lrint(clipped.y2)) - dstY;
+
+  // chroma is subsampled, crops start on even pixels
+  const int srcX = static_cast<int>(std::lrint(source.x1)) & ~1;
+  const int srcY = static_cast<int>(std::lrint(source.y1)) & ~1;
+  const int srcWidth =
+      std::min(static_cast<int>(std::lrint(source.x2)), static_cast<int>(m_sourceWidth)) - srcX;
+  const int srcHeight =
+      std::min(static_cast<int>(std::lrint(source.y2)), static_cast<int>(m_sourceHeight)) - srcY;
+
+  ESCALINGMETHOD method = m_videoSettings.m_ScalingMethod;
+  if (!Supports(method))
+    method = VS_SCALINGMETHOD_AUTO;
+
+  const AVPixelFormat format = buf.videoBuffer->GetFormat();
+  if (!scaler.Configure(format, srcWidth, srcHeight, buf.colorSpace, buf.fullRange, dstWidth,
+                        dstHeight, method))
+    return false;
+
+  uint8_t* planes[YuvImage::MAX_PLANES];
+  int strides[YuvImage::MAX_PLANES];
+  buf.videoBuffer->GetPlanes(planes);
+  buf.videoBuffer->GetStrides(strides);
+  CSWFrameScaler::CropPlanes(format, planes, strides, srcX, srcY);
+
+  scaler.Scale(planes, strides, pixels + (dstY * width + dstX) * 4, width * 4);
+  return true;
+}
+
+void CLinuxRendererSW::ClearFrameBuffer()
+{
+  for (size_t i = 0; i < m_frameBuffer.size(); i += 4)
+  {
+    m_frameBuffer[i] = m_frameBuffer[i + 1] = m_frameBuffer[i + 2] = 0;
+    m_frameBuffer[i + 3] = 255;
+  }
+}
+
+bool CLinuxRendererSW::RenderCapture(CRenderCapture* capture)
+{
+  if (m_renderBuffer < 0 || !m_buffers[m_renderBuffer].videoBuffer)
+    return false;
+
+  capture->BeginRender();
+
+  const unsigned int width = capture->GetWidth();
+  const unsigned int height = capture->GetHeight();
+  uint8_t* pixels = static_cast<uint8_t*>(capture->GetRenderBuffer());
+  const bool rendered = RenderPicture(m_captureScaler, m_renderBuffer,
+                                      CRect(0, 0, static_cast<float>(width),
+                                            static_cast<float>(height)),
+                                      pixels, width, height);
+
+  // captures are BGRA
+  if (rendered)
+  {
+    for (unsigned int i = 0; i < width * height * 4; i += 4)
+      std::swap(pixels[i], pixels[i + 2]);
+  }
+
+  capture->EndRender();
+  return rendered;
+}
+
+CRenderCapture* CLinuxRendererSW::GetRenderCapture()
+{
+  return new CRenderCaptureSW;
+}
+
+CRenderInfo CLinuxRendererSW::GetRenderInfo()
+{
+  CRenderInfo info;
+  info.max_buffer_size = NUM_BUFFERS;
+  return info;
+}
+
+DEBUG_INFO_VIDEO CLinuxRendererSW::GetDebugInfo(int idx)
+{
+  // averaged over about a second
+  const auto now = std::chrono::steady_clock::now();
+  if (m_renderInfo.empty() || now - m_renderStats.start >= std::chrono::seconds(1))
+  {
+    const unsigned int frames = std::max(m_renderStats.frames, 1u);
+    m_renderInfo = StringUtils::Format("Software: {}, avg: {:.2f} ms, max: {:.2f} ms",
+                                       m_scaler.GetKernelName(),
+                                       m_renderStats.total.count() / frames,
+                                       m_renderStats.peak.count());
+    m_renderStats = {};
+    m_renderStats.start = now;
+  }
+
+  DEBUG_INFO_VIDEO info;
+  info.shader = m_renderInfo;
+  return info;
+}
+
+bool CLinuxRendererSW::Supports(ERENDERFEATURE feature) const
+{
+  return feature == RENDERFEATURE_STRETCH || feature == RENDERFEATURE_ZOOM ||
+         feature == RENDERFEATURE_VERTICAL_SHIFT || feature == RENDERFEATURE_PIXEL_RATIO;
+}
+
+bool CLinuxRendererSW::Supports(ESCALINGMETHOD method) const
+{
+  return CSWFrameScaler::Supports(method);
+}
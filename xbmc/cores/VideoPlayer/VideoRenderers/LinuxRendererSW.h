@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "BaseRenderer.h"
+#include "SWFrameScaler.h"
+#include "utils/Geometry.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+/*!
+ * \brief Renders video on the cpu, into an RGBA frame buffer in memory
+ *
+ * Meant for machines without a gpu, CI and benchmarks. Nothing is drawn on
+ * screen, the output is read with a render capture or GetFrameBuffer. It is
+ * only used when enabled with the videoplayer/softwarerenderer advanced
+ * setting. There is no deinterlacing, tone mapping or color management.
+ */
+class CLinuxRendererSW : public CBaseRenderer
+{
+public:
+  CLinuxRendererSW() = default;
+  ~CLinuxRendererSW() override;
+
+  //! Registered as "software" by CRendererFactory on every window system, it needs no gl context
+  static CBaseRenderer* Create(CVideoBuffer* buffer);
+
+  // Player functions
+  bool Configure(const VideoPicture& picture, float fps, unsigned int orientation) override;
+  bool IsConfigured() override { return m_bConfigured; }
+  void AddVideoPicture(const VideoPicture& picture, int index) override;
+  void UnInit() override;
+  bool Flush(bool saveBuffers) override;
+  void ReleaseBuffer(int idx) override;
+  void RenderUpdate(
+      int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
+  void Update() override;
+  bool RenderCapture(CRenderCapture* capture) override;
+  CRenderInfo GetRenderInfo() override;
+  bool ConfigChanged(const VideoPicture& picture) override;
+  DEBUG_INFO_VIDEO GetDebugInfo(int idx) override;
+
+  // Feature support
+  bool SupportsMultiPassRendering() override { return false; }
+  bool Supports(ERENDERFEATURE feature) const override;
+  bool Supports(ESCALINGMETHOD method) const override;
+
+  CRenderCapture* GetRenderCapture() override;
+
+  /*!
+   * \brief Output of the last RenderUpdate, rows of GetFrameWidth() RGBA pixels
+   */
+  const std::vector<uint8_t>& GetFrameBuffer() const { return m_frameBuffer; }
+  unsigned int GetFrameWidth() const { return m_frameWidth; }
+  unsigned int GetFrameHeight() const { return m_frameHeight; }
+
+protected:
+  struct CPictureBuffer
+  {
+    CVideoBuffer* videoBuffer = nullptr;
+    AVColorSpace colorSpace = AVCOL_SPC_UNSPECIFIED;
+    bool fullRange = false;
+  };
+
+  /*!
+   * \brief Draw the picture of a buffer into the rectangle dest of a frame buffer
+   */
+  bool RenderPicture(CSWFrameScaler& scaler,
+                     int index,
+                     const CRect& dest,
+                     uint8_t* pixels,
+                     unsigned int width,
+                     unsigned int height);
+
+  void ClearFrameBuffer();
+
+  bool m_bConfigured = false;
+  int m_renderBuffer = -1;
+  CPictureBuffer m_buffers[NUM_BUFFERS];
+
+  CSWFrameScaler m_scaler;
+  CSWFrameScaler m_captureScaler;
+
+  std::vector<uint8_t> m_frameBuffer;
+  unsigned int m_frameWidth = 0;
+  unsigned int m_frameHeight = 0;
+
+  struct CRenderStats
+  {
+    std::chrono::steady_clock::time_point start;
+    std::chrono::duration<double, std::milli> total{0};
+    std::chrono::duration<double, std::milli> peak{0};
+    unsigned int frames = 0;
+  } m_renderStats;
+  std::string m_renderInfo;
+};
@@ -8,13 +8,33 @@
 
 #include "RenderFactory.h"
 
+#if (defined(TARGET_LINUX) && !defined(TARGET_ANDROID)) || defined(TARGET_FREEBSD)
+#include "LinuxRendererSW.h"
+#endif
+
 #include <mutex>
 
 
 using namespace VIDEOPLAYER;
 
 CCriticalSection renderSection;
-std::map<std::string, VIDEOPLAYER::CreateRenderer> CRendererFactory::m_renderers;
+
+namespace
+{
+// renderers that need no gpu context, they are there before the window system registers its
+// own and stay when it clears them
+std::map<std::string, VIDEOPLAYER::CreateRenderer> GetSoftwareRenderers()
+{
+  std::map<std::string, VIDEOPLAYER::CreateRenderer> renderers;
+#if (defined(TARGET_LINUX) && !defined(TARGET_ANDROID)) || defined(TARGET_FREEBSD)
+  renderers["software"] = CLinuxRendererSW::Create;
+#endif
+  return renderers;
+}
+} // namespace
+
+std::map<std::string, VIDEOPLAYER::CreateRenderer> CRendererFactory::m_renderers =
+    GetSoftwareRenderers();
 
 CBaseRenderer* CRendererFactory::CreateRenderer(const std::string& id, CVideoBuffer* buffer)
 {
@@ -53,5 +73,5 @@ void CRendererFactory::ClearRenderer()
 {
   std::unique_lock<CCriticalSection> lock(renderSection);
 
-  m_renderers.clear();
+  m_renderers = GetSoftwareRenderers();
 }
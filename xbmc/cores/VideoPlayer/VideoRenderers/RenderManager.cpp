@@ -216,6 +216,7 @@ bool CRenderManager::Configure()
     m_presentsourcePast = -1;
     for (int i=1; i < m_QueueSize; i++)
       m_free.push_back(i);
+    m_bufferGeneration++;
 
     m_bRenderGUI = true;
     m_bTriggerUpdateResolution = true;
@@ -305,6 +306,9 @@ void CRenderManager::FrameMove()
   {
     std::unique_lock<CCriticalSection> lock2(m_presentlock);
 
+    // whatever was drawn last time is on screen now
+    m_trace.Presented();
+
     if (m_queued.empty())
     {
       m_presentstep = PRESENT_IDLE;
@@ -373,6 +377,7 @@ void CRenderManager::PreInit()
   }
 
   UpdateLatencyTweak();
+  m_trace.Reset();
 
   m_QueueSize   = 2;
   m_QueueSkip   = 0;
@@ -432,9 +437,12 @@ bool CRenderManager::Flush(bool wait, bool saveBuffers)
     {
       m_overlays.Flush();
       m_debugRenderer.Flush();
+      m_bufferGeneration++;
 
       if (!m_pRenderer->Flush(saveBuffers))
       {
+        for (int index : m_queued)
+          m_trace.Dropped(index, CRenderTrace::DropReason::FLUSH);
         m_queued.clear();
         m_discard.clear();
         m_free.clear();
@@ -598,6 +606,12 @@ bool CRenderManager::RenderCaptureGetPixels(unsigned int captureId, unsigned int
   return true;
 }
 
+bool CRenderManager::GetRenderTrace(CVariant& trace) const
+{
+  m_trace.Export(trace);
+  return true;
+}
+
 void CRenderManager::ManageCaptures()
 {
   //no captures, return here so we don't do an unnecessary lock
@@ -721,6 +735,8 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
       PresentBlend(clear, flags, alpha);
     else
       PresentSingle(clear, flags, alpha);
+
+    m_trace.Rendered(m_presentsource);
   }
 
   if (gui)
@@ -959,6 +975,7 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
     return false;
 
   int index = m_free.front();
+  const unsigned int generation = m_bufferGeneration;
 
   {
     std::unique_lock<CCriticalSection> lock(m_datalock);
@@ -968,6 +985,24 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
     m_pRenderer->AddVideoPicture(picture, index);
   }
 
+  // only this thread takes free buffers, the render thread keeps presenting meanwhile
+  lock.unlock();
+  {
+    std::unique_lock<CCriticalSection> lock(m_datalock);
+    if (m_pRenderer && m_bufferGeneration == generation)
+      m_pRenderer->PrepareVideoPicture(picture, index);
+  }
+  lock.lock();
+
+  // flushed or reconfigured in between, the picture belongs to the old buffers
+  if (m_bufferGeneration != generation)
+  {
+    std::unique_lock<CCriticalSection> lock(m_datalock);
+    if (m_pRenderer)
+      m_pRenderer->ReleaseBuffer(index);
+    return false;
+  }
+
 
   // set fieldsync if picture is interlaced
   EFIELDSYNC displayField = FS_NONE;
@@ -1013,6 +1048,7 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   m.presentfield = displayField;
   m.presentmethod = presentmethod;
   m.pts = picture.pts;
+  m_trace.Queued(index, picture.pts);
   m_queued.push_back(m_free.front());
   m_free.pop_front();
   m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
@@ -1082,6 +1118,8 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool& bStop,
 {
   std::unique_lock<CCriticalSection> lock(m_presentlock);
 
+  m_trace.Decoded();
+
   // check if gui is active and discard buffer if not
   // this keeps videoplayer going
   if (!m_bRenderGUI || !g_application.GetRenderGUI())
@@ -1102,6 +1140,8 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool& bStop,
       sleeptime = 0ms;
     sleeptime = std::min(sleeptime, 20ms);
     m_presentevent.wait(lock, sleeptime);
+    for (int index : m_queued)
+      m_trace.Dropped(index, CRenderTrace::DropReason::NO_RENDER);
     DiscardBuffer();
     return 0;
   }
@@ -1215,6 +1255,7 @@ void CRenderManager::PrepareNextRender()
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
       }
+      m_trace.Dropped(m_queued.front(), CRenderTrace::DropReason::LATE);
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
     }
@@ -1253,6 +1294,7 @@ void CRenderManager::DiscardBuffer()
 
   while(!m_queued.empty())
   {
+    m_trace.Dropped(m_queued.front(), CRenderTrace::DropReason::FLUSH);
     m_discard.push_back(m_queued.front());
     m_queued.pop_front();
   }
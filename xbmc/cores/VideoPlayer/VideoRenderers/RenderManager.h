@@ -10,6 +10,7 @@
 
 #include "DVDClock.h"
 #include "DebugRenderer.h"
+#include "RenderTrace.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
 #include "cores/VideoPlayer/VideoRenderers/OverlayRenderer.h"
 #include "cores/VideoSettings.h"
@@ -27,6 +28,7 @@
 #include "PlatformDefs.h"
 
 class CRenderCapture;
+class CVariant;
 struct VideoPicture;
 
 class CWinRenderer;
@@ -88,6 +90,11 @@ public:
   void StartRenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
 
+  /*!
+   * \brief Timeline of the last frames and latency histograms, in Chrome trace event format
+   */
+  bool GetRenderTrace(CVariant& trace) const;
+
   // Functions called from GUI
   bool Supports(ERENDERFEATURE feature) const;
   bool Supports(ESCALINGMETHOD method) const;
@@ -199,6 +206,7 @@ protected:
   } m_Queue[NUM_BUFFERS]{};
 
   std::deque<int> m_free;
+  unsigned int m_bufferGeneration = 0; //!< changes when the buffers are flushed or reconfigured
   std::deque<int> m_queued;
   std::deque<int> m_discard;
 
@@ -244,4 +252,7 @@ protected:
   //set to true when adding something to m_captures, set to false when m_captures is made empty
   //std::list::empty() isn't thread safe, using an extra bool will save a lock per render when no captures are requested
   bool m_hasCaptures = false;
+
+  static_assert(NUM_BUFFERS <= CRenderTrace::MAX_BUFFERS, "render trace needs a slot per buffer");
+  CRenderTrace m_trace;
 };
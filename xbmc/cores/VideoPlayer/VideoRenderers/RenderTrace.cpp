@@ -0,0 +1,286 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RenderTrace.h"
+
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+// chrome trace "threads", one per step of the timeline
+enum TraceThread
+{
+  THREAD_WAITING = 1,
+  THREAD_QUEUED,
+  THREAD_RENDERING,
+  THREAD_DROPPED,
+};
+
+const char* GetDropReasonName(CRenderTrace::DropReason reason)
+{
+  switch (reason)
+  {
+    case CRenderTrace::DropReason::LATE:
+      return "late";
+    case CRenderTrace::DropReason::FLUSH:
+      return "flush";
+    case CRenderTrace::DropReason::NO_RENDER:
+      return "norender";
+    default:
+      return "none";
+  }
+}
+
+void AddThreadName(CVariant& events, int tid, const char* name)
+{
+  CVariant event(CVariant::VariantTypeObject);
+  event["name"] = "thread_name";
+  event["ph"] = "M";
+  event["pid"] = 1;
+  event["tid"] = tid;
+  event["args"]["name"] = name;
+  events.push_back(event);
+}
+} // namespace
+
+CRenderTrace::CHistogram::CHistogram(double start, double binWidth, unsigned int bins)
+  : start(start), binWidth(binWidth), counts(bins, 0)
+{
+}
+
+void CRenderTrace::CHistogram::Add(double value)
+{
+  samples++;
+  sum += value;
+
+  const double bin = std::floor((value - start) / binWidth);
+  if (bin < 0)
+    underflow++;
+  else if (bin >= counts.size())
+    overflow++;
+  else
+    counts[static_cast<size_t>(bin)]++;
+}
+
+void CRenderTrace::CHistogram::Reset()
+{
+  std::fill(counts.begin(), counts.end(), 0);
+  underflow = 0;
+  overflow = 0;
+  samples = 0;
+  sum = 0.0;
+}
+
+CRenderTrace::CRenderTrace(unsigned int capacity, int64_t frequency)
+  : m_frequency(frequency),
+    m_frames(std::max(capacity, 1u)),
+    m_latency(0.0, 2.0, 100),
+    m_jitter(-25.0, 1.0, 50)
+{
+}
+
+void CRenderTrace::Reset()
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  std::fill(m_frames.begin(), m_frames.end(), CFrame());
+  m_buffers.fill(0);
+  m_decoded = 0;
+  m_rendered.clear();
+  m_lastPresented = 0;
+  m_latency.Reset();
+  m_jitter.Reset();
+}
+
+void CRenderTrace::Decoded(int64_t now)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  if (!m_decoded)
+    m_decoded = now;
+}
+
+void CRenderTrace::Queued(int index, double pts, int64_t now)
+{
+  if (index < 0 || index >= static_cast<int>(MAX_BUFFERS))
+    return;
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  const uint64_t id = m_nextId++;
+  CFrame& frame = m_frames[id % m_frames.size()];
+  frame = CFrame();
+  frame.id = id;
+  frame.index = index;
+  frame.pts = pts;
+  frame.decoded = m_decoded ? m_decoded : now;
+  frame.queued = now;
+  m_buffers[index] = id;
+  m_decoded = 0;
+}
+
+void CRenderTrace::Rendered(int index, int64_t now)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  CFrame* frame = GetFrame(index);
+  if (!frame || frame->uploaded || frame->dropped)
+    return;
+
+  frame->uploaded = now;
+  m_rendered.push_back(frame->id);
+}
+
+void CRenderTrace::Presented(int64_t now)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  for (uint64_t id : m_rendered)
+  {
+    CFrame& frame = m_frames[id % m_frames.size()];
+    if (frame.id != id || frame.presented)
+      continue;
+
+    frame.presented = now;
+    m_latency.Add(ToMs(frame.presented - frame.decoded));
+
+    const CFrame& last = m_frames[m_lastPresented % m_frames.size()];
+    if (m_lastPresented && last.id == m_lastPresented && frame.pts != DVD_NOPTS_VALUE &&
+        last.pts != DVD_NOPTS_VALUE && frame.pts > last.pts)
+    {
+      const double ptsDiff = (frame.pts - last.pts) * 1000.0 / DVD_TIME_BASE;
+      m_jitter.Add(ToMs(frame.presented - last.presented) - ptsDiff);
+    }
+    m_lastPresented = id;
+  }
+  m_rendered.clear();
+}
+
+void CRenderTrace::Dropped(int index, DropReason reason, int64_t now)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  // a discontinuity, the next presented frame has no predecessor
+  if (reason == DropReason::FLUSH)
+    m_lastPresented = 0;
+
+  CFrame* frame = GetFrame(index);
+  if (!frame || frame->uploaded || frame->dropped)
+    return;
+
+  frame->dropped = now;
+  frame->reason = reason;
+}
+
+CRenderTrace::CFrame* CRenderTrace::GetFrame(int index)
+{
+  if (index < 0 || index >= static_cast<int>(MAX_BUFFERS) || !m_buffers[index])
+    return nullptr;
+
+  const uint64_t id = m_buffers[index];
+  CFrame& frame = m_frames[id % m_frames.size()];
+  return frame.id == id ? &frame : nullptr;
+}
+
+double CRenderTrace::ToMs(int64_t ticks) const
+{
+  return static_cast<double>(ticks) * 1000.0 / static_cast<double>(m_frequency);
+}
+
+CRenderTrace::CHistogram CRenderTrace::GetLatencyHistogram() const
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  return m_latency;
+}
+
+CRenderTrace::CHistogram CRenderTrace::GetJitterHistogram() const
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  return m_jitter;
+}
+
+void CRenderTrace::Export(CVariant& trace) const
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  CVariant events(CVariant::VariantTypeArray);
+  AddThreadName(events, THREAD_WAITING, "waiting for buffer");
+  AddThreadName(events, THREAD_QUEUED, "queued");
+  AddThreadName(events, THREAD_RENDERING, "rendering");
+  AddThreadName(events, THREAD_DROPPED, "dropped");
+
+  // timestamps in us
+  auto toUs = [this](int64_t ticks) { return ToMs(ticks) * 1000.0; };
+
+  // oldest first
+  const uint64_t first = m_nextId > m_frames.size() ? m_nextId - m_frames.size() : 1;
+  for (uint64_t id = first; id < m_nextId; id++)
+  {
+    const CFrame& frame = m_frames[id % m_frames.size()];
+    if (frame.id != id)
+      continue;
+
+    CVariant args(CVariant::VariantTypeObject);
+    args["buffer"] = frame.index;
+    if (frame.pts != DVD_NOPTS_VALUE)
+      args["pts"] = frame.pts * 1000.0 / DVD_TIME_BASE;
+
+    auto addSpan = [&](int tid, int64_t begin, int64_t end) {
+      if (!begin || !end)
+        return;
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = "frame " + std::to_string(frame.id);
+      event["ph"] = "X";
+      event["pid"] = 1;
+      event["tid"] = tid;
+      event["ts"] = toUs(begin);
+      event["dur"] = toUs(end - begin);
+      event["args"] = args;
+      events.push_back(event);
+    };
+
+    addSpan(THREAD_WAITING, frame.decoded, frame.queued);
+    addSpan(THREAD_QUEUED, frame.queued, frame.uploaded ? frame.uploaded : frame.dropped);
+    addSpan(THREAD_RENDERING, frame.uploaded, frame.presented);
+
+    if (frame.dropped)
+    {
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = std::string("dropped: ") + GetDropReasonName(frame.reason);
+      event["ph"] = "i";
+      event["s"] = "t";
+      event["pid"] = 1;
+      event["tid"] = THREAD_DROPPED;
+      event["ts"] = toUs(frame.dropped);
+      event["args"] = args;
+      events.push_back(event);
+    }
+  }
+
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+  ExportHistogram(m_latency, trace["histograms"]["latency"]);
+  ExportHistogram(m_jitter, trace["histograms"]["jitter"]);
+}
+
+void CRenderTrace::ExportHistogram(const CHistogram& histogram, CVariant& result)
+{
+  result["start"] = histogram.start;
+  result["binwidth"] = histogram.binWidth;
+  result["counts"] = CVariant(CVariant::VariantTypeArray);
+  for (unsigned int count : histogram.counts)
+    result["counts"].push_back(count);
+  result["underflow"] = histogram.underflow;
+  result["overflow"] = histogram.overflow;
+  result["samples"] = histogram.samples;
+  result["mean"] = histogram.samples ? histogram.sum / histogram.samples : 0.0;
+}
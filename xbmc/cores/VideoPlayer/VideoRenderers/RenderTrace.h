@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class CVariant;
+
+/*!
+ * \brief Timeline of the frames going through the render manager
+ *
+ * Keeps the last frames in a ring, with host counter timestamps of every step:
+ * - decoded: the player has a decoded picture and waits for a render buffer
+ * - queued: the picture is in a render buffer, waiting for its time
+ * - uploaded: the renderer drew the picture for the first time
+ * - presented: the render loop moved on after drawing it, the buffer swap is done
+ * A frame that leaves the queue without being presented is dropped, with a
+ * reason. Frames are identified by their render buffer index.
+ *
+ * Also keeps histograms of the latency from decoded to presented, and of the
+ * presentation jitter: the time between two presented frames minus the
+ * difference of their pts.
+ */
+class CRenderTrace
+{
+public:
+  enum class DropReason
+  {
+    NONE = 0,
+    LATE, //!< skipped, a later frame was due already
+    FLUSH, //!< discarded by a flush or seek
+    NO_RENDER, //!< discarded while the gui does not render
+  };
+
+  struct CHistogram
+  {
+    CHistogram(double start, double binWidth, unsigned int bins);
+    void Add(double value);
+    void Reset();
+
+    double start; //!< lower bound of the first bin, in ms
+    double binWidth; //!< in ms
+    std::vector<unsigned int> counts;
+    unsigned int underflow = 0;
+    unsigned int overflow = 0;
+    unsigned int samples = 0;
+    double sum = 0.0;
+  };
+
+  static constexpr unsigned int MAX_BUFFERS = 16;
+  static constexpr unsigned int DEFAULT_CAPACITY = 1024;
+
+  explicit CRenderTrace(unsigned int capacity = DEFAULT_CAPACITY,
+                        int64_t frequency = CurrentHostFrequency());
+
+  void Reset();
+
+  /*!
+   * \brief A decoded picture waits for a render buffer, it becomes the next queued frame
+   */
+  void Decoded(int64_t now = CurrentHostCounter());
+  /*!
+   * \param pts of the picture, in DVD_TIME_BASE units
+   */
+  void Queued(int index, double pts, int64_t now = CurrentHostCounter());
+  /*!
+   * \brief The frame in buffer index was drawn, only the first time counts
+   */
+  void Rendered(int index, int64_t now = CurrentHostCounter());
+  /*!
+   * \brief The render loop moved on, frames drawn since the last call are presented
+   */
+  void Presented(int64_t now = CurrentHostCounter());
+  void Dropped(int index, DropReason reason, int64_t now = CurrentHostCounter());
+
+  /*!
+   * \brief Write the trace in the Chrome trace event format, plus the histograms
+   */
+  void Export(CVariant& trace) const;
+
+  CHistogram GetLatencyHistogram() const;
+  CHistogram GetJitterHistogram() const;
+
+private:
+  struct CFrame
+  {
+    uint64_t id = 0; //!< sequence number, 0 for an unused record
+    int index = -1;
+    double pts = 0.0;
+    int64_t decoded = 0;
+    int64_t queued = 0;
+    int64_t uploaded = 0;
+    int64_t presented = 0;
+    int64_t dropped = 0;
+    DropReason reason = DropReason::NONE;
+  };
+
+  CFrame* GetFrame(int index);
+  double ToMs(int64_t ticks) const;
+  static void ExportHistogram(const CHistogram& histogram, CVariant& result);
+
+  mutable CCriticalSection m_section;
+  const int64_t m_frequency;
+  std::vector<CFrame> m_frames;
+  uint64_t m_nextId = 1;
+  std::array<uint64_t, MAX_BUFFERS> m_buffers{}; //!< id of the frame in every render buffer
+  int64_t m_decoded = 0;
+  std::vector<uint64_t> m_rendered; //!< drawn, not presented yet
+  uint64_t m_lastPresented = 0;
+
+  CHistogram m_latency;
+  CHistogram m_jitter;
+};
@@ -0,0 +1,318 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SWFrameScaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int FILTER_ONE = 1 << SWRenderKernels::FILTER_BITS;
+
+struct Cubic
+{
+  double b;
+  double c;
+};
+
+Cubic GetCubic(ESCALINGMETHOD method)
+{
+  switch (method)
+  {
+    case VS_SCALINGMETHOD_CUBIC_B_SPLINE:
+      return {1.0, 0.0};
+    case VS_SCALINGMETHOD_CUBIC_MITCHELL:
+      return {1.0 / 3.0, 1.0 / 3.0};
+    case VS_SCALINGMETHOD_CUBIC_0_075:
+      return {0.0, 0.75};
+    case VS_SCALINGMETHOD_CUBIC_0_1:
+      return {0.0, 1.0};
+    default:
+      return {0.0, 0.5}; // catmull-rom
+  }
+}
+
+// Mitchell-Netravali
+double CubicWeight(const Cubic& cubic, double x)
+{
+  const double b = cubic.b;
+  const double c = cubic.c;
+  x = std::fabs(x);
+  if (x < 1.0)
+    return ((12 - 9 * b - 6 * c) * x * x * x + (-18 + 12 * b + 6 * c) * x * x + (6 - 2 * b)) / 6;
+  if (x < 2.0)
+    return ((-b - 6 * c) * x * x * x + (6 * b + 30 * c) * x * x + (-12 * b - 48 * c) * x +
+            (8 * b + 24 * c)) /
+           6;
+  return 0.0;
+}
+
+bool IsLinear(ESCALINGMETHOD method)
+{
+  return method == VS_SCALINGMETHOD_LINEAR || method == VS_SCALINGMETHOD_AUTO;
+}
+} // namespace
+
+CSWFrameScaler::CSWFrameScaler() : m_kernels(SWRenderKernels::Get())
+{
+}
+
+CSWFrameScaler::CSWFrameScaler(const SWRenderKernels& kernels) : m_kernels(kernels)
+{
+}
+
+bool CSWFrameScaler::IsSupported(AVPixelFormat format)
+{
+  return format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P ||
+         format == AV_PIX_FMT_NV12 || format == AV_PIX_FMT_P010;
+}
+
+bool CSWFrameScaler::Supports(ESCALINGMETHOD method)
+{
+  switch (method)
+  {
+    case VS_SCALINGMETHOD_AUTO:
+    case VS_SCALINGMETHOD_NEAREST:
+    case VS_SCALINGMETHOD_LINEAR:
+    case VS_SCALINGMETHOD_CUBIC_B_SPLINE:
+    case VS_SCALINGMETHOD_CUBIC_MITCHELL:
+    case VS_SCALINGMETHOD_CUBIC_CATMULL:
+    case VS_SCALINGMETHOD_CUBIC_0_075:
+    case VS_SCALINGMETHOD_CUBIC_0_1:
+    case VS_SCALINGMETHOD_BICUBIC_SOFTWARE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool CSWFrameScaler::Configure(AVPixelFormat format,
+                               int srcWidth,
+                               int srcHeight,
+                               AVColorSpace colorSpace,
+                               bool fullRange,
+                               int dstWidth,
+                               int dstHeight,
+                               ESCALINGMETHOD method)
+{
+  if (!IsSupported(format) || !Supports(method) || srcWidth <= 0 || srcHeight <= 0 ||
+      dstWidth <= 0 || dstHeight <= 0)
+    return false;
+
+  if (format == AV_PIX_FMT_YUVJ420P)
+    fullRange = true;
+
+  if (format != m_format || colorSpace != m_colorSpace || fullRange != m_fullRange)
+    m_coefs = SWRenderKernels::GetCoefs(colorSpace, fullRange, format == AV_PIX_FMT_P010 ? 10 : 8);
+
+  if (srcWidth != m_srcWidth || dstWidth != m_dstWidth || method != m_method)
+  {
+    m_filterX = CreateFilter(srcWidth, dstWidth, method);
+    m_convertRow.resize(srcWidth * 4);
+  }
+
+  if (srcHeight != m_srcHeight || dstHeight != m_dstHeight || method != m_method)
+  {
+    m_filterY = CreateFilter(srcHeight, dstHeight, method);
+    m_rowPointers.resize(m_filterY.taps);
+    m_rowIndex.resize(m_filterY.taps);
+  }
+
+  m_rows.resize(m_filterY.taps);
+  for (auto& row : m_rows)
+    row.resize(dstWidth * 4);
+
+  m_format = format;
+  m_srcWidth = srcWidth;
+  m_srcHeight = srcHeight;
+  m_colorSpace = colorSpace;
+  m_fullRange = fullRange;
+  m_dstWidth = dstWidth;
+  m_dstHeight = dstHeight;
+  m_method = method;
+  return true;
+}
+
+void CSWFrameScaler::CropPlanes(AVPixelFormat format,
+                                uint8_t* (&planes)[3],
+                                const int (&strides)[3],
+                                int x,
+                                int y)
+{
+  x &= ~1;
+  y &= ~1;
+  switch (format)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+      planes[0] += y * strides[0] + x;
+      planes[1] += y / 2 * strides[1] + x / 2;
+      planes[2] += y / 2 * strides[2] + x / 2;
+      break;
+    case AV_PIX_FMT_NV12:
+      planes[0] += y * strides[0] + x;
+      planes[1] += y / 2 * strides[1] + x;
+      break;
+    case AV_PIX_FMT_P010:
+      planes[0] += y * strides[0] + x * 2;
+      planes[1] += y / 2 * strides[1] + x * 2;
+      break;
+    default:
+      break;
+  }
+}
+
+void CSWFrameScaler::Scale(uint8_t* const (&planes)[3],
+                           const int (&strides)[3],
+                           uint8_t* dst,
+                           int dstStride)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    m_planes[i] = planes[i];
+    m_strides[i] = strides[i];
+  }
+  std::fill(m_rowIndex.begin(), m_rowIndex.end(), -1);
+
+  const int taps = m_filterY.taps;
+  for (int y = 0; y < m_dstHeight; y++)
+  {
+    uint8_t* out = dst + y * dstStride;
+
+    if (m_filterY.identity)
+    {
+      if (m_filterX.identity)
+      {
+        ConvertRow(y, out);
+      }
+      else
+      {
+        ConvertRow(y, m_convertRow.data());
+        m_kernels.FilterPixels(m_convertRow.data(), m_filterX.offsets.data(),
+                               m_filterX.weights.data(), m_filterX.taps, out, m_dstWidth);
+      }
+      continue;
+    }
+
+    const int first = m_filterY.offsets[y];
+    for (int t = 0; t < taps; t++)
+      m_rowPointers[t] = GetRow(first + t);
+
+    m_kernels.FilterRows(m_rowPointers.data(), m_filterY.weights.data() + y * taps, taps, out,
+                         m_dstWidth * 4);
+  }
+}
+
+CSWFrameScaler::Filter CSWFrameScaler::CreateFilter(int srcSize, int dstSize, ESCALINGMETHOD method)
+{
+  Filter filter;
+  filter.offsets.resize(dstSize);
+
+  const double scale = static_cast<double>(srcSize) / dstSize;
+  if (srcSize == dstSize || method == VS_SCALINGMETHOD_NEAREST)
+  {
+    filter.identity = srcSize == dstSize;
+    filter.taps = 1;
+    filter.weights.assign(dstSize, FILTER_ONE);
+    for (int i = 0; i < dstSize; i++)
+      filter.offsets[i] = std::min(static_cast<int>((i + 0.5) * scale), srcSize - 1);
+    return filter;
+  }
+
+  // the kernel gets wider when scaling down, so that every source pixel counts
+  const double stretch = std::max(scale, 1.0);
+  const double support = (IsLinear(method) ? 1.0 : 2.0) * stretch;
+  const int rawTaps = static_cast<int>(std::ceil(support * 2.0));
+  const Cubic cubic = GetCubic(method);
+
+  filter.taps = std::min(rawTaps, srcSize);
+  filter.weights.resize(dstSize * filter.taps);
+
+  std::vector<double> weights(filter.taps);
+  for (int i = 0; i < dstSize; i++)
+  {
+    const double center = (i + 0.5) * scale - 0.5;
+    const int first = static_cast<int>(std::floor(center - support)) + 1;
+    const int offset = std::clamp(first, 0, srcSize - filter.taps);
+
+    // taps outside of the source are folded into the edge pixels
+    std::fill(weights.begin(), weights.end(), 0.0);
+    double sum = 0.0;
+    for (int j = first; j < first + rawTaps; j++)
+    {
+      const double x = (j - center) / stretch;
+      const double weight = IsLinear(method) ? std::max(0.0, 1.0 - std::fabs(x))
+                                             : CubicWeight(cubic, x);
+      weights[std::clamp(j, 0, srcSize - 1) - offset] += weight;
+      sum += weight;
+    }
+
+    // quantize, the rounding error goes to the largest tap so that the sum stays exact
+    int16_t* out = filter.weights.data() + i * filter.taps;
+    int total = 0;
+    int largest = 0;
+    for (int t = 0; t < filter.taps; t++)
+    {
+      out[t] = static_cast<int16_t>(std::lround(weights[t] / sum * FILTER_ONE));
+      total += out[t];
+      if (out[t] > out[largest])
+        largest = t;
+    }
+    out[largest] += FILTER_ONE - total;
+    filter.offsets[i] = offset;
+  }
+  return filter;
+}
+
+void CSWFrameScaler::ConvertRow(int row, uint8_t* dst)
+{
+  const int chromaRow = row >> 1;
+  switch (m_format)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+      m_kernels.I420ToRGBA(m_planes[0] + row * m_strides[0], m_planes[1] + chromaRow * m_strides[1],
+                           m_planes[2] + chromaRow * m_strides[2], dst, m_srcWidth, m_coefs);
+      break;
+    case AV_PIX_FMT_NV12:
+      m_kernels.NV12ToRGBA(m_planes[0] + row * m_strides[0], m_planes[1] + chromaRow * m_strides[1],
+                           dst, m_srcWidth, m_coefs);
+      break;
+    case AV_PIX_FMT_P010:
+      m_kernels.P010ToRGBA(
+          reinterpret_cast<const uint16_t*>(m_planes[0] + row * m_strides[0]),
+          reinterpret_cast<const uint16_t*>(m_planes[1] + chromaRow * m_strides[1]), dst,
+          m_srcWidth, m_coefs);
+      break;
+    default:
+      break;
+  }
+}
+
+const uint8_t* CSWFrameScaler::GetRow(int row)
+{
+  // the rows of one output row are consecutive, they never share a slot
+  const int slot = row % m_filterY.taps;
+  uint8_t* out = m_rows[slot].data();
+  if (m_rowIndex[slot] == row)
+    return out;
+
+  if (m_filterX.identity)
+  {
+    ConvertRow(row, out);
+  }
+  else
+  {
+    ConvertRow(row, m_convertRow.data());
+    m_kernels.FilterPixels(m_convertRow.data(), m_filterX.offsets.data(),
+                           m_filterX.weights.data(), m_filterX.taps, out, m_dstWidth);
+  }
+  m_rowIndex[slot] = row;
+  return out;
+}
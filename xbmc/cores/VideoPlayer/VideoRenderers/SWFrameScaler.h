@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "SWRenderKernels.h"
+#include "cores/VideoSettings.h"
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+/*!
+ * \brief Converts YUV frames to RGBA and scales them, on the cpu
+ *
+ * Scaling is separable: source rows are converted and filtered horizontally
+ * once, into a ring of as many rows as the vertical filter has taps, then
+ * every output row is filtered from that ring. The output only depends on
+ * the input, the results of all kernel sets are the same.
+ */
+class CSWFrameScaler
+{
+public:
+  CSWFrameScaler();
+  explicit CSWFrameScaler(const SWRenderKernels& kernels);
+
+  static bool IsSupported(AVPixelFormat format);
+  static bool Supports(ESCALINGMETHOD method);
+
+  /*!
+   * \brief Set up the filters, cheap if nothing changed since the last call
+   * \param srcWidth, srcHeight size of the source, after cropping
+   */
+  bool Configure(AVPixelFormat format,
+                 int srcWidth,
+                 int srcHeight,
+                 AVColorSpace colorSpace,
+                 bool fullRange,
+                 int dstWidth,
+                 int dstHeight,
+                 ESCALINGMETHOD method);
+
+  /*!
+   * \brief Move the plane pointers to the pixel at x, y of the source
+   * \param x, y are rounded down to even values, to keep the chroma aligned
+   */
+  static void CropPlanes(AVPixelFormat format,
+                         uint8_t* (&planes)[3],
+                         const int (&strides)[3],
+                         int x,
+                         int y);
+
+  /*!
+   * \brief Convert and scale one frame
+   * \param dst dstHeight rows of dstWidth RGBA pixels, dstStride bytes apart
+   */
+  void Scale(uint8_t* const (&planes)[3], const int (&strides)[3], uint8_t* dst, int dstStride);
+
+  const char* GetKernelName() const { return m_kernels.name; }
+
+private:
+  struct Filter
+  {
+    bool identity = false;
+    int taps = 0;
+    std::vector<int> offsets; // first source pixel of every output pixel
+    std::vector<int16_t> weights; // taps per output pixel
+  };
+
+  static Filter CreateFilter(int srcSize, int dstSize, ESCALINGMETHOD method);
+  void ConvertRow(int row, uint8_t* dst);
+  //! source row, converted and filtered horizontally
+  const uint8_t* GetRow(int row);
+
+  const SWRenderKernels& m_kernels;
+
+  AVPixelFormat m_format = AV_PIX_FMT_NONE;
+  int m_srcWidth = 0;
+  int m_srcHeight = 0;
+  AVColorSpace m_colorSpace = AVCOL_SPC_UNSPECIFIED;
+  bool m_fullRange = false;
+  int m_dstWidth = 0;
+  int m_dstHeight = 0;
+  ESCALINGMETHOD m_method = VS_SCALINGMETHOD_AUTO;
+
+  SWYuvCoefs m_coefs{};
+  Filter m_filterX;
+  Filter m_filterY;
+
+  std::vector<uint8_t> m_convertRow;
+  std::vector<std::vector<uint8_t>> m_rows;
+  std::vector<int> m_rowIndex;
+  std::vector<const uint8_t*> m_rowPointers;
+
+  // frame of the running Scale call
+  uint8_t* m_planes[3] = {};
+  int m_strides[3] = {};
+};
@@ -0,0 +1,523 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SWRenderKernels.h"
+
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SW_RENDER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SW_TARGET(x)
+#else
+#define SW_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
+#if defined(HAS_NEON) && (defined(__arm__) || defined(__aarch64__))
+#define SW_RENDER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+constexpr int FILTER_BITS = SWRenderKernels::FILTER_BITS;
+constexpr int FILTER_ROUND = 1 << (FILTER_BITS - 1);
+
+// fractional bits of the 8 bit matrix, 10 bit sources use two more
+constexpr int MATRIX_BITS = 13;
+
+inline uint32_t LoadU32(const void* src)
+{
+  uint32_t value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+inline void StoreU32(void* dst, uint32_t value)
+{
+  std::memcpy(dst, &value, sizeof(value));
+}
+
+inline uint8_t Clamp8(int value)
+{
+  return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+//------------------------------------------------------------------------------
+// scalar reference
+//------------------------------------------------------------------------------
+
+inline void StoreRGBA(int y, int u, int v, uint8_t* dst, const SWYuvCoefs& c)
+{
+  const int luma = (y - c.yOffset) * c.yMul + c.round;
+  u -= c.cOffset;
+  v -= c.cOffset;
+  dst[0] = Clamp8((luma + c.rv * v) >> c.shift);
+  dst[1] = Clamp8((luma + c.gu * u + c.gv * v) >> c.shift);
+  dst[2] = Clamp8((luma + c.bu * u) >> c.shift);
+  dst[3] = 255;
+}
+
+void I420ToRGBAC(const uint8_t* y,
+                 const uint8_t* u,
+                 const uint8_t* v,
+                 uint8_t* dst,
+                 int width,
+                 const SWYuvCoefs& coefs)
+{
+  for (int x = 0; x < width; x++)
+    StoreRGBA(y[x], u[x >> 1], v[x >> 1], dst + x * 4, coefs);
+}
+
+void NV12ToRGBAC(
+    const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  for (int x = 0; x < width; x++)
+    StoreRGBA(y[x], uv[(x >> 1) * 2], uv[(x >> 1) * 2 + 1], dst + x * 4, coefs);
+}
+
+void P010ToRGBAC(
+    const uint16_t* y, const uint16_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  for (int x = 0; x < width; x++)
+    StoreRGBA(y[x] >> 6, uv[(x >> 1) * 2] >> 6, uv[(x >> 1) * 2 + 1] >> 6, dst + x * 4, coefs);
+}
+
+void FilterPixelsC(const uint8_t* src,
+                   const int* offsets,
+                   const int16_t* weights,
+                   int taps,
+                   uint8_t* dst,
+                   int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    const uint8_t* pixel = src + offsets[i] * 4;
+    const int16_t* weight = weights + i * taps;
+    int acc[4] = {FILTER_ROUND, FILTER_ROUND, FILTER_ROUND, FILTER_ROUND};
+    for (int t = 0; t < taps; t++)
+    {
+      for (int c = 0; c < 4; c++)
+        acc[c] += weight[t] * pixel[t * 4 + c];
+    }
+    for (int c = 0; c < 4; c++)
+      dst[i * 4 + c] = Clamp8(acc[c] >> FILTER_BITS);
+  }
+}
+
+void FilterRowsRange(const uint8_t* const* rows,
+                     const int16_t* weights,
+                     int taps,
+                     uint8_t* dst,
+                     int begin,
+                     int end)
+{
+  for (int i = begin; i < end; i++)
+  {
+    int acc = FILTER_ROUND;
+    for (int t = 0; t < taps; t++)
+      acc += weights[t] * rows[t][i];
+    dst[i] = Clamp8(acc >> FILTER_BITS);
+  }
+}
+
+void FilterRowsC(
+    const uint8_t* const* rows, const int16_t* weights, int taps, uint8_t* dst, int count)
+{
+  FilterRowsRange(rows, weights, taps, dst, 0, count);
+}
+
+const SWRenderKernels kernelsC = {"C",           I420ToRGBAC,   NV12ToRGBAC,
+                                  P010ToRGBAC,   FilterPixelsC, FilterRowsC};
+
+#if defined(SW_RENDER_X86)
+//------------------------------------------------------------------------------
+// AVX2, 8 pixels per step
+//------------------------------------------------------------------------------
+
+SW_TARGET("avx2") inline __m256i ToRGBAAVX2(__m256i y, __m256i u, __m256i v, const SWYuvCoefs& c)
+{
+  const __m128i shift = _mm_cvtsi32_si128(c.shift);
+  const __m256i luma = _mm256_add_epi32(
+      _mm256_mullo_epi32(_mm256_sub_epi32(y, _mm256_set1_epi32(c.yOffset)),
+                         _mm256_set1_epi32(c.yMul)),
+      _mm256_set1_epi32(c.round));
+  u = _mm256_sub_epi32(u, _mm256_set1_epi32(c.cOffset));
+  v = _mm256_sub_epi32(v, _mm256_set1_epi32(c.cOffset));
+
+  __m256i r = _mm256_add_epi32(luma, _mm256_mullo_epi32(v, _mm256_set1_epi32(c.rv)));
+  __m256i g = _mm256_add_epi32(luma, _mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(c.gu)),
+                                                      _mm256_mullo_epi32(v, _mm256_set1_epi32(c.gv))));
+  __m256i b = _mm256_add_epi32(luma, _mm256_mullo_epi32(u, _mm256_set1_epi32(c.bu)));
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max = _mm256_set1_epi32(255);
+  r = _mm256_min_epi32(_mm256_max_epi32(_mm256_sra_epi32(r, shift), zero), max);
+  g = _mm256_min_epi32(_mm256_max_epi32(_mm256_sra_epi32(g, shift), zero), max);
+  b = _mm256_min_epi32(_mm256_max_epi32(_mm256_sra_epi32(b, shift), zero), max);
+
+  // little endian, the bytes in memory are R, G, B, A
+  return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(b, 16),
+                                         _mm256_set1_epi32(static_cast<int>(0xFF000000))));
+}
+
+SW_TARGET("avx2") void I420ToRGBAAVX2(const uint8_t* y,
+                                      const uint8_t* u,
+                                      const uint8_t* v,
+                                      uint8_t* dst,
+                                      int width,
+                                      const SWYuvCoefs& coefs)
+{
+  const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m256i yv =
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)));
+    const __m256i uv = _mm256_permutevar8x32_epi32(
+        _mm256_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(LoadU32(u + x / 2)))), dup);
+    const __m256i vv = _mm256_permutevar8x32_epi32(
+        _mm256_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(LoadU32(v + x / 2)))), dup);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), ToRGBAAVX2(yv, uv, vv, coefs));
+  }
+  _mm256_zeroupper();
+  I420ToRGBAC(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, coefs);
+}
+
+SW_TARGET("avx2") void NV12ToRGBAAVX2(
+    const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  const __m256i dupU = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+  const __m256i dupV = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m256i yv =
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)));
+    const __m256i uvv =
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv + x)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4),
+                        ToRGBAAVX2(yv, _mm256_permutevar8x32_epi32(uvv, dupU),
+                                   _mm256_permutevar8x32_epi32(uvv, dupV), coefs));
+  }
+  _mm256_zeroupper();
+  NV12ToRGBAC(y + x, uv + x, dst + x * 4, width - x, coefs);
+}
+
+SW_TARGET("avx2") void P010ToRGBAAVX2(
+    const uint16_t* y, const uint16_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  const __m256i dupU = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+  const __m256i dupV = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m256i yv = _mm256_srli_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x))), 6);
+    const __m256i uvv = _mm256_srli_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x))), 6);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4),
+                        ToRGBAAVX2(yv, _mm256_permutevar8x32_epi32(uvv, dupU),
+                                   _mm256_permutevar8x32_epi32(uvv, dupV), coefs));
+  }
+  _mm256_zeroupper();
+  P010ToRGBAC(y + x, uv + x, dst + x * 4, width - x, coefs);
+}
+
+SW_TARGET("avx2") void FilterPixelsAVX2(const uint8_t* src,
+                                        const int* offsets,
+                                        const int16_t* weights,
+                                        int taps,
+                                        uint8_t* dst,
+                                        int count)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max = _mm_set1_epi32(255);
+  for (int i = 0; i < count; i++)
+  {
+    const uint8_t* pixel = src + offsets[i] * 4;
+    const int16_t* weight = weights + i * taps;
+
+    // two taps per step, one in each lane
+    __m256i acc2 = _mm256_setzero_si256();
+    int t = 0;
+    for (; t + 2 <= taps; t += 2)
+    {
+      const __m256i px =
+          _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel + t * 4)));
+      const __m256i w = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_set1_epi32(weight[t])), _mm_set1_epi32(weight[t + 1]), 1);
+      acc2 = _mm256_add_epi32(acc2, _mm256_mullo_epi32(px, w));
+    }
+    __m128i acc = _mm_add_epi32(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1));
+    acc = _mm_add_epi32(acc, _mm_set1_epi32(FILTER_ROUND));
+    if (t < taps)
+    {
+      const __m128i px = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(LoadU32(pixel + t * 4))));
+      acc = _mm_add_epi32(acc, _mm_mullo_epi32(px, _mm_set1_epi32(weight[t])));
+    }
+
+    acc = _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(acc, FILTER_BITS), zero), max);
+    acc = _mm_packus_epi16(_mm_packus_epi32(acc, acc), zero);
+    StoreU32(dst + i * 4, static_cast<uint32_t>(_mm_cvtsi128_si32(acc)));
+  }
+  _mm256_zeroupper();
+}
+
+SW_TARGET("avx2") void FilterRowsAVX2(
+    const uint8_t* const* rows, const int16_t* weights, int taps, uint8_t* dst, int count)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max = _mm256_set1_epi32(255);
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i acc = _mm256_set1_epi32(FILTER_ROUND);
+    for (int t = 0; t < taps; t++)
+    {
+      const __m256i px =
+          _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows[t] + i)));
+      acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(px, _mm256_set1_epi32(weights[t])));
+    }
+    acc = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(acc, FILTER_BITS), zero), max);
+    __m128i out =
+        _mm_packus_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(out, out));
+  }
+  _mm256_zeroupper();
+  FilterRowsRange(rows, weights, taps, dst, i, count);
+}
+
+const SWRenderKernels kernelsAVX2 = {"AVX2",           I420ToRGBAAVX2,   NV12ToRGBAAVX2,
+                                     P010ToRGBAAVX2,   FilterPixelsAVX2, FilterRowsAVX2};
+#endif
+
+#if defined(SW_RENDER_NEON)
+//------------------------------------------------------------------------------
+// NEON, 8 pixels per step
+//------------------------------------------------------------------------------
+
+inline int32x4_t Widen(uint16x4_t value)
+{
+  return vreinterpretq_s32_u32(vmovl_u16(value));
+}
+
+inline uint8x8_t Narrow(int32x4_t lo, int32x4_t hi)
+{
+  // saturating, the same as clamping to [0, 255]
+  return vqmovn_u16(vcombine_u16(vqmovun_s32(lo), vqmovun_s32(hi)));
+}
+
+inline void StoreRGBANEON(
+    uint16x8_t y, uint16x8_t u, uint16x8_t v, uint8_t* dst, const SWYuvCoefs& c)
+{
+  // a negative shift count shifts right
+  const int32x4_t shift = vdupq_n_s32(-c.shift);
+  const int32x4_t yOffset = vdupq_n_s32(c.yOffset);
+  const int32x4_t cOffset = vdupq_n_s32(c.cOffset);
+  const int32x4_t round = vdupq_n_s32(c.round);
+
+  int32x4_t r[2], g[2], b[2];
+  for (int h = 0; h < 2; h++)
+  {
+    const int32x4_t yy = Widen(h ? vget_high_u16(y) : vget_low_u16(y));
+    const int32x4_t uu = vsubq_s32(Widen(h ? vget_high_u16(u) : vget_low_u16(u)), cOffset);
+    const int32x4_t vv = vsubq_s32(Widen(h ? vget_high_u16(v) : vget_low_u16(v)), cOffset);
+    const int32x4_t luma = vaddq_s32(vmulq_n_s32(vsubq_s32(yy, yOffset), c.yMul), round);
+    r[h] = vshlq_s32(vmlaq_n_s32(luma, vv, c.rv), shift);
+    g[h] = vshlq_s32(vmlaq_n_s32(vmlaq_n_s32(luma, uu, c.gu), vv, c.gv), shift);
+    b[h] = vshlq_s32(vmlaq_n_s32(luma, uu, c.bu), shift);
+  }
+
+  uint8x8x4_t pixels;
+  pixels.val[0] = Narrow(r[0], r[1]);
+  pixels.val[1] = Narrow(g[0], g[1]);
+  pixels.val[2] = Narrow(b[0], b[1]);
+  pixels.val[3] = vdup_n_u8(255);
+  vst4_u8(dst, pixels);
+}
+
+void I420ToRGBANEON(const uint8_t* y,
+                    const uint8_t* u,
+                    const uint8_t* v,
+                    uint8_t* dst,
+                    int width,
+                    const SWYuvCoefs& coefs)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const uint8x8_t u4 = vreinterpret_u8_u32(vdup_n_u32(LoadU32(u + x / 2)));
+    const uint8x8_t v4 = vreinterpret_u8_u32(vdup_n_u32(LoadU32(v + x / 2)));
+    StoreRGBANEON(vmovl_u8(vld1_u8(y + x)), vmovl_u8(vzip_u8(u4, u4).val[0]),
+                  vmovl_u8(vzip_u8(v4, v4).val[0]), dst + x * 4, coefs);
+  }
+  I420ToRGBAC(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, coefs);
+}
+
+void NV12ToRGBANEON(
+    const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const uint8x8_t uv4 = vld1_u8(uv + x);
+    const uint8x8x2_t split = vuzp_u8(uv4, uv4);
+    StoreRGBANEON(vmovl_u8(vld1_u8(y + x)), vmovl_u8(vzip_u8(split.val[0], split.val[0]).val[0]),
+                  vmovl_u8(vzip_u8(split.val[1], split.val[1]).val[0]), dst + x * 4, coefs);
+  }
+  NV12ToRGBAC(y + x, uv + x, dst + x * 4, width - x, coefs);
+}
+
+void P010ToRGBANEON(
+    const uint16_t* y, const uint16_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const uint16x8_t uv4 = vshrq_n_u16(vld1q_u16(uv + x), 6);
+    const uint16x8x2_t split = vuzpq_u16(uv4, uv4);
+    StoreRGBANEON(vshrq_n_u16(vld1q_u16(y + x), 6), vzipq_u16(split.val[0], split.val[0]).val[0],
+                  vzipq_u16(split.val[1], split.val[1]).val[0], dst + x * 4, coefs);
+  }
+  P010ToRGBAC(y + x, uv + x, dst + x * 4, width - x, coefs);
+}
+
+void FilterPixelsNEON(const uint8_t* src,
+                      const int* offsets,
+                      const int16_t* weights,
+                      int taps,
+                      uint8_t* dst,
+                      int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    const uint8_t* pixel = src + offsets[i] * 4;
+    const int16_t* weight = weights + i * taps;
+    int32x4_t acc = vdupq_n_s32(FILTER_ROUND);
+    for (int t = 0; t < taps; t++)
+    {
+      const uint8x8_t px = vreinterpret_u8_u32(vdup_n_u32(LoadU32(pixel + t * 4)));
+      acc = vmlaq_n_s32(acc, Widen(vget_low_u16(vmovl_u8(px))), weight[t]);
+    }
+    acc = vshrq_n_s32(acc, FILTER_BITS);
+    StoreU32(dst + i * 4, vget_lane_u32(vreinterpret_u32_u8(Narrow(acc, acc)), 0));
+  }
+}
+
+void FilterRowsNEON(
+    const uint8_t* const* rows, const int16_t* weights, int taps, uint8_t* dst, int count)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int32x4_t lo = vdupq_n_s32(FILTER_ROUND);
+    int32x4_t hi = vdupq_n_s32(FILTER_ROUND);
+    for (int t = 0; t < taps; t++)
+    {
+      const uint16x8_t px = vmovl_u8(vld1_u8(rows[t] + i));
+      lo = vmlaq_n_s32(lo, Widen(vget_low_u16(px)), weights[t]);
+      hi = vmlaq_n_s32(hi, Widen(vget_high_u16(px)), weights[t]);
+    }
+    vst1_u8(dst + i, Narrow(vshrq_n_s32(lo, FILTER_BITS), vshrq_n_s32(hi, FILTER_BITS)));
+  }
+  FilterRowsRange(rows, weights, taps, dst, i, count);
+}
+
+const SWRenderKernels kernelsNEON = {"NEON",           I420ToRGBANEON,   NV12ToRGBANEON,
+                                     P010ToRGBANEON,   FilterPixelsNEON, FilterRowsNEON};
+#endif
+} // namespace
+
+SWYuvCoefs SWRenderKernels::GetCoefs(AVColorSpace colorSpace, bool fullRange, int bits)
+{
+  double kr;
+  double kb;
+  switch (colorSpace)
+  {
+    case AVCOL_SPC_BT470BG:
+    case AVCOL_SPC_SMPTE170M:
+      kr = 0.299;
+      kb = 0.114;
+      break;
+    case AVCOL_SPC_SMPTE240M:
+      kr = 0.212;
+      kb = 0.087;
+      break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+      kr = 0.2627;
+      kb = 0.0593;
+      break;
+    default:
+      kr = 0.2126;
+      kb = 0.0722;
+      break;
+  }
+  const double kg = 1.0 - kr - kb;
+
+  // scale of a source sample to 8 bit, for the luma and the chroma excursion
+  const int depth = bits - 8;
+  double yScale;
+  double cScale;
+  if (fullRange)
+  {
+    yScale = cScale = 255.0 * (1 << depth) / ((1 << bits) - 1);
+  }
+  else
+  {
+    yScale = 255.0 / 219.0;
+    cScale = 255.0 / 224.0;
+  }
+
+  const double unit = 1 << MATRIX_BITS;
+  SWYuvCoefs coefs;
+  coefs.yOffset = fullRange ? 0 : 16 << depth;
+  coefs.cOffset = 128 << depth;
+  coefs.yMul = static_cast<int>(std::lround(yScale * unit));
+  coefs.rv = static_cast<int>(std::lround(2.0 * (1.0 - kr) * cScale * unit));
+  coefs.gu = static_cast<int>(std::lround(-2.0 * (1.0 - kb) * kb / kg * cScale * unit));
+  coefs.gv = static_cast<int>(std::lround(-2.0 * (1.0 - kr) * kr / kg * cScale * unit));
+  coefs.bu = static_cast<int>(std::lround(2.0 * (1.0 - kb) * cScale * unit));
+  coefs.shift = MATRIX_BITS + depth;
+  coefs.round = 1 << (coefs.shift - 1);
+  return coefs;
+}
+
+const SWRenderKernels& SWRenderKernels::GetReference()
+{
+  return kernelsC;
+}
+
+std::vector<const SWRenderKernels*> SWRenderKernels::GetSupported(unsigned int cpuFeatures)
+{
+  std::vector<const SWRenderKernels*> kernels{&kernelsC};
+#if defined(SW_RENDER_X86)
+  if (cpuFeatures & CPU_FEATURE_AVX2)
+    kernels.push_back(&kernelsAVX2);
+#endif
+#if defined(SW_RENDER_NEON)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+    kernels.push_back(&kernelsNEON);
+#endif
+  return kernels;
+}
+
+const SWRenderKernels& SWRenderKernels::Get()
+{
+  static const SWRenderKernels* kernels =
+      GetSupported(CCPUInfo::GetCPUInfo()->GetCPUFeatures()).back();
+  return *kernels;
+}
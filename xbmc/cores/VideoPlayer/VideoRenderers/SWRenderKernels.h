@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+/*!
+ * \brief Fixed point YUV to RGB matrix, see SWRenderKernels::GetCoefs
+ *
+ * R = ((Y - yOffset) * yMul + round + rv * (V - cOffset)) >> shift, same for G and B
+ */
+struct SWYuvCoefs
+{
+  int yOffset;
+  int cOffset;
+  int yMul;
+  int rv;
+  int gu;
+  int gv;
+  int bu;
+  int round;
+  int shift;
+};
+
+/*!
+ * \brief Row kernels of the software video renderer
+ *
+ * There is one set per instruction set, Get() returns the best one the
+ * cpu supports. All sets use the same integer math and give results that
+ * are bit exact to the scalar reference. Output pixels are RGBA, 8 bit per
+ * channel, chroma of 4:2:0 formats is upsampled by repeating it.
+ */
+struct SWRenderKernels
+{
+  const char* name;
+
+  //! 8 bit planar 4:2:0
+  void (*I420ToRGBA)(const uint8_t* y,
+                     const uint8_t* u,
+                     const uint8_t* v,
+                     uint8_t* dst,
+                     int width,
+                     const SWYuvCoefs& coefs);
+
+  //! 8 bit 4:2:0 with interleaved chroma
+  void (*NV12ToRGBA)(
+      const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs);
+
+  //! 10 bit in the upper bits of 16 bit samples, 4:2:0 with interleaved chroma
+  void (*P010ToRGBA)(
+      const uint16_t* y, const uint16_t* uv, uint8_t* dst, int width, const SWYuvCoefs& coefs);
+
+  /*!
+   * \brief Horizontal pass of the scaler
+   *
+   * dst pixel i is the sum of taps RGBA pixels of src, starting at pixel
+   * offsets[i], weighted by weights[i * taps] and following.
+   */
+  void (*FilterPixels)(const uint8_t* src,
+                       const int* offsets,
+                       const int16_t* weights,
+                       int taps,
+                       uint8_t* dst,
+                       int count);
+
+  /*!
+   * \brief Vertical pass of the scaler, dst is the weighted sum of taps rows
+   * \param count number of bytes per row
+   */
+  void (*FilterRows)(
+      const uint8_t* const* rows, const int16_t* weights, int taps, uint8_t* dst, int count);
+
+  //! weights of the filter kernels are fixed point with this many fractional bits
+  static constexpr int FILTER_BITS = 14;
+
+  /*!
+   * \brief Matrix for the given source, output is always full range RGB
+   * \param bits 8 or 10, the bit depth of the source samples
+   */
+  static SWYuvCoefs GetCoefs(AVColorSpace colorSpace, bool fullRange, int bits);
+
+  /*!
+   * \brief Kernels for this cpu, selected on first use
+   */
+  static const SWRenderKernels& Get();
+
+  static const SWRenderKernels& GetReference();
+
+  /*!
+   * \brief All kernel sets that can run with the given CpuFeature flags,
+   * reference first and best last
+   */
+  static std::vector<const SWRenderKernels*> GetSupported(unsigned int cpuFeatures);
+};
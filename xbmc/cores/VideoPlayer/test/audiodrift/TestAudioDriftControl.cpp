@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/AudioDriftControl.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CAESyncInfo MakeInfo(double error, unsigned int errortime, double rr = 1.0)
+{
+  CAESyncInfo info;
+  info.delay = 0.0;
+  info.error = error;
+  info.rr = rr;
+  info.errortime = errortime;
+  info.state = CAESyncInfo::SYNC_INSYNC;
+  return info;
+}
+} // namespace
+
+TEST(TestAudioDriftControl, NoUpdateWithoutNewError)
+{
+  CAudioDriftControl control;
+
+  EXPECT_TRUE(control.Update(MakeInfo(0.0, 1), MakeInfo(10.0, 1)));
+  EXPECT_FALSE(control.Update(MakeInfo(0.0, 2), MakeInfo(10.0, 1)));
+}
+
+TEST(TestAudioDriftControl, NoUpdateOutOfSync)
+{
+  CAudioDriftControl control;
+  CAESyncInfo info2 = MakeInfo(10.0, 1);
+  info2.state = CAESyncInfo::SYNC_ADJUST;
+
+  EXPECT_FALSE(control.Update(MakeInfo(0.0, 1), info2));
+  EXPECT_DOUBLE_EQ(control.GetRatio(), 1.0);
+}
+
+TEST(TestAudioDriftControl, SlowsDownLeadingOutput)
+{
+  CAudioDriftControl control;
+
+  // 2nd output ahead of the 1st one needs to be stretched
+  ASSERT_TRUE(control.Update(MakeInfo(5.0, 1), MakeInfo(15.0, 1)));
+  EXPECT_DOUBLE_EQ(control.GetError(), 10.0);
+  EXPECT_GT(control.GetRatio(), 1.0);
+
+  control.Reset();
+  ASSERT_TRUE(control.Update(MakeInfo(5.0, 1), MakeInfo(-5.0, 1)));
+  EXPECT_LT(control.GetRatio(), 1.0);
+}
+
+TEST(TestAudioDriftControl, FollowsRatioOfFirstOutput)
+{
+  CAudioDriftControl control;
+
+  ASSERT_TRUE(control.Update(MakeInfo(0.0, 1, 1.001), MakeInfo(0.0, 1)));
+  EXPECT_DOUBLE_EQ(control.GetRatio(), 1.001);
+}
+
+TEST(TestAudioDriftControl, CorrectionIsBounded)
+{
+  CAudioDriftControl control;
+
+  for (unsigned int i = 1; i < 100; i++)
+    control.Update(MakeInfo(0.0, i), MakeInfo(900.0, i));
+
+  EXPECT_DOUBLE_EQ(control.GetCorrection(), CAudioDriftControl::MAX_CORRECTION);
+  EXPECT_DOUBLE_EQ(control.GetRatio(), 1.0 + CAudioDriftControl::MAX_CORRECTION);
+}
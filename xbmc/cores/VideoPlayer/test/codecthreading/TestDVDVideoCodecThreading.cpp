@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecThreading.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using Type = CDVDVideoCodecThreading::Type;
+
+constexpr int BOTH = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS;
+
+// decode a window of frames with some of them dropped
+bool DecodeWindow(CDVDVideoCodecThreading& threading, int frames, int dropped)
+{
+  bool raise = false;
+  for (int i = 0; i < frames; i++)
+    raise = threading.AddFrame(i < dropped, frames);
+  return raise;
+}
+} // namespace
+
+TEST(TestDVDVideoCodecThreading, FollowsPixelRate)
+{
+  CDVDVideoCodecThreading threading(8);
+
+  // uhd hevc needs all but the reserved cores
+  auto decision = threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0);
+  EXPECT_EQ(decision.type, Type::FRAME);
+  EXPECT_EQ(decision.threads, 6);
+
+  decision = threading.Select(AV_CODEC_ID_H264, BOTH, 1920, 1080, 24.0);
+  EXPECT_EQ(decision.type, Type::FRAME);
+  EXPECT_EQ(decision.threads, 2);
+
+  // sd mpeg-2 is light and has no frame threading
+  decision = threading.Select(AV_CODEC_ID_MPEG2VIDEO, AV_CODEC_CAP_SLICE_THREADS, 720, 576, 25.0);
+  EXPECT_EQ(decision.type, Type::SLICE);
+  EXPECT_EQ(decision.threads, 2);
+  EXPECT_EQ(decision.ToString(), "slice/2");
+}
+
+TEST(TestDVDVideoCodecThreading, Capabilities)
+{
+  CDVDVideoCodecThreading threading(8);
+
+  auto decision = threading.Select(AV_CODEC_ID_AV1, AV_CODEC_CAP_OTHER_THREADS, 1920, 1080, 30.0);
+  EXPECT_EQ(decision.type, Type::CODEC);
+  EXPECT_EQ(decision.threads, 4);
+
+  decision = threading.Select(AV_CODEC_ID_VC1, 0, 1920, 1080, 30.0);
+  EXPECT_EQ(decision.type, Type::SINGLE);
+  EXPECT_EQ(decision.threads, 1);
+  EXPECT_EQ(decision.ToString(), "single");
+
+  // a single core is never shared
+  CDVDVideoCodecThreading singleCore(1);
+  decision = singleCore.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0);
+  EXPECT_EQ(decision.type, Type::SINGLE);
+  EXPECT_EQ(decision.threads, 1);
+}
+
+TEST(TestDVDVideoCodecThreading, RaisesOnDrops)
+{
+  CDVDVideoCodecThreading threading(8);
+  auto decision = threading.Select(AV_CODEC_ID_H264, BOTH, 720, 480, 30.0);
+  EXPECT_EQ(decision.type, Type::SLICE);
+
+  // one drop in a hundred frames is fine
+  EXPECT_FALSE(DecodeWindow(threading, 100, 1));
+  EXPECT_EQ(threading.GetLevel(), 0);
+
+  // slices did not help, switch to frame threading
+  EXPECT_TRUE(DecodeWindow(threading, 100, 10));
+  decision = threading.Select(AV_CODEC_ID_H264, BOTH, 720, 480, 30.0);
+  EXPECT_EQ(decision.type, Type::FRAME);
+  EXPECT_EQ(decision.threads, 2);
+
+  EXPECT_TRUE(DecodeWindow(threading, 100, 10));
+  decision = threading.Select(AV_CODEC_ID_H264, BOTH, 720, 480, 30.0);
+  EXPECT_EQ(decision.type, Type::FRAME);
+  EXPECT_EQ(decision.threads, 4);
+
+  // that is as far as it goes
+  EXPECT_FALSE(DecodeWindow(threading, 100, 10));
+  EXPECT_EQ(threading.GetLevel(), CDVDVideoCodecThreading::MAX_LEVEL);
+}
+
+TEST(TestDVDVideoCodecThreading, RaisesOnlyIfItHelps)
+{
+  // slice threading only and already two threads, the next level gives the same
+  CDVDVideoCodecThreading threading(8);
+  threading.Select(AV_CODEC_ID_MPEG2VIDEO, AV_CODEC_CAP_SLICE_THREADS, 720, 576, 25.0);
+  EXPECT_FALSE(DecodeWindow(threading, 100, 50));
+  EXPECT_EQ(threading.GetLevel(), 0);
+
+  // the reserved cores are used once it drops
+  CDVDVideoCodecThreading uhd(8);
+  uhd.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0);
+  EXPECT_TRUE(DecodeWindow(uhd, 100, 10));
+  EXPECT_EQ(uhd.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 8);
+}
+
+TEST(TestDVDVideoCodecThreading, SecondAudioDecoder)
+{
+  CDVDVideoCodecThreading threading(8);
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 6);
+
+  // a 2nd decoder for dual audio takes one more core, the decoder needs a reopen
+  EXPECT_TRUE(threading.SetAudio2Decoding(true));
+  EXPECT_FALSE(threading.SetAudio2Decoding(true));
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 5);
+
+  EXPECT_TRUE(threading.SetAudio2Decoding(false));
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 6);
+
+  // nothing to give up if there is a single core
+  CDVDVideoCodecThreading single(1);
+  single.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0);
+  EXPECT_FALSE(single.SetAudio2Decoding(true));
+}
+
+TEST(TestDVDVideoCodecThreading, DualCodecDecoder)
+{
+  // passthrough switched to a dual codec during playback, its pcm decoder for the
+  // 2nd output is reported like a 2nd codec and takes a core on a 4 core device
+  CDVDVideoCodecThreading threading(4);
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 2);
+  EXPECT_TRUE(threading.SetAudio2Decoding(true));
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 1);
+
+  // once raised for drops the reserve is used anyway, no reopen when it ends
+  EXPECT_TRUE(DecodeWindow(threading, 100, 10));
+  EXPECT_EQ(threading.Select(AV_CODEC_ID_HEVC, BOTH, 3840, 2160, 60.0).threads, 4);
+  EXPECT_FALSE(threading.SetAudio2Decoding(false));
+}
+
+TEST(TestDVDVideoCodecThreading, ResetStats)
+{
+  CDVDVideoCodecThreading threading(8);
+  threading.Select(AV_CODEC_ID_H264, BOTH, 720, 480, 30.0);
+
+  // drops around a seek don't count
+  for (int i = 0; i < 50; i++)
+    threading.AddFrame(true, 100);
+  threading.ResetStats();
+  EXPECT_FALSE(DecodeWindow(threading, 100, 1));
+  EXPECT_EQ(threading.GetLevel(), 0);
+}
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestDemuxPacketPool, BlocksAreAlignedAndUsable)
+{
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+
+  for (size_t size : {size_t(1), CDemuxPacketPool::MIN_BLOCK_SIZE,
+                      CDemuxPacketPool::MIN_BLOCK_SIZE + 1, size_t(100000),
+                      CDemuxPacketPool::MAX_BLOCK_SIZE, CDemuxPacketPool::MAX_BLOCK_SIZE + 1})
+  {
+    void* ptr = pool.Allocate(size);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0u);
+    std::memset(ptr, 0xAB, size);
+    pool.Release(ptr);
+  }
+}
+
+TEST(TestDemuxPacketPool, ReusesBlocks)
+{
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+
+  // warm up the cache of this thread
+  pool.Release(pool.Allocate(1000));
+
+  const CDemuxPacketPool::Stats before = pool.GetStats();
+  for (int i = 0; i < 1000; i++)
+  {
+    void* header = pool.Allocate(100);
+    void* payload = pool.Allocate(1000);
+    ASSERT_NE(header, nullptr);
+    ASSERT_NE(payload, nullptr);
+    pool.Release(payload);
+    pool.Release(header);
+  }
+  const CDemuxPacketPool::Stats after = pool.GetStats();
+
+  EXPECT_EQ(after.requests - before.requests, 2000u);
+  // only the very first header may come from the heap
+  EXPECT_GE(after.hits - before.hits, 1999u);
+}
+
+TEST(TestDemuxPacketPool, AllocateOnOneThreadReleaseOnAnother)
+{
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+  pool.Trim();
+
+  constexpr int PACKETS = 20000;
+  constexpr size_t MAX_QUEUED = 64;
+
+  std::mutex lock;
+  std::condition_variable cond;
+  std::deque<void*> queue;
+  bool done = false;
+
+  const CDemuxPacketPool::Stats before = pool.GetStats();
+
+  // demux -> decode, sizes of a typical video stream
+  std::thread producer([&]() {
+    for (int i = 0; i < PACKETS; i++)
+    {
+      void* ptr = pool.Allocate((i % 25 == 0) ? 200000 : 20000 + (i % 7) * 1000);
+      std::unique_lock<std::mutex> guard(lock);
+      cond.wait(guard, [&]() { return queue.size() < MAX_QUEUED; });
+      queue.push_back(ptr);
+      cond.notify_all();
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    done = true;
+    cond.notify_all();
+  });
+
+  std::thread consumer([&]() {
+    while (true)
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      cond.wait(guard, [&]() { return !queue.empty() || done; });
+      if (queue.empty())
+        break;
+      void* ptr = queue.front();
+      queue.pop_front();
+      cond.notify_all();
+      guard.unlock();
+      pool.Release(ptr);
+    }
+  });
+
+  producer.join();
+  consumer.join();
+  const CDemuxPacketPool::Stats after = pool.GetStats();
+
+  const double hitRate =
+      static_cast<double>(after.hits - before.hits) / (after.requests - before.requests);
+  EXPECT_GT(hitRate, 0.9);
+
+  // both threads have ended, their caches are back in the shared lists
+  EXPECT_GT(after.retainedBytes, 0u);
+  pool.Trim();
+  EXPECT_LT(pool.GetStats().retainedBytes, after.retainedBytes);
+}
+
+TEST(TestDemuxPacketPool, RetainsNoMoreThanTheCap)
+{
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+
+  // every size class on its own stays within its limits, all large ones together would not
+  std::vector<void*> blocks;
+  for (size_t size = 64 * 1024; size <= CDemuxPacketPool::MAX_BLOCK_SIZE; size *= 2)
+  {
+    for (size_t allocated = 0; allocated < (32u << 20); allocated += size)
+      blocks.push_back(pool.Allocate(size));
+    for (void* ptr : blocks)
+      pool.Release(ptr);
+    blocks.clear();
+
+    EXPECT_LE(pool.GetStats().retainedBytes, CDemuxPacketPool::MAX_RETAINED_BYTES);
+  }
+
+  // the blocks of the latest stream still come from the pool
+  const CDemuxPacketPool::Stats before = pool.GetStats();
+  pool.Release(pool.Allocate(CDemuxPacketPool::MAX_BLOCK_SIZE));
+  EXPECT_EQ(pool.GetStats().hits - before.hits, 1u);
+}
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxPrefetch.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// packets carry their number as size, up to the end or a stream change. At
+// m_replaceStream the read replaces stream 0 in place, like CDVDDemuxFFmpeg does
+// when the format of a stream changes.
+class CFakeDemux : public CDVDDemux
+{
+public:
+  bool Reset() override { return true; }
+  void Flush() override {}
+  bool SeekTime(double time, bool backwards, double* startpts) override
+  {
+    m_next = static_cast<int>(time);
+    return true;
+  }
+  std::vector<CDemuxStream*> GetStreams() const override { return {}; }
+  int GetNrOfStreams() const override { return 0; }
+  CDemuxStream* GetStream(int iStreamId) const override
+  {
+    return iStreamId == 0 ? m_stream.get() : nullptr;
+  }
+
+  DemuxPacket* Read() override
+  {
+    m_reads++;
+    if (m_end && m_next > m_end)
+      return nullptr;
+
+    if (m_next == m_replaceStream)
+      m_stream = std::make_unique<CDemuxStream>();
+
+    DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(0);
+    packet->iSize = m_next;
+    packet->iStreamId = m_next == m_streamChange ? DMX_SPECIALID_STREAMCHANGE : 0;
+    m_next++;
+    return packet;
+  }
+
+  int m_next = 1;
+  int m_end = 0;
+  int m_streamChange = 0;
+  int m_replaceStream = 0;
+  std::unique_ptr<CDemuxStream> m_stream = std::make_unique<CDemuxStream>();
+  std::atomic<int> m_reads{0};
+};
+
+// what the player does, with the demux section held
+bool TakePacket(CDVDDemuxPrefetch& prefetch,
+                CCriticalSection& section,
+                DemuxPacket*& packet,
+                bool* oldStream = nullptr)
+{
+  for (int i = 0; i < 500; i++)
+  {
+    {
+      std::unique_lock<CCriticalSection> lock(section);
+      bool old = false;
+      if (prefetch.Read(packet, old))
+      {
+        if (oldStream)
+          *oldStream = old;
+        return true;
+      }
+    }
+    prefetch.WaitForPacket(10ms, false);
+  }
+  return false;
+}
+
+void WaitForReads(const CFakeDemux& demux, int reads)
+{
+  for (int i = 0; i < 500 && demux.m_reads < reads; i++)
+    std::this_thread::sleep_for(1ms);
+}
+} // namespace
+
+TEST(TestDVDDemuxPrefetch, KeepsOrderAndStopsAtTheEnd)
+{
+  CFakeDemux demux;
+  demux.m_end = 1000;
+  CCriticalSection section;
+  CDVDDemuxPrefetch prefetch(demux, section);
+  prefetch.Start();
+
+  DemuxPacket* packet = nullptr;
+  for (int i = 1; i <= 1000; i++)
+  {
+    ASSERT_TRUE(TakePacket(prefetch, section, packet));
+    ASSERT_NE(packet, nullptr);
+    EXPECT_EQ(i, packet->iSize);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  // the empty read gets through and nothing is read past it
+  ASSERT_TRUE(TakePacket(prefetch, section, packet));
+  EXPECT_EQ(packet, nullptr);
+  WaitForReads(demux, 1001);
+  std::this_thread::sleep_for(50ms);
+  EXPECT_GE(demux.m_reads, 1001);
+  EXPECT_LE(demux.m_reads, 1002);
+}
+
+TEST(TestDVDDemuxPrefetch, WaitsForThePlayerAtAStreamChange)
+{
+  CFakeDemux demux;
+  demux.m_streamChange = 5;
+  CCriticalSection section;
+  CDVDDemuxPrefetch prefetch(demux, section);
+  prefetch.Start();
+
+  WaitForReads(demux, 5);
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(5, demux.m_reads);
+
+  DemuxPacket* packet = nullptr;
+  for (int i = 1; i <= 5; i++)
+  {
+    ASSERT_TRUE(TakePacket(prefetch, section, packet));
+    EXPECT_EQ(i, packet->iSize);
+    EXPECT_EQ(i == 5 ? DMX_SPECIALID_STREAMCHANGE : 0, packet->iStreamId);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  // reading goes on once the player has seen the change
+  WaitForReads(demux, 6);
+  EXPECT_GE(demux.m_reads, 6);
+}
+
+TEST(TestDVDDemuxPrefetch, MarksPacketsOfAReplacedStream)
+{
+  CFakeDemux demux;
+  demux.m_replaceStream = 5;
+  CCriticalSection section;
+  CDVDDemuxPrefetch prefetch(demux, section);
+  prefetch.Start();
+
+  // reading stops at the packet whose read replaced the stream
+  WaitForReads(demux, 5);
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(5, demux.m_reads);
+
+  // the packets read before belong to the old stream, the first of the new one does not
+  DemuxPacket* packet = nullptr;
+  for (int i = 1; i <= 5; i++)
+  {
+    bool oldStream = false;
+    ASSERT_TRUE(TakePacket(prefetch, section, packet, &oldStream));
+    EXPECT_EQ(i, packet->iSize);
+    EXPECT_EQ(i < 5, oldStream);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  WaitForReads(demux, 6);
+  bool oldStream = true;
+  ASSERT_TRUE(TakePacket(prefetch, section, packet, &oldStream));
+  EXPECT_EQ(6, packet->iSize);
+  EXPECT_FALSE(oldStream);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxPrefetch, IsBounded)
+{
+  CFakeDemux demux;
+  CCriticalSection section;
+  CDVDDemuxPrefetch prefetch(demux, section);
+  prefetch.Start();
+
+  WaitForReads(demux, static_cast<int>(CDVDDemuxPrefetch::MAX_PACKETS));
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(static_cast<int>(CDVDDemuxPrefetch::MAX_PACKETS), demux.m_reads);
+
+  const SDemuxPrefetchInfo info = prefetch.GetInfo();
+  EXPECT_TRUE(info.active);
+  EXPECT_EQ(CDVDDemuxPrefetch::MAX_PACKETS, static_cast<size_t>(info.packets));
+  EXPECT_EQ(100, info.level);
+}
+
+TEST(TestDVDDemuxPrefetch, SeekDropsWhatWasReadAhead)
+{
+  CFakeDemux demux;
+  CCriticalSection section;
+  CDVDDemuxPrefetch prefetch(demux, section);
+  prefetch.Start();
+
+  DemuxPacket* packet = nullptr;
+  ASSERT_TRUE(TakePacket(prefetch, section, packet));
+  EXPECT_EQ(1, packet->iSize);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  {
+    std::unique_lock<CCriticalSection> lock(section);
+    demux.SeekTime(100000, false, nullptr);
+    prefetch.Flush();
+  }
+
+  ASSERT_TRUE(TakePacket(prefetch, section, packet));
+  EXPECT_EQ(100000, packet->iSize);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::shared_ptr<CDVDMsg> MakePacket(int size, double dts = DVD_NOPTS_VALUE)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts = dts;
+  return std::make_shared<CDVDMsgDemuxerPacket>(packet);
+}
+
+int GetSize(const std::shared_ptr<CDVDMsg>& msg)
+{
+  return std::static_pointer_cast<CDVDMsgDemuxerPacket>(msg)->GetPacket()->iSize;
+}
+} // namespace
+
+TEST(TestDVDMessageQueue, KeepsOrderOfPacketsAndOtherMessages)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(MakePacket(1));
+  queue.Put(std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(MakePacket(2));
+  queue.PutBack(MakePacket(3));
+  queue.Put(std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_EOF), 1);
+
+  std::shared_ptr<CDVDMsg> msg;
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_EOF));
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_EQ(3, GetSize(msg));
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_EQ(1, GetSize(msg));
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_EQ(2, GetSize(msg));
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(msg, 0));
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, FlushRemovesPackets)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  for (int i = 0; i < 10; i++)
+    queue.Put(MakePacket(100));
+  queue.Put(std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(1000, queue.GetDataSize());
+  EXPECT_EQ(10u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  std::shared_ptr<CDVDMsg> msg;
+  ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(msg, 0));
+}
+
+TEST(TestDVDMessageQueue, MoreThanTheSlots)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  const int count = static_cast<int>(CDVDMessageQueue::PACKET_SLOTS) * 2;
+  for (int i = 1; i <= count; i++)
+    queue.Put(MakePacket(i));
+
+  std::shared_ptr<CDVDMsg> msg;
+  for (int i = 1; i <= count; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(msg, 0));
+    ASSERT_EQ(i, GetSize(msg));
+  }
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, ByteAndTimeBudget)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+  queue.SetMaxDataSize(1000);
+  queue.SetMaxTimeSize(4.0);
+
+  EXPECT_EQ(0, queue.GetLevel());
+
+  // no timestamps, the byte budget applies
+  queue.Put(MakePacket(250));
+  EXPECT_EQ(25, queue.GetLevel());
+  queue.Flush();
+
+  // one second of small packets, the time budget applies
+  queue.Put(MakePacket(10, 0.0));
+  queue.Put(MakePacket(10, DVD_TIME_BASE));
+  EXPECT_EQ(25, queue.GetLevel());
+  EXPECT_EQ(1, queue.GetTimeSize());
+
+  // both are in use, the larger one wins
+  queue.Put(MakePacket(480, DVD_TIME_BASE));
+  EXPECT_EQ(50, queue.GetLevel());
+
+  queue.Put(MakePacket(600, DVD_TIME_BASE));
+  EXPECT_TRUE(queue.IsFull());
+}
+
+TEST(TestDVDMessageQueue, ProducerAndConsumerThreads)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  constexpr int count = 20000;
+  std::thread producer([&queue]() {
+    for (int i = 1; i <= count; i++)
+    {
+      queue.Put(MakePacket(i));
+      if (i % 100 == 0)
+        queue.Put(std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_RESYNC));
+    }
+    queue.Put(std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_EOF));
+  });
+
+  int expected = 1;
+  int resyncs = 0;
+  std::shared_ptr<CDVDMsg> msg;
+  while (queue.Get(msg, 5000) == MSGQ_OK)
+  {
+    if (msg->IsType(CDVDMsg::GENERAL_EOF))
+      break;
+    if (msg->IsType(CDVDMsg::GENERAL_RESYNC))
+    {
+      resyncs++;
+      EXPECT_EQ(resyncs * 100 + 1, expected);
+      continue;
+    }
+    ASSERT_EQ(expected, GetSize(msg));
+    expected++;
+  }
+  producer.join();
+
+  EXPECT_EQ(count + 1, expected);
+  EXPECT_EQ(count / 100, resyncs);
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, FlushWhileConsuming)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::atomic<bool> done = false;
+  std::thread consumer([&queue, &done]() {
+    std::shared_ptr<CDVDMsg> msg;
+    while (!done)
+      queue.Get(msg, 10);
+  });
+
+  for (int i = 0; i < 200; i++)
+  {
+    for (int j = 0; j < 50; j++)
+      queue.Put(MakePacket(100));
+    queue.Flush();
+    EXPECT_EQ(0, queue.GetDataSize());
+  }
+  done = true;
+  consumer.join();
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderTrace.h"
+#include "utils/Variant.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// one tick per ms keeps the numbers readable, the counter never starts at 0
+constexpr int64_t FREQUENCY = 1000;
+constexpr int64_t START = 1000;
+
+double PtsFromMs(double ms)
+{
+  return ms * DVD_TIME_BASE / 1000.0;
+}
+
+// decode, queue, render and present a frame at a 40 ms cadence
+void PlayFrame(CRenderTrace& trace, int index, int frame, int64_t presentDelay = 0)
+{
+  const int64_t start = START + frame * 40;
+  trace.Decoded(start);
+  trace.Queued(index, PtsFromMs(start - START), start + 2);
+  trace.Rendered(index, start + 10 + presentDelay);
+  trace.Presented(start + 20 + presentDelay);
+}
+
+unsigned int CountEvents(const CVariant& trace, const std::string& phase)
+{
+  unsigned int count = 0;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == phase)
+      count++;
+  }
+  return count;
+}
+} // namespace
+
+TEST(TestRenderTrace, Latency)
+{
+  CRenderTrace trace(16, FREQUENCY);
+  for (int i = 0; i < 10; i++)
+    PlayFrame(trace, i % 3, i);
+
+  const CRenderTrace::CHistogram latency = trace.GetLatencyHistogram();
+  EXPECT_EQ(latency.samples, 10u);
+  EXPECT_DOUBLE_EQ(latency.sum / latency.samples, 20.0);
+  // 20 ms in bins of 2 ms
+  EXPECT_EQ(latency.counts[10], 10u);
+}
+
+TEST(TestRenderTrace, Jitter)
+{
+  CRenderTrace trace(16, FREQUENCY);
+  PlayFrame(trace, 0, 0);
+  PlayFrame(trace, 1, 1);
+  PlayFrame(trace, 2, 2, 5);
+  PlayFrame(trace, 0, 3, 5);
+  PlayFrame(trace, 1, 4, 100);
+
+  // the first frame has nothing to compare to
+  const CRenderTrace::CHistogram jitter = trace.GetJitterHistogram();
+  EXPECT_EQ(jitter.samples, 4u);
+  EXPECT_EQ(jitter.counts[25], 2u);
+  EXPECT_EQ(jitter.counts[30], 1u);
+  EXPECT_EQ(jitter.overflow, 1u);
+}
+
+TEST(TestRenderTrace, FlushResetsJitter)
+{
+  CRenderTrace trace(16, FREQUENCY);
+  PlayFrame(trace, 0, 0);
+  trace.Queued(1, PtsFromMs(40), START + 42);
+  trace.Dropped(1, CRenderTrace::DropReason::FLUSH, START + 45);
+  PlayFrame(trace, 2, 10);
+
+  EXPECT_EQ(trace.GetJitterHistogram().samples, 0u);
+  EXPECT_EQ(trace.GetLatencyHistogram().samples, 2u);
+}
+
+TEST(TestRenderTrace, DroppedFrames)
+{
+  CRenderTrace trace(16, FREQUENCY);
+  trace.Queued(0, PtsFromMs(0), START);
+  trace.Queued(1, PtsFromMs(40), START + 1);
+  trace.Dropped(0, CRenderTrace::DropReason::LATE, START + 50);
+  // the first reason counts
+  trace.Dropped(0, CRenderTrace::DropReason::FLUSH, START + 60);
+  trace.Rendered(1, START + 55);
+  // a drawn frame is not dropped anymore
+  trace.Dropped(1, CRenderTrace::DropReason::FLUSH, START + 58);
+  trace.Presented(START + 60);
+
+  CVariant result;
+  trace.Export(result);
+  EXPECT_EQ(CountEvents(result, "i"), 1u);
+
+  for (auto it = result["traceEvents"].begin_array(); it != result["traceEvents"].end_array();
+       ++it)
+  {
+    if ((*it)["ph"].asString() == "i")
+    {
+      EXPECT_EQ((*it)["name"].asString(), "dropped: late");
+      EXPECT_DOUBLE_EQ((*it)["ts"].asDouble(), 1050000.0);
+    }
+  }
+  EXPECT_EQ(trace.GetLatencyHistogram().samples, 1u);
+}
+
+TEST(TestRenderTrace, RingKeepsLastFrames)
+{
+  CRenderTrace trace(4, FREQUENCY);
+  for (int i = 0; i < 10; i++)
+    PlayFrame(trace, i % 3, i);
+
+  CVariant result;
+  trace.Export(result);
+  // four thread names, three spans for each of the last four frames
+  EXPECT_EQ(CountEvents(result, "M"), 4u);
+  EXPECT_EQ(CountEvents(result, "X"), 12u);
+
+  // oldest first
+  const CVariant& first = result["traceEvents"][4];
+  EXPECT_EQ(first["name"].asString(), "frame 7");
+  EXPECT_DOUBLE_EQ(first["ts"].asDouble(), 1240000.0);
+  EXPECT_DOUBLE_EQ(first["dur"].asDouble(), 2000.0);
+
+  EXPECT_EQ(result["displayTimeUnit"].asString(), "ms");
+  EXPECT_EQ(result["histograms"]["latency"]["samples"].asUnsignedInteger(), 10u);
+  EXPECT_EQ(result["histograms"]["jitter"]["counts"].size(), 50u);
+}
+
+TEST(TestRenderTrace, Reset)
+{
+  CRenderTrace trace(16, FREQUENCY);
+  PlayFrame(trace, 0, 0);
+  PlayFrame(trace, 1, 1);
+  trace.Reset();
+
+  CVariant result;
+  trace.Export(result);
+  EXPECT_EQ(CountEvents(result, "X"), 0u);
+  EXPECT_EQ(trace.GetLatencyHistogram().samples, 0u);
+  EXPECT_EQ(trace.GetJitterHistogram().samples, 0u);
+}
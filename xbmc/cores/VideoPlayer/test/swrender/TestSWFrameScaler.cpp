@@ -0,0 +1,270 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/SWFrameScaler.h"
+#include "cores/VideoPlayer/VideoRenderers/SWRenderKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct Frame
+{
+  Frame(AVPixelFormat format, int width, int height) : width(width), height(height)
+  {
+    const int bytes = format == AV_PIX_FMT_P010 ? 2 : 1;
+    // padded like decoder output
+    strides[0] = (width * bytes + 63) & ~63;
+    data[0].resize(strides[0] * height);
+    if (format == AV_PIX_FMT_YUV420P)
+    {
+      strides[1] = strides[2] = (width / 2 + 1 + 63) & ~63;
+      data[1].resize(strides[1] * ((height + 1) / 2));
+      data[2].resize(strides[2] * ((height + 1) / 2));
+    }
+    else
+    {
+      strides[1] = strides[0];
+      data[1].resize(strides[1] * ((height + 1) / 2));
+    }
+    for (int i = 0; i < 3; i++)
+      planes[i] = data[i].empty() ? nullptr : data[i].data();
+  }
+
+  int width;
+  int height;
+  std::vector<uint8_t> data[3];
+  uint8_t* planes[3] = {};
+  int strides[3] = {};
+};
+
+Frame GetRandomFrame(AVPixelFormat format, int width, int height, unsigned int seed)
+{
+  Frame frame(format, width, height);
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto& plane : frame.data)
+  {
+    for (auto& byte : plane)
+      byte = static_cast<uint8_t>(dist(gen));
+  }
+  return frame;
+}
+
+Frame GetFlatFrame(AVPixelFormat format, int width, int height, int y, int u, int v)
+{
+  Frame frame(format, width, height);
+  if (format == AV_PIX_FMT_P010)
+  {
+    auto fill = [](std::vector<uint8_t>& plane, uint16_t a, uint16_t b) {
+      for (size_t i = 0; i + 4 <= plane.size(); i += 4)
+      {
+        std::memcpy(&plane[i], &a, 2);
+        std::memcpy(&plane[i + 2], &b, 2);
+      }
+    };
+    // 8 bit values to 10 bit, in the high bits
+    fill(frame.data[0], y << 8, y << 8);
+    fill(frame.data[1], u << 8, v << 8);
+  }
+  else if (format == AV_PIX_FMT_NV12)
+  {
+    std::memset(frame.data[0].data(), y, frame.data[0].size());
+    for (size_t i = 0; i + 2 <= frame.data[1].size(); i += 2)
+    {
+      frame.data[1][i] = u;
+      frame.data[1][i + 1] = v;
+    }
+  }
+  else
+  {
+    std::memset(frame.data[0].data(), y, frame.data[0].size());
+    std::memset(frame.data[1].data(), u, frame.data[1].size());
+    std::memset(frame.data[2].data(), v, frame.data[2].size());
+  }
+  return frame;
+}
+
+std::vector<uint8_t> Scale(const SWRenderKernels& kernels,
+                           const Frame& frame,
+                           AVPixelFormat format,
+                           int dstWidth,
+                           int dstHeight,
+                           ESCALINGMETHOD method)
+{
+  CSWFrameScaler scaler(kernels);
+  EXPECT_TRUE(scaler.Configure(format, frame.width, frame.height, AVCOL_SPC_BT709, false,
+                               dstWidth, dstHeight, method));
+  std::vector<uint8_t> out(dstWidth * dstHeight * 4);
+  scaler.Scale(frame.planes, frame.strides, out.data(), dstWidth * 4);
+  return out;
+}
+
+std::vector<const SWRenderKernels*> GetKernels()
+{
+  return SWRenderKernels::GetSupported(CCPUInfo::GetCPUInfo()->GetCPUFeatures());
+}
+
+constexpr AVPixelFormat FORMATS[] = {AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12, AV_PIX_FMT_P010};
+} // namespace
+
+TEST(TestSWFrameScaler, KernelsMatchReference)
+{
+  const SWRenderKernels& ref = SWRenderKernels::GetReference();
+
+  // odd sizes, so that every kernel runs into its tail handling
+  constexpr int WIDTH = 333;
+  constexpr int HEIGHT = 187;
+  const struct
+  {
+    int width;
+    int height;
+    ESCALINGMETHOD method;
+  } outputs[] = {{WIDTH, HEIGHT, VS_SCALINGMETHOD_LINEAR},
+                 {123, 77, VS_SCALINGMETHOD_LINEAR},
+                 {701, 411, VS_SCALINGMETHOD_CUBIC_CATMULL},
+                 {100, 500, VS_SCALINGMETHOD_CUBIC_MITCHELL},
+                 {641, 93, VS_SCALINGMETHOD_NEAREST}};
+
+  for (AVPixelFormat format : FORMATS)
+  {
+    const Frame frame = GetRandomFrame(format, WIDTH, HEIGHT, format);
+    for (const auto& output : outputs)
+    {
+      const std::vector<uint8_t> expected =
+          Scale(ref, frame, format, output.width, output.height, output.method);
+      for (const auto* kernels : GetKernels())
+      {
+        SCOPED_TRACE(kernels->name);
+        EXPECT_EQ(Scale(*kernels, frame, format, output.width, output.height, output.method),
+                  expected);
+      }
+    }
+  }
+}
+
+TEST(TestSWFrameScaler, ConvertsKnownColors)
+{
+  const struct
+  {
+    int y, u, v;
+    uint8_t r, g, b;
+  } colors[] = {
+      {16, 128, 128, 0, 0, 0}, // black
+      {235, 128, 128, 255, 255, 255}, // white
+      {126, 128, 128, 128, 128, 128}, // gray
+      {63, 102, 240, 255, 0, 0}, // bt.709 red
+      {173, 42, 26, 0, 255, 0}, // bt.709 green
+      {32, 240, 118, 0, 0, 255}, // bt.709 blue
+  };
+
+  for (AVPixelFormat format : FORMATS)
+  {
+    for (const auto& color : colors)
+    {
+      const Frame frame = GetFlatFrame(format, 16, 8, color.y, color.u, color.v);
+      for (const auto* kernels : GetKernels())
+      {
+        SCOPED_TRACE(kernels->name);
+        const std::vector<uint8_t> out =
+            Scale(*kernels, frame, format, 16, 8, VS_SCALINGMETHOD_LINEAR);
+        for (size_t i = 0; i < out.size(); i += 4)
+        {
+          EXPECT_NEAR(out[i], color.r, 2);
+          EXPECT_NEAR(out[i + 1], color.g, 2);
+          EXPECT_NEAR(out[i + 2], color.b, 2);
+          EXPECT_EQ(out[i + 3], 255);
+        }
+      }
+    }
+  }
+}
+
+TEST(TestSWFrameScaler, FlatFramesStayFlat)
+{
+  const Frame frame = GetFlatFrame(AV_PIX_FMT_NV12, 320, 180, 100, 90, 160);
+  const std::vector<uint8_t> expected =
+      Scale(SWRenderKernels::GetReference(), frame, AV_PIX_FMT_NV12, 320, 180,
+            VS_SCALINGMETHOD_NEAREST);
+
+  for (ESCALINGMETHOD method :
+       {VS_SCALINGMETHOD_NEAREST, VS_SCALINGMETHOD_LINEAR, VS_SCALINGMETHOD_CUBIC_B_SPLINE,
+        VS_SCALINGMETHOD_CUBIC_CATMULL, VS_SCALINGMETHOD_CUBIC_0_1})
+  {
+    for (int size : {37, 179, 700})
+    {
+      const std::vector<uint8_t> out =
+          Scale(SWRenderKernels::Get(), frame, AV_PIX_FMT_NV12, size * 16 / 9, size, method);
+      for (size_t i = 0; i < out.size(); i += 4)
+        ASSERT_EQ(std::memcmp(&out[i], &expected[0], 4), 0) << "method " << method;
+    }
+  }
+}
+
+TEST(TestSWFrameScaler, CropsOnEvenPixels)
+{
+  const Frame frame = GetRandomFrame(AV_PIX_FMT_YUV420P, 64, 32, 7);
+  const std::vector<uint8_t> full = Scale(SWRenderKernels::GetReference(), frame,
+                                          AV_PIX_FMT_YUV420P, 64, 32, VS_SCALINGMETHOD_LINEAR);
+
+  uint8_t* planes[3] = {frame.planes[0], frame.planes[1], frame.planes[2]};
+  CSWFrameScaler::CropPlanes(AV_PIX_FMT_YUV420P, planes, frame.strides, 11, 6);
+
+  CSWFrameScaler scaler(SWRenderKernels::GetReference());
+  ASSERT_TRUE(scaler.Configure(AV_PIX_FMT_YUV420P, 54, 26, AVCOL_SPC_BT709, false, 54, 26,
+                               VS_SCALINGMETHOD_LINEAR));
+  std::vector<uint8_t> cropped(54 * 26 * 4);
+  scaler.Scale(planes, frame.strides, cropped.data(), 54 * 4);
+
+  // the crop starts at 10, 6
+  for (int y = 0; y < 26; y++)
+    EXPECT_EQ(std::memcmp(&cropped[y * 54 * 4], &full[((y + 6) * 64 + 10) * 4], 54 * 4), 0);
+}
+
+// timings only, run it with --gtest_also_run_disabled_tests
+TEST(TestSWFrameScaler, DISABLED_Benchmark)
+{
+  const Frame frame = GetRandomFrame(AV_PIX_FMT_NV12, 1920, 1080, 1);
+  const struct
+  {
+    int width;
+    int height;
+    ESCALINGMETHOD method;
+  } outputs[] = {{1920, 1080, VS_SCALINGMETHOD_LINEAR},
+                 {1280, 720, VS_SCALINGMETHOD_LINEAR},
+                 {2560, 1440, VS_SCALINGMETHOD_CUBIC_CATMULL}};
+
+  for (const auto* kernels : GetKernels())
+  {
+    for (const auto& output : outputs)
+    {
+      CSWFrameScaler scaler(*kernels);
+      ASSERT_TRUE(scaler.Configure(AV_PIX_FMT_NV12, 1920, 1080, AVCOL_SPC_BT709, false,
+                                   output.width, output.height, output.method));
+      std::vector<uint8_t> out(output.width * output.height * 4);
+
+      constexpr int FRAMES = 5;
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < FRAMES; i++)
+        scaler.Scale(frame.planes, frame.strides, out.data(), output.width * 4);
+      const std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - start;
+
+      std::cout << kernels->name << " NV12 1920x1080 -> " << output.width << "x" << output.height
+                << ": " << duration.count() / FRAMES << " ms per frame" << std::endl;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/Buffers/VideoBuffer.h"
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavutil/buffer.h>
+}
+
+namespace
+{
+// 1080p and a slightly smaller picture, both yuv420p
+constexpr size_t FRAME_SIZE = 1920 * 1088 * 3 / 2;
+constexpr size_t SMALLER_FRAME_SIZE = 1920 * 1080 * 3 / 2;
+} // namespace
+
+TEST(TestVideoBufferMemory, BlocksAreAlignedAndUsable)
+{
+  std::shared_ptr<CVideoBufferMemory> memory = CVideoBufferMemory::GetInstance();
+
+  for (size_t size : {size_t(1), CVideoBufferMemory::MIN_BLOCK_SIZE, size_t(100000),
+                      CVideoBufferMemory::HUGE_PAGE_SIZE, FRAME_SIZE})
+  {
+    uint8_t* data = memory->Allocate(size);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % CVideoBufferMemory::ALIGNMENT, 0u);
+    std::memset(data, 0xAB, size);
+    memory->Release(data);
+  }
+}
+
+TEST(TestVideoBufferMemory, SimilarSizesShareABucket)
+{
+  std::shared_ptr<CVideoBufferMemory> memory = CVideoBufferMemory::GetInstance();
+
+  uint8_t* data = memory->Allocate(FRAME_SIZE);
+  memory->Release(data);
+
+  const CVideoBufferMemory::Stats before = memory->GetStats();
+  uint8_t* reused = memory->Allocate(SMALLER_FRAME_SIZE);
+  const CVideoBufferMemory::Stats after = memory->GetStats();
+
+  EXPECT_EQ(data, reused);
+  EXPECT_EQ(after.hits - before.hits, 1u);
+  memory->Release(reused);
+}
+
+TEST(TestVideoBufferMemory, SurvivesPoolRelease)
+{
+  CVideoBufferManager manager;
+  std::shared_ptr<CVideoBufferMemory> memory = manager.GetMemory();
+
+  std::vector<CVideoBuffer*> buffers;
+  for (int i = 0; i < 8; i++)
+  {
+    CVideoBuffer* buffer = manager.Get(AV_PIX_FMT_YUV420P, FRAME_SIZE, nullptr);
+    ASSERT_NE(buffer, nullptr);
+    buffers.push_back(buffer);
+  }
+  for (CVideoBuffer* buffer : buffers)
+    buffer->Release();
+
+  // what a codec reopen does, the new pool is configured for the new size
+  manager.ReleasePools();
+
+  const CVideoBufferMemory::Stats before = memory->GetStats();
+  buffers.clear();
+  for (int i = 0; i < 8; i++)
+    buffers.push_back(manager.Get(AV_PIX_FMT_YUV420P, SMALLER_FRAME_SIZE, nullptr));
+  const CVideoBufferMemory::Stats after = memory->GetStats();
+
+  EXPECT_EQ(after.requests - before.requests, 8u);
+  EXPECT_EQ(after.hits - before.hits, 8u);
+
+  for (CVideoBuffer* buffer : buffers)
+    buffer->Release();
+}
+
+TEST(TestVideoBufferMemory, AVBufferReturnsItsBlock)
+{
+  std::shared_ptr<CVideoBufferMemory> memory = CVideoBufferMemory::GetInstance();
+
+  AVBufferRef* buffer = memory->AllocateAVBuffer(FRAME_SIZE);
+  ASSERT_NE(buffer, nullptr);
+  uint8_t* data = buffer->data;
+  AVBufferRef* ref = av_buffer_ref(buffer);
+
+  av_buffer_unref(&buffer);
+  const CVideoBufferMemory::Stats held = memory->GetStats();
+  av_buffer_unref(&ref);
+  const CVideoBufferMemory::Stats released = memory->GetStats();
+  EXPECT_GT(released.retainedBytes, held.retainedBytes);
+
+  uint8_t* reused = memory->Allocate(FRAME_SIZE);
+  EXPECT_EQ(data, reused);
+  memory->Release(reused);
+}
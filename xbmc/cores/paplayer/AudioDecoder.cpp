@@ -34,13 +34,16 @@ CAudioDecoder::CAudioDecoder()
 
   m_bAudio2 = false;
   m_bCheckAudio2 = false;
+  m_bAudio2Reader = false;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   memset(&m_outputBuffer, 0, OUTPUT_SAMPLES * sizeof(float));
+  memset(&m_outputBuffer2, 0, OUTPUT_SAMPLES * sizeof(float));
   memset(&m_pcmInputBuffer, 0, INPUT_SIZE * sizeof(unsigned char));
   memset(&m_inputBuffer, 0, INPUT_SAMPLES * sizeof(float));
 
   m_rawBufferSize = 0;
+  m_rawTaken[0] = m_rawTaken[1] = false;
 }
 
 CAudioDecoder::~CAudioDecoder()
@@ -54,6 +57,8 @@ void CAudioDecoder::Destroy()
   m_status = STATUS_NO_FILE;
 
   m_pcmBuffer.Destroy();
+  m_pcmBuffer2.Destroy();
+  m_bAudio2Reader = false;
 
   if ( m_codec )
     delete m_codec;
@@ -139,10 +144,55 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   m_status = STATUS_QUEUING;
 
   m_rawBufferSize = 0;
+  m_rawTaken[0] = m_rawTaken[1] = false;
 
   return true;
 }
 
+void CAudioDecoder::SetAudio2Reader(bool bAudio2Reader)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (bAudio2Reader == m_bAudio2Reader || !m_codec)
+    return;
+
+  m_bAudio2Reader = bAudio2Reader;
+  if (m_bAudio2Reader)
+  {
+    // start the 2nd reader at the read position of the 1st one
+    m_pcmBuffer2.Create(m_pcmBuffer.getSize());
+    m_pcmBuffer2.Copy(m_pcmBuffer);
+    m_rawTaken[1] = m_rawTaken[0];
+  }
+  else
+    m_pcmBuffer2.Destroy();
+}
+
+void CAudioDecoder::ResyncAudio2Reader()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (!m_bAudio2Reader)
+    return;
+
+  m_pcmBuffer2.Copy(m_pcmBuffer);
+  m_rawTaken[1] = m_rawTaken[0];
+  if (m_rawTaken[0])
+    m_rawBufferSize = 0;
+}
+
+unsigned int CAudioDecoder::GetMaxReadSize()
+{
+  if (!m_bAudio2Reader)
+    return m_pcmBuffer.getMaxReadSize();
+  return std::max(m_pcmBuffer.getMaxReadSize(), m_pcmBuffer2.getMaxReadSize());
+}
+
+unsigned int CAudioDecoder::GetMaxWriteSize()
+{
+  if (!m_bAudio2Reader)
+    return m_pcmBuffer.getMaxWriteSize();
+  return std::min(m_pcmBuffer.getMaxWriteSize(), m_pcmBuffer2.getMaxWriteSize());
+}
+
 AEAudioFormat CAudioDecoder::GetFormat()
 {
   AEAudioFormat format;
@@ -159,6 +209,7 @@ unsigned int CAudioDecoder::GetChannels()
 int64_t CAudioDecoder::Seek(int64_t time)
 {
   m_pcmBuffer.Clear();
+  m_pcmBuffer2.Clear();
   m_rawBufferSize = 0;
   if (!m_codec)
     return 0;
@@ -180,33 +231,40 @@ int64_t CAudioDecoder::TotalTime()
   return 0;
 }
 
-unsigned int CAudioDecoder::GetDataSize(bool checkPktSize)
+unsigned int CAudioDecoder::GetDataSize(bool checkPktSize, bool bAudio2)
 {
   if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
     return 0;
 
+  bAudio2 = bAudio2 && m_bAudio2Reader;
+
   if (m_codec->m_format.m_dataFormat != AE_FMT_RAW)
   {
     // check for end of file and end of buffer
     if (m_status == STATUS_ENDING)
     {
-      if (m_pcmBuffer.getMaxReadSize() == 0)
+      if (GetMaxReadSize() == 0)
         m_status = STATUS_ENDED;
-      else if (checkPktSize && m_pcmBuffer.getMaxReadSize() < PACKET_SIZE)
+      else if (checkPktSize && GetMaxReadSize() < PACKET_SIZE)
         m_status = STATUS_ENDED;
     }
-    return std::min(m_pcmBuffer.getMaxReadSize() / (m_codec->m_bitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
+    CRingBuffer& pcmBuffer = bAudio2 ? m_pcmBuffer2 : m_pcmBuffer;
+    return std::min(pcmBuffer.getMaxReadSize() / (m_codec->m_bitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
   }
   else
   {
     if (m_status == STATUS_ENDING)
       m_status = STATUS_ENDED;
-    return m_rawBufferSize;
+    return m_rawTaken[bAudio2 ? 1 : 0] ? 0 : m_rawBufferSize;
   }
 }
 
-void *CAudioDecoder::GetData(unsigned int samples)
+void *CAudioDecoder::GetData(unsigned int samples, bool bAudio2)
 {
+  bAudio2 = bAudio2 && m_bAudio2Reader;
+  CRingBuffer& pcmBuffer = bAudio2 ? m_pcmBuffer2 : m_pcmBuffer;
+  float* outputBuffer = bAudio2 ? m_outputBuffer2 : m_outputBuffer;
+
   unsigned int size  = samples * (m_codec->m_bitsPerSample >> 3);
   if (size > sizeof(m_outputBuffer))
   {
@@ -214,36 +272,41 @@ void *CAudioDecoder::GetData(unsigned int samples)
     return NULL;
   }
 
-  if (size > m_pcmBuffer.getMaxReadSize())
+  if (size > pcmBuffer.getMaxReadSize())
   {
     CLog::Log(
         LOGWARNING,
         "CAudioDecoder::GetData() more bytes/samples ({}) requested than we have to give ({})!",
-        size, m_pcmBuffer.getMaxReadSize());
-    size = m_pcmBuffer.getMaxReadSize();
+        size, pcmBuffer.getMaxReadSize());
+    size = pcmBuffer.getMaxReadSize();
   }
 
-  if (m_pcmBuffer.ReadData((char *)m_outputBuffer, size))
+  if (pcmBuffer.ReadData((char *)outputBuffer, size))
   {
-    if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0)
+    if (m_status == STATUS_ENDING && GetMaxReadSize() == 0)
       m_status = STATUS_ENDED;
 
-    return m_outputBuffer;
+    return outputBuffer;
   }
 
   CLog::Log(LOGERROR, "CAudioDecoder::GetData() ReadBinary failed with {} samples", samples);
   return NULL;
 }
 
-uint8_t *CAudioDecoder::GetRawData(int &size)
+uint8_t *CAudioDecoder::GetRawData(int &size, bool bAudio2)
 {
   if (m_status == STATUS_ENDING)
     m_status = STATUS_ENDED;
 
-  if (m_rawBufferSize)
+  bAudio2 = bAudio2 && m_bAudio2Reader;
+
+  if (m_rawBufferSize && !m_rawTaken[bAudio2 ? 1 : 0])
   {
     size = m_rawBufferSize;
-    m_rawBufferSize = 0;
+    m_rawTaken[bAudio2 ? 1 : 0] = true;
+    // the packet stays valid until both readers have it
+    if (m_rawTaken[0] && (m_rawTaken[1] || !m_bAudio2Reader))
+      m_rawBufferSize = 0;
     return m_rawBuffer;
   }
   return nullptr;
@@ -264,7 +327,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
   if (m_codec->m_format.m_dataFormat != AE_FMT_RAW)
   {
     // Read in more data
-    int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer.getMaxWriteSize() / (m_codec->m_bitsPerSample >> 3));
+    int maxsize = std::min<int>(INPUT_SAMPLES, GetMaxWriteSize() / (m_codec->m_bitsPerSample >> 3));
     numsamples = std::min<int>(numsamples, maxsize);
     numsamples -= (numsamples % GetFormat().m_channelLayout.Count());  // make sure it's divisible by our number of channels
     if (numsamples)
@@ -278,6 +341,8 @@ int CAudioDecoder::ReadSamples(int numsamples)
       {
         // move it into our buffer
         m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
+        if (m_bAudio2Reader)
+          m_pcmBuffer2.WriteData((char *)m_pcmInputBuffer, readSize);
 
         // update status
         if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
@@ -318,6 +383,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
       int result = m_codec->ReadRaw(&m_rawBuffer, &m_rawBufferSize);
       if (result == READ_SUCCESS && m_rawBufferSize)
       {
+        m_rawTaken[0] = m_rawTaken[1] = false;
         //! @todo trash this useless ringbuffer
         if (m_status == STATUS_QUEUING)
         {
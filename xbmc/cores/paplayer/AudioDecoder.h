@@ -59,21 +59,33 @@ public:
   AEAudioFormat GetFormat();
   unsigned int GetChannels();
   // Data management
-  unsigned int GetDataSize(bool checkPktSize);
-  void *GetData(unsigned int samples);
-  uint8_t* GetRawData(int &size);
+  // bAudio2 selects the reader of the 2nd output, see SetAudio2Reader
+  unsigned int GetDataSize(bool checkPktSize, bool bAudio2 = false);
+  void *GetData(unsigned int samples, bool bAudio2 = false);
+  uint8_t* GetRawData(int &size, bool bAudio2 = false);
   ICodec *GetCodec() const { return m_codec; }
   float GetReplayGain(float &peakVal);
   void SetAudio2(bool bAudio2){ m_bAudio2 = bAudio2; }
   void SetCheckAudio2(bool bCheckAudio2){ m_bCheckAudio2 = m_bAudio2 ? false : bCheckAudio2; }
   bool IsReusableForAudio2();
+  // let the 2nd output consume the decoded data of this decoder at its own pace,
+  // so the file is read and decoded only once
+  void SetAudio2Reader(bool bAudio2Reader);
+  bool HasAudio2Reader() const { return m_bAudio2Reader; }
+  // realign the 2nd reader with the read position of the 1st one
+  void ResyncAudio2Reader();
 
 private:
+  unsigned int GetMaxReadSize();
+  unsigned int GetMaxWriteSize();
+
   // pcm buffer
   CRingBuffer m_pcmBuffer;
+  CRingBuffer m_pcmBuffer2; // pcm buffer of the 2nd output reader
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
+  float m_outputBuffer2[OUTPUT_SAMPLES];
 
   // input buffer (for transferring data from the Codecs to our Pcm Ringbuffer
   uint8_t m_pcmInputBuffer[INPUT_SIZE];
@@ -81,6 +93,7 @@ private:
 
   uint8_t *m_rawBuffer;
   int m_rawBufferSize;
+  bool m_rawTaken[2]; // raw packet handed out to 1st/2nd reader
 
   // status
   bool m_eof;
@@ -94,4 +107,5 @@ private:
 
   bool    m_bAudio2;
   bool    m_bCheckAudio2;
+  bool    m_bAudio2Reader;
 };
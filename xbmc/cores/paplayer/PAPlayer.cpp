@@ -375,7 +375,10 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   {
     si->m_decoder2.SetAudio2(true);
     if (si->m_decoder.IsReusableForAudio2())
+    {
       CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Reuse for 2nd decoder");
+      si->m_decoder.SetAudio2Reader(true);
+    }
     else if (si->m_decoder2.Create(file, si->m_startOffset))
       si->m_usedecoder2 = true;
     else
@@ -597,6 +600,7 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
         si->m_decoder2.Destroy();
         si->m_usedecoder2 = false;
       }
+      si->m_decoder.SetAudio2Reader(false);
       m_bAudio2 = false;
     }
     else
@@ -641,6 +645,9 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
     if (!QueueData(si))
       break;
 
+    if (si->m_decoder.HasAudio2Reader())
+      QueueData2(si);
+
     /* yield our time so that the main PAP thread doesn't stall */
     CThread::Sleep(1ms);
   }
@@ -1019,6 +1026,8 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
     si->m_decoder2.ReadSamples(PACKET_SIZE);
     QueueData2(si);
   }
+  else if (si->m_decoder.HasAudio2Reader())
+    QueueData2(si);
 
   /* update free buffer time if we are running */
   if (si->m_started)
@@ -1054,15 +1063,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
 
 bool PAPlayer::QueueData(StreamInfo *si)
 {
-  bool bAudio2 = m_bAudio2 && !si->m_usedecoder2 && si->m_stream2;
-  bool bAudio2Disabled = CServiceBroker::GetActiveAE(true)->IsDisabled();
   unsigned int space = si->m_stream->GetSpace();
-  if (bAudio2)
-  {
-    unsigned int space2 = si->m_stream->GetSpace();
-    if(space2)
-      space = std::min(space, space2);
-  }
 
   if (si->m_audioFormat.m_dataFormat != AE_FMT_RAW)
   {
@@ -1083,13 +1084,6 @@ bool PAPlayer::QueueData(StreamInfo *si)
     unsigned int frames = samples/si->m_audioFormat.m_channelLayout.Count();
     unsigned int added = si->m_stream->AddData(&data, 0, frames, nullptr);
     si->m_framesSent += added;
-
-    if (bAudio2)
-    {
-      if(!bAudio2Disabled)
-	    added = si->m_stream2->AddData(&data, 0, frames, 0);
-      si->m_framesSent2 = si->m_framesSent;
-    }
   }
   else
   {
@@ -1117,13 +1111,6 @@ bool PAPlayer::QueueData(StreamInfo *si)
         si->m_framesSent += si->m_audioFormat.m_streamInfo.GetDuration() / 1000 *
                             si->m_audioFormat.m_streamInfo.m_sampleRate;
       }
-
-      if (bAudio2)
-      {
-        if(!bAudio2Disabled)
-          added = si->m_stream2->AddData(&data, 0, size, nullptr);
-        si->m_framesSent2 = si->m_framesSent;
-      }
     }
   }
 
@@ -1135,22 +1122,29 @@ bool PAPlayer::QueueData(StreamInfo *si)
 
 bool PAPlayer::QueueData2(StreamInfo *si)
 {
-  if (!si->m_usedecoder2)
+  if (!si->m_usedecoder2 && !si->m_decoder.HasAudio2Reader())
+    return false;
+
+  if (!si->m_stream2)
     return false;
 
+  // either a decoder of its own or the 2nd reader of the shared one
+  CAudioDecoder& decoder = si->m_usedecoder2 ? si->m_decoder2 : si->m_decoder;
+  bool bReader2 = !si->m_usedecoder2;
+
   bool bAudio2Disabled = CServiceBroker::GetActiveAE(true)->IsDisabled();
   unsigned int space   = si->m_stream2->GetSpace();
 
   if (si->m_audioFormat2.m_dataFormat != AE_FMT_RAW)
   {
-    unsigned int samples = std::min(si->m_decoder2.GetDataSize(false), space / si->m_bytesPerSample2);
+    unsigned int samples = std::min(decoder.GetDataSize(false, bReader2), space / si->m_bytesPerSample2);
     if (!samples)
       return true;
 
     // we want complete frames
     samples -= samples % si->m_audioFormat2.m_channelLayout.Count();
 
-    uint8_t* data = (uint8_t*)si->m_decoder2.GetData(samples);
+    uint8_t* data = (uint8_t*)decoder.GetData(samples, bReader2);
     if (!data)
     {
       CLog::Log(LOGERROR, "PAPlayer::QueueData 2nd - Failed to get data from the decoder");
@@ -1167,7 +1161,7 @@ bool PAPlayer::QueueData2(StreamInfo *si)
       return true;
 
     int size;
-    uint8_t *data = si->m_decoder2.GetRawData(size);
+    uint8_t *data = decoder.GetRawData(size, bReader2);
     if (data && size)
     {
       if (!bAudio2Disabled)
@@ -1219,6 +1213,7 @@ inline void PAPlayer::SyncStreams2()
     m_currentStream->m_stream->Flush();
     m_currentStream->m_stream2->Flush();
 	m_currentStream->m_framesSent2 = (int)(time1 * m_currentStream->m_audioFormat2.m_sampleRate);
+    m_currentStream->m_decoder.ResyncAudio2Reader();
   }
 }
 
@@ -104,9 +104,9 @@ public:
 
   bool Open(const DatabaseSettings& db);
 
-  void BeginTransaction();
+  virtual void BeginTransaction();
   virtual bool CommitTransaction();
-  void RollbackTransaction();
+  virtual void RollbackTransaction();
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -203,6 +203,29 @@ void Dataset::parse_sql(std::string& sql)
   } //for
 }
 
+bool Dataset::query_bound(const std::string& sql, const sql_record& params)
+{
+  std::string bound;
+  size_t param = 0;
+  for (const char c : sql)
+  {
+    if (c != '?' || param == params.size())
+    {
+      bound += c;
+      continue;
+    }
+
+    const field_value& value = params[param++];
+    if (value.get_isNull())
+      bound += "NULL";
+    else if (value.get_fType() == ft_String)
+      bound += db->prepare("'%s'", value.get_asString().c_str());
+    else
+      bound += value.get_asString();
+  }
+  return query(bound);
+}
+
 void Dataset::close(void)
 {
   haveError = false;
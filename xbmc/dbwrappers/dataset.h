@@ -313,6 +313,10 @@ public:
   virtual const void* getExecRes() = 0;
   /* as open, but with our query exec Sql */
   virtual bool query(const std::string& sql) = 0;
+  /* as query, the values of params take the place of the ? in sql in their order.
+     Backends may keep sql compiled for the next call with other values, so it is
+     meant for lookups that run often. By default the values are written into sql */
+  virtual bool query_bound(const std::string& sql, const sql_record& params);
   /* Close SQL Query*/
   virtual void close();
   /* This function looks for field Field_name with value equal Field_value
@@ -1896,11 +1896,12 @@ bool MysqlDataset::query(const std::string& query)
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = fields[i].name;
 
-  // returned rows
+  // returned rows, the whole result set is on the client already
+  result.records.reserve(mysql_num_rows(stmt));
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record* res = new sql_record;
-    res->resize(numColumns);
+    const unsigned long* lengths = mysql_fetch_lengths(stmt);
+    sql_record* res = new sql_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value& v = res->at(i);
@@ -1946,7 +1947,7 @@ bool MysqlDataset::query(const std::string& query)
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
           if (row[i] != NULL)
-            v.set_asString((const char*)row[i]);
+            v.set_asString((const char*)row[i], lengths[i]);
           break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
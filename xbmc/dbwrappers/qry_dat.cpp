@@ -782,6 +782,12 @@ void field_value::set_asString(const char* s)
   field_type = ft_String;
 }
 
+void field_value::set_asString(const char* s, size_t len)
+{
+  str_value.assign(s, len);
+  field_type = ft_String;
+}
+
 void field_value::set_asString(const std::string& s)
 {
   str_value = s;
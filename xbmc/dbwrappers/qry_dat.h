@@ -209,6 +209,7 @@ public:
 
   void set_isNull() { is_null = true; }
   void set_asString(const char* s);
+  void set_asString(const char* s, size_t len);
   void set_asString(const std::string& s);
   void set_asBool(const bool b);
   void set_asChar(const char c);
@@ -383,10 +383,66 @@ void SqliteDatabase::disconnect(void)
 {
   if (active == false)
     return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
 
+sqlite3_stmt* SqliteDatabase::prepare_statement(const std::string& sql)
+{
+  auto it = statement_index.find(sql);
+  if (it != statement_index.end())
+  {
+    sqlite3_stmt* stmt = it->second->second;
+    statements.erase(it->second);
+    statement_index.erase(it);
+    return stmt;
+  }
+
+  // the length includes the terminator, that spares sqlite a copy of the sql
+  sqlite3_stmt* stmt = NULL;
+#if SQLITE_VERSION_NUMBER >= 3020000
+  if (setErr(sqlite3_prepare_v3(conn, sql.c_str(), sql.size() + 1, SQLITE_PREPARE_PERSISTENT,
+                                &stmt, NULL),
+             sql.c_str()) != SQLITE_OK)
+#else
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), sql.size() + 1, &stmt, NULL), sql.c_str()) !=
+      SQLITE_OK)
+#endif
+    throw DbErrors("%s", getErrorMsg());
+
+  return stmt;
+}
+
+void SqliteDatabase::release_statement(const std::string& sql, sqlite3_stmt* stmt)
+{
+  // a statement that failed or that is cached already is not kept
+  if (sqlite3_reset(stmt) != SQLITE_OK || statement_index.find(sql) != statement_index.end())
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+  sqlite3_clear_bindings(stmt);
+
+  statements.emplace_front(sql, stmt);
+  statement_index[sql] = statements.begin();
+
+  if (statements.size() > MAX_CACHED_STATEMENTS)
+  {
+    statement_index.erase(statements.back().first);
+    sqlite3_finalize(statements.back().second);
+    statements.pop_back();
+  }
+}
+
+void SqliteDatabase::clear_statements()
+{
+  for (const auto& statement : statements)
+    sqlite3_finalize(statement.second);
+  statements.clear();
+  statement_index.clear();
+}
+
 int SqliteDatabase::create()
 {
   return connect(true);
@@ -883,11 +939,94 @@ bool SqliteDataset::query(const std::string& query)
 
   close();
 
+  // the values are part of the sql, the statement is compiled for this query only.
+  // The length includes the terminator, that spares sqlite a copy of the sql
   sqlite3_stmt* stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &stmt, NULL), query.c_str()) !=
-      SQLITE_OK)
+  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), query.size() + 1, &stmt, NULL),
+                 query.c_str()) != SQLITE_OK)
     throw DbErrors("%s", db->getErrorMsg());
 
+  const int rc = fetch_rows(stmt);
+  sqlite3_finalize(stmt);
+  if (rc != SQLITE_DONE)
+  {
+    db->setErr(rc, query.c_str());
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_bound(const std::string& sql, const sql_record& params)
+{
+  if (!handle())
+    throw DbErrors("No Database Connection");
+  int fs = sql.find("select");
+  int fS = sql.find("SELECT");
+  if (!(fs >= 0 || fS >= 0))
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  SqliteDatabase* sqliteDb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt* stmt = sqliteDb->prepare_statement(sql);
+
+  int rc = SQLITE_OK;
+  for (unsigned int i = 0; i < params.size() && rc == SQLITE_OK; i++)
+  {
+    const field_value& value = params[i];
+    if (value.get_isNull())
+    {
+      rc = sqlite3_bind_null(stmt, i + 1);
+      continue;
+    }
+
+    switch (value.get_fType())
+    {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        rc = sqlite3_bind_int64(stmt, i + 1, value.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        rc = sqlite3_bind_double(stmt, i + 1, value.get_asDouble());
+        break;
+      default:
+      {
+        const std::string text = value.get_asString();
+        rc = sqlite3_bind_text(stmt, i + 1, text.c_str(), text.size(), SQLITE_TRANSIENT);
+        break;
+      }
+    }
+  }
+  if (rc == SQLITE_OK)
+    rc = fetch_rows(stmt);
+
+  if (rc != SQLITE_DONE)
+  {
+    // taken out of the cache by prepare_statement(), a failed statement is not put back
+    db->setErr(rc, sql.c_str());
+    sqlite3_finalize(stmt);
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  sqliteDb->release_statement(sql, stmt);
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::fetch_rows(sqlite3_stmt* stmt)
+{
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -895,10 +1034,10 @@ bool SqliteDataset::query(const std::string& query)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
-    sql_record* res = new sql_record;
-    res->resize(numColumns);
+    sql_record* res = new sql_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value& v = res->at(i);
@@ -911,7 +1050,8 @@ bool SqliteDataset::query(const std::string& query)
           v.set_asDouble(sqlite3_column_double(stmt, i));
           break;
         case SQLITE_TEXT:
-          v.set_asString((const char*)sqlite3_column_text(stmt, i));
+          // the text first, the length is of the converted value
+          v.set_asString((const char*)sqlite3_column_text(stmt, i), sqlite3_column_bytes(stmt, i));
           break;
         case SQLITE_BLOB:
           v.set_asString((const char*)sqlite3_column_text(stmt, i));
@@ -925,17 +1065,7 @@ bool SqliteDataset::query(const std::string& query)
     }
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt), query.c_str()) == SQLITE_OK)
-  {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
-    return true;
-  }
-  else
-  {
-    throw DbErrors("%s", db->getErrorMsg());
-  }
+  return rc;
 }
 
 void SqliteDataset::open(const std::string& sql)
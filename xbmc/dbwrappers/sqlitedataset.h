@@ -14,7 +14,11 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <sqlite3.h>
 
@@ -83,6 +87,26 @@ public:
   std::string vprepare(const char* format, va_list args) override;
 
   bool in_transaction() override { return _in_transaction; }
+
+  /* returns a compiled statement for sql, reused if the same sql ran recently.
+     Only for sql with bound parameters, sql with the values written into it would
+     rarely be reused and push the statements that are out of the cache.
+     The caller owns it until it hands it back with release_statement() */
+  sqlite3_stmt* prepare_statement(const std::string& sql);
+  /* resets a statement from prepare_statement() and keeps it for the next query */
+  void release_statement(const std::string& sql, sqlite3_stmt* stmt);
+  /* number of statements kept for reuse */
+  size_t cached_statements() const { return statements.size(); }
+
+private:
+  /* finalizes the cached statements, sqlite3_close() fails while any is left */
+  void clear_statements();
+
+  static constexpr size_t MAX_CACHED_STATEMENTS = 64;
+  /* most recently used first */
+  std::list<std::pair<std::string, sqlite3_stmt*>> statements;
+  std::unordered_map<std::string, std::list<std::pair<std::string, sqlite3_stmt*>>::iterator>
+      statement_index;
 };
 
 /***************** Class SqliteDataset definition *******************
@@ -113,6 +137,9 @@ protected:
   /* Changing field values during dataset navigation */
   virtual void free_row(); // free the memory allocated for the current row
 
+  /* steps stmt into the result, returns the code of the last step */
+  int fetch_rows(sqlite3_stmt* stmt);
+
 public:
   /* constructor */
   SqliteDataset();
@@ -134,6 +161,8 @@ or insert() operations default = false) */
   const void* getExecRes() override;
   /* as open, but with our query exec Sql */
   bool query(const std::string& query) override;
+  /* binds params to a compiled statement kept by the database */
+  bool query_bound(const std::string& sql, const sql_record& params) override;
   /* func. closes a query */
   void close(void) override;
   /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+// fails the step for the value "fail", the rest is returned as is
+void CheckValue(sqlite3_context* context, int, sqlite3_value** values)
+{
+  const char* text = reinterpret_cast<const char*>(sqlite3_value_text(values[0]));
+  if (text && strcmp(text, "fail") == 0)
+    sqlite3_result_error(context, "failed on purpose", -1);
+  else
+    sqlite3_result_value(context, values[0]);
+}
+
+// called by sqlite once the connection is closed
+void OnClosed(void* closed)
+{
+  *static_cast<bool*>(closed) = true;
+}
+
+struct TestSqliteDataset : public ::testing::Test
+{
+  TestSqliteDataset()
+  {
+    m_path = std::filesystem::temp_directory_path();
+    m_name = "TestSqliteDataset" + std::to_string(reinterpret_cast<uintptr_t>(this)) + ".db";
+    m_db.setHostName(m_path.string().c_str());
+    m_db.setDatabase(m_name.c_str());
+  }
+
+  ~TestSqliteDataset() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    std::filesystem::remove(m_path / m_name);
+  }
+
+  void SetUp() override
+  {
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    ASSERT_EQ(SQLITE_OK, sqlite3_create_function_v2(m_db.getHandle(), "check_value", 1,
+                                                    SQLITE_UTF8, &m_closed, CheckValue, nullptr,
+                                                    nullptr, OnClosed));
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("CREATE TABLE texture (id INTEGER PRIMARY KEY, url TEXT)");
+    m_ds->exec("INSERT INTO texture (url) VALUES ('a.jpg')");
+    m_ds->exec("INSERT INTO texture (url) VALUES ('b.jpg')");
+  }
+
+  // the statement that sqlite hands out first, the cache keeps one at most in these tests
+  sqlite3_stmt* Statement() { return sqlite3_next_stmt(m_db.getHandle(), nullptr); }
+
+  std::filesystem::path m_path;
+  std::string m_name;
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+  bool m_closed = false;
+};
+} // namespace
+
+TEST_F(TestSqliteDataset, ReusesBoundStatement)
+{
+  ASSERT_TRUE(m_ds->query_bound("SELECT id FROM texture WHERE url=?", {field_value("a.jpg")}));
+  EXPECT_EQ(1, m_ds->fv(0).get_asInt());
+  m_ds->close();
+  EXPECT_EQ(1u, m_db.cached_statements());
+  sqlite3_stmt* stmt = Statement();
+  ASSERT_NE(nullptr, stmt);
+
+  ASSERT_TRUE(m_ds->query_bound("SELECT id FROM texture WHERE url=?", {field_value("b.jpg")}));
+  EXPECT_EQ(2, m_ds->fv(0).get_asInt());
+  m_ds->close();
+  EXPECT_EQ(1u, m_db.cached_statements());
+  EXPECT_EQ(stmt, Statement());
+}
+
+TEST_F(TestSqliteDataset, DoesNotCacheInlinedValues)
+{
+  ASSERT_TRUE(m_ds->query("SELECT id FROM texture WHERE url='a.jpg'"));
+  EXPECT_EQ(1, m_ds->fv(0).get_asInt());
+  m_ds->close();
+  EXPECT_EQ(0u, m_db.cached_statements());
+  EXPECT_EQ(nullptr, Statement());
+}
+
+TEST_F(TestSqliteDataset, EvictsFailedStatement)
+{
+  ASSERT_TRUE(m_ds->query_bound("SELECT check_value(?)", {field_value("ok")}));
+  EXPECT_EQ("ok", m_ds->fv(0).get_asString());
+  m_ds->close();
+  EXPECT_EQ(1u, m_db.cached_statements());
+
+  EXPECT_THROW(m_ds->query_bound("SELECT check_value(?)", {field_value("fail")}), DbErrors);
+  EXPECT_EQ(0u, m_db.cached_statements());
+  EXPECT_EQ(nullptr, Statement());
+
+  // compiled again on the next call
+  ASSERT_TRUE(m_ds->query_bound("SELECT check_value(?)", {field_value("ok")}));
+  EXPECT_EQ("ok", m_ds->fv(0).get_asString());
+  m_ds->close();
+  EXPECT_EQ(1u, m_db.cached_statements());
+}
+
+TEST_F(TestSqliteDataset, FinalizesOnDisconnect)
+{
+  ASSERT_TRUE(m_ds->query_bound("SELECT check_value(?)", {field_value("ok")}));
+  m_ds->close();
+  EXPECT_EQ(1u, m_db.cached_statements());
+
+  // sqlite3_close() keeps the connection while a statement is left
+  m_db.disconnect();
+  EXPECT_EQ(0u, m_db.cached_statements());
+  EXPECT_TRUE(m_closed);
+}
@@ -0,0 +1,218 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryJournal.h"
+
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#endif
+
+#include <mutex>
+
+using namespace XFILE;
+
+namespace
+{
+// changed folders that are remembered besides the scanned ones before all are forgotten
+constexpr size_t MAX_CHANGES = 4096;
+
+std::string GetFolder(const std::string& path)
+{
+  std::string folder = path;
+  URIUtils::AddSlashAtEnd(folder);
+  return folder;
+}
+
+// "/a/b/" -> "/a/", empty for the root
+std::string GetParentFolder(const std::string& path)
+{
+  if (path.size() < 2)
+    return {};
+
+  const size_t pos = path.rfind('/', path.size() - 2);
+  if (pos == std::string::npos)
+    return {};
+  return path.substr(0, pos + 1);
+}
+} // namespace
+
+CDirectoryJournal& CDirectoryJournal::GetInstance()
+{
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+  static CDirectoryJournal journal(std::make_unique<CInotifyDirectoryWatcher>());
+#else
+  static CDirectoryJournal journal(nullptr);
+#endif
+  return journal;
+}
+
+CDirectoryJournal::CDirectoryJournal(std::unique_ptr<IDirectoryWatcher> watcher)
+  : m_watcher(std::move(watcher))
+{
+}
+
+CDirectoryJournal::~CDirectoryJournal()
+{
+  // stops the watcher before anything it reports to is gone
+  m_watcher.reset();
+}
+
+bool CDirectoryJournal::Watch(const std::string& path)
+{
+  const std::string folder = GetFolder(path);
+
+  std::unique_lock<CCriticalSection> watchLock(m_watchSection);
+  if (!m_watcher)
+    return false;
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_section);
+    if (IsWatched(folder, m_position))
+      return true;
+  }
+
+  if (!m_started)
+  {
+    if (!m_watcher->Start(*this))
+    {
+      m_watcher.reset();
+      return false;
+    }
+    m_started = true;
+  }
+
+  if (!m_watcher->Watch(folder))
+    return false;
+
+  // folders looked at before this point may have changed unseen
+  std::unique_lock<CCriticalSection> lock(m_section);
+  m_roots[folder] = ++m_position;
+  return true;
+}
+
+uint64_t CDirectoryJournal::GetPosition() const
+{
+  Sync();
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+  return m_position;
+}
+
+void CDirectoryJournal::MarkScanned(const std::string& path,
+                                    const std::string& hash,
+                                    uint64_t position)
+{
+  if (hash.empty())
+    return;
+
+  const std::string folder = GetFolder(path);
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+  if (!IsWatched(folder, position))
+    return;
+
+  // changed while it was scanned, the next scan has to look again. Forgotten changes may have
+  // been of this folder
+  auto change = m_changes.find(folder);
+  if ((change != m_changes.end() && change->second > position) || m_prunedPosition > position)
+    return;
+
+  m_scanned[folder] = {hash, position};
+}
+
+bool CDirectoryJournal::IsUnchanged(const std::string& path, const std::string& hash) const
+{
+  if (hash.empty())
+    return false;
+
+  const std::string folder = GetFolder(path);
+
+  Sync();
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+  auto it = m_scanned.find(folder);
+  if (it == m_scanned.end() || it->second.hash != hash)
+    return false;
+
+  if (!IsWatched(folder, it->second.position))
+    return false;
+
+  auto change = m_changes.find(folder);
+  return change == m_changes.end() || change->second <= it->second.position;
+}
+
+void CDirectoryJournal::OnDirectoryChanged(const std::string& path)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  AddChange(path);
+}
+
+void CDirectoryJournal::OnDirectoryReplaced(const std::string& path)
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  AddChange(path);
+
+  for (auto it = m_scanned.lower_bound(path);
+       it != m_scanned.end() && StringUtils::StartsWith(it->first, path);)
+    it = m_scanned.erase(it);
+}
+
+void CDirectoryJournal::OnWatchLost()
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+  m_position++;
+  m_roots.clear();
+  m_scanned.clear();
+  m_changes.clear();
+  m_prunedPosition = m_position;
+}
+
+void CDirectoryJournal::Sync() const
+{
+  std::unique_lock<CCriticalSection> watchLock(m_watchSection);
+  if (m_watcher && m_started)
+    m_watcher->Sync();
+}
+
+bool CDirectoryJournal::IsWatched(const std::string& path, uint64_t position) const
+{
+  for (const auto& root : m_roots)
+  {
+    if (root.second <= position && StringUtils::StartsWith(path, root.first))
+      return true;
+  }
+  return false;
+}
+
+void CDirectoryJournal::AddChange(const std::string& path)
+{
+  // a change below a folder is a change of the folder's subtree, up to the watched path
+  m_position++;
+  for (std::string folder = path; !folder.empty() && IsWatched(folder, m_position);
+       folder = GetParentFolder(folder))
+    m_changes[folder] = m_position;
+
+  if (m_changes.size() > m_scanned.size() + MAX_CHANGES)
+    PruneChanges();
+}
+
+void CDirectoryJournal::PruneChanges()
+{
+  // a scanned folder that changed since is not unchanged anymore without the change either
+  for (const auto& change : m_changes)
+  {
+    auto scanned = m_scanned.find(change.first);
+    if (scanned != m_scanned.end() && change.second > scanned->second.position)
+      m_scanned.erase(scanned);
+  }
+  m_changes.clear();
+  m_prunedPosition = m_position;
+}
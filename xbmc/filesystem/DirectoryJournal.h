@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace XFILE
+{
+/*!
+ \brief Remembers which library folders are unchanged since they were scanned
+
+ A scanner asks for the journal position before it looks at a folder, and
+ marks the folder scanned with the hash it stored for it once it is done with
+ the folder and everything below it. As long as the platform watcher reports
+ no change below the folder, IsUnchanged() tells so without touching it, so
+ a scan can skip the whole subtree.
+
+ Only folders the watcher can observe are ever unchanged, e.g. local disks on
+ Linux. Network shares, and everything after a restart, go through the hashes
+ stored in the databases as before. The journal lives in memory only: changes
+ made while Kodi is not running can't be seen, which is what the stored hashes
+ are for.
+ */
+class CDirectoryJournal : public IDirectoryWatcher::IEventHandler
+{
+public:
+  //! the journal shared by the library scanners, uses the watcher of the platform
+  static CDirectoryJournal& GetInstance();
+
+  //! \param watcher nullptr if there is none, nothing is ever unchanged then
+  explicit CDirectoryJournal(std::unique_ptr<IDirectoryWatcher> watcher);
+  ~CDirectoryJournal() override;
+
+  /*!
+   \brief Watch a library path and all folders below it
+   \return false if it can't be watched, its folders are never unchanged
+   */
+  bool Watch(const std::string& path);
+
+  //! take before looking at a folder, changes after it make MarkScanned() a no-op.
+  //! Changes the watcher still has queued are taken in first, as by IsUnchanged()
+  uint64_t GetPosition() const;
+
+  /*!
+   \brief Remember a folder and everything below it as scanned
+   \param path the folder
+   \param hash the hash the database has for the folder
+   \param position the journal position from before the folder was looked at
+   */
+  void MarkScanned(const std::string& path, const std::string& hash, uint64_t position);
+
+  /*!
+   \brief Whether nothing below a folder changed since it was marked scanned
+   \param path the folder
+   \param hash the hash the database has for the folder, it must be the one marked
+   */
+  bool IsUnchanged(const std::string& path, const std::string& hash) const;
+
+  // IDirectoryWatcher::IEventHandler
+  void OnDirectoryChanged(const std::string& path) override;
+  void OnDirectoryReplaced(const std::string& path) override;
+  void OnWatchLost() override;
+
+private:
+  //! take in the changes the watcher has queued, call without m_section
+  void Sync() const;
+  bool IsWatched(const std::string& path, uint64_t position) const;
+  void AddChange(const std::string& path);
+  //! forget the changes, and the scanned folders they are newer than
+  void PruneChanges();
+
+  struct CEntry
+  {
+    std::string hash;
+    uint64_t position;
+  };
+
+  std::unique_ptr<IDirectoryWatcher> m_watcher;
+  bool m_started = false;
+  mutable CCriticalSection m_watchSection; //!< serialises Watch() and Sync()
+
+  mutable CCriticalSection m_section;
+  uint64_t m_position = 0; //!< number of changes so far
+  std::map<std::string, uint64_t> m_roots; //!< watched paths and the position they were added at
+  std::map<std::string, uint64_t> m_changes; //!< last change at or below a folder
+  uint64_t m_prunedPosition = 0; //!< position of the last change that was forgotten
+  std::map<std::string, CEntry> m_scanned;
+};
+} // namespace XFILE
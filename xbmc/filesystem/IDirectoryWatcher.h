@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace XFILE
+{
+/*!
+ \brief Reports changes below local folders as they happen
+
+ Implemented per platform, e.g. with inotify on Linux. Paths are local
+ absolute folder paths with a trailing slash.
+ */
+class IDirectoryWatcher
+{
+public:
+  class IEventHandler
+  {
+  public:
+    virtual ~IEventHandler() = default;
+
+    //! a file or folder in the folder was added, removed, renamed or written
+    virtual void OnDirectoryChanged(const std::string& path) = 0;
+
+    //! the folder itself was added, removed or renamed, nothing below it is known anymore
+    virtual void OnDirectoryReplaced(const std::string& path) = 0;
+
+    //! changes may have been missed, e.g. the event queue overflowed
+    virtual void OnWatchLost() = 0;
+  };
+
+  virtual ~IDirectoryWatcher() = default;
+
+  //! start reporting changes to the handler, it has to outlive the watcher
+  virtual bool Start(IEventHandler& handler) = 0;
+
+  /*!
+   \brief Watch a folder and all folders below it
+   \return false if some of it can't be watched, e.g. a network mount or a symlink
+   */
+  virtual bool Watch(const std::string& path) = 0;
+
+  //! report the changes made so far before returning, e.g. those the platform still queues
+  virtual void Sync() {}
+};
+} // namespace XFILE
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/DirectoryJournal.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+// watches everything below /local/, the test reports the changes itself
+class CTestWatcher : public IDirectoryWatcher
+{
+public:
+  bool Start(IEventHandler& handler) override
+  {
+    m_handler = &handler;
+    return true;
+  }
+
+  bool Watch(const std::string& path) override { return path.rfind("/local/", 0) == 0; }
+
+  void Sync() override
+  {
+    for (const std::string& path : m_queued)
+      m_handler->OnDirectoryChanged(path);
+    m_queued.clear();
+  }
+
+  IEventHandler* m_handler = nullptr;
+  std::vector<std::string> m_queued; //!< changes only reported by Sync()
+};
+
+struct TestDirectoryJournal : public ::testing::Test
+{
+  TestDirectoryJournal()
+  {
+    auto watcher = std::make_unique<CTestWatcher>();
+    m_watcher = watcher.get();
+    m_journal = std::make_unique<CDirectoryJournal>(std::move(watcher));
+  }
+
+  CTestWatcher* m_watcher;
+  std::unique_ptr<CDirectoryJournal> m_journal;
+};
+} // namespace
+
+TEST_F(TestDirectoryJournal, UnchangedUntilChanged)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  ASSERT_NE(m_watcher->m_handler, nullptr);
+
+  const uint64_t position = m_journal->GetPosition();
+  m_journal->MarkScanned("/local/movies/", "hash", position);
+  m_journal->MarkScanned("/local/movies/a/", "hash-a", position);
+  m_journal->MarkScanned("/local/movies/b/", "hash-b", position);
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/", "hash"));
+
+  // the database has a different hash, e.g. the folder was removed from the library
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "other"));
+
+  // a change in a folder changes the folders above it, not the ones next to it
+  m_watcher->m_handler->OnDirectoryChanged("/local/movies/a/");
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "hash"));
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/a/", "hash-a"));
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/b/", "hash-b"));
+
+  // scanned again
+  m_journal->MarkScanned("/local/movies/a/", "hash-a2", m_journal->GetPosition());
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/a/", "hash-a2"));
+}
+
+TEST_F(TestDirectoryJournal, ChangedWhileScanned)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/music"));
+
+  const uint64_t position = m_journal->GetPosition();
+  m_watcher->m_handler->OnDirectoryChanged("/local/music/album/");
+  m_journal->MarkScanned("/local/music/", "hash", position);
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/music/", "hash"));
+}
+
+TEST_F(TestDirectoryJournal, Replaced)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/tv/"));
+
+  const uint64_t position = m_journal->GetPosition();
+  m_journal->MarkScanned("/local/tv/show/", "hash", position);
+  m_journal->MarkScanned("/local/tv/show/season 1/", "hash-1", position);
+  m_journal->MarkScanned("/local/tv/other/", "hash-other", position);
+
+  // a folder moved away and back is not the one that was scanned
+  m_watcher->m_handler->OnDirectoryReplaced("/local/tv/show/");
+  m_journal->MarkScanned("/local/tv/show/", "hash", position);
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/tv/show/", "hash"));
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/tv/show/season 1/", "hash-1"));
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/tv/other/", "hash-other"));
+}
+
+TEST_F(TestDirectoryJournal, NotWatched)
+{
+  // network shares keep using the hashes
+  EXPECT_FALSE(m_journal->Watch("smb://server/movies/"));
+  m_journal->MarkScanned("smb://server/movies/", "hash", m_journal->GetPosition());
+  EXPECT_FALSE(m_journal->IsUnchanged("smb://server/movies/", "hash"));
+
+  // scanned before it was watched
+  const uint64_t position = m_journal->GetPosition();
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  m_journal->MarkScanned("/local/movies/", "hash", position);
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "hash"));
+
+  // no journal without a watcher
+  CDirectoryJournal journal(nullptr);
+  EXPECT_FALSE(journal.Watch("/local/movies/"));
+}
+
+TEST_F(TestDirectoryJournal, WatchLost)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  m_journal->MarkScanned("/local/movies/", "hash", m_journal->GetPosition());
+  ASSERT_TRUE(m_journal->IsUnchanged("/local/movies/", "hash"));
+
+  m_watcher->m_handler->OnWatchLost();
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "hash"));
+
+  // watched again by the next scan
+  m_journal->MarkScanned("/local/movies/", "hash", m_journal->GetPosition());
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "hash"));
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  m_journal->MarkScanned("/local/movies/", "hash", m_journal->GetPosition());
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/", "hash"));
+}
+
+TEST_F(TestDirectoryJournal, TakesInQueuedChanges)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  m_journal->MarkScanned("/local/movies/", "hash", m_journal->GetPosition());
+
+  // not reported by the watcher's thread yet
+  m_watcher->m_queued.push_back("/local/movies/a/");
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/", "hash"));
+
+  // a change from before the folder is looked at is part of what is scanned
+  m_watcher->m_queued.push_back("/local/movies/b/");
+  m_journal->MarkScanned("/local/movies/b/", "hash-b", m_journal->GetPosition());
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/b/", "hash-b"));
+}
+
+TEST_F(TestDirectoryJournal, ForgetsChanges)
+{
+  ASSERT_TRUE(m_journal->Watch("/local/movies/"));
+  const uint64_t position = m_journal->GetPosition();
+  m_journal->MarkScanned("/local/movies/a/", "hash-a", position);
+  m_journal->MarkScanned("/local/movies/b/", "hash-b", position);
+  m_watcher->m_handler->OnDirectoryChanged("/local/movies/a/");
+
+  for (int i = 0; i < 5000; i++)
+    m_watcher->m_handler->OnDirectoryChanged("/local/movies/c/" + std::to_string(i) + "/");
+
+  // what was scanned is still known, the changes of folders that were not are gone
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/a/", "hash-a"));
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/b/", "hash-b"));
+
+  // a scan from before the changes were forgotten can't tell whether its folder changed
+  m_journal->MarkScanned("/local/movies/c/1/", "hash-c1", position);
+  EXPECT_FALSE(m_journal->IsUnchanged("/local/movies/c/1/", "hash-c1"));
+  m_journal->MarkScanned("/local/movies/c/1/", "hash-c1", m_journal->GetPosition());
+  EXPECT_TRUE(m_journal->IsUnchanged("/local/movies/c/1/", "hash-c1"));
+}
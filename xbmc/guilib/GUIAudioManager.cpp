@@ -392,6 +392,7 @@ CGUIAudioManager::CAPSounds CGUIAudioManager::LoadSound(const std::string& filen
   if (!sound)
     return aps;
 
+  // decoded samples of the 1st engine are reused, the file is not read again
   IAE *ae2 = CServiceBroker::GetActiveAE(true);
   std::shared_ptr<IAESound> sound2(ae2 ? ae2->MakeSound(filename) : nullptr);
 
@@ -65,6 +65,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.Zoom",                                  CPlayerOperations::Zoom },
   { "Player.SetViewMode",                           CPlayerOperations::SetViewMode },
   { "Player.GetViewMode",                           CPlayerOperations::GetViewMode },
+  { "Player.GetRenderTrace",                        CPlayerOperations::GetRenderTrace },
   { "Player.Rotate",                                CPlayerOperations::Rotate },
 
   { "Player.Open",                                  CPlayerOperations::Open },
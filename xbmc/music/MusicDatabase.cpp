@@ -708,7 +708,8 @@ void CMusicDatabase::SplitPath(const std::string& strFileNameAndPath,
 
 bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
 {
-  BeginTransaction();
+  if (!m_inBatch)
+    BeginTransaction();
   SetLibraryLastUpdated();
 
   album.idAlbum = AddAlbum(album.strAlbum, //
@@ -856,13 +857,15 @@ bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
                       albumdateadded.c_str(), strIDs.c_str(), albumdateadded.c_str());
   m_pDS->exec(strSQL);
 
-  CommitTransaction();
+  if (!m_inBatch)
+    CommitTransaction();
   return true;
 }
 
 bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 {
-  BeginTransaction();
+  if (!m_inBatch)
+    BeginTransaction();
   SetLibraryLastUpdated();
 
   const std::string itemSeparator =
@@ -970,7 +973,8 @@ bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 
   CheckArtistLinksChanged();
 
-  CommitTransaction();
+  if (!m_inBatch)
+    CommitTransaction();
   return true;
 }
 
@@ -1830,6 +1834,12 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
     if (nullptr == m_pDS)
       return -1;
 
+    // the same artists come up on every song of a scan
+    const std::string cacheKey = strArtist + '\n' + strMusicBrainzArtistID;
+    auto it = m_artistCache.find(cacheKey);
+    if (it != m_artistCache.end())
+      return it->second;
+
     // 1) MusicBrainz
     if (!strMusicBrainzArtistID.empty())
     {
@@ -1851,6 +1861,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
           m_pDS->exec(strSQL);
           m_pDS->close();
         }
+        m_artistCache[cacheKey] = idArtist;
         return idArtist;
       }
       m_pDS->close();
@@ -1872,6 +1883,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                        "bScrapedMBID = %i WHERE idArtist = %i",
                        strArtist.c_str(), strMusicBrainzArtistID.c_str(), bScrapedMBID, idArtist);
         m_pDS->exec(strSQL);
+        m_artistCache[cacheKey] = idArtist;
         return idArtist;
       }
 
@@ -1889,6 +1901,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
       {
         int idArtist = m_pDS->fv("idArtist").get_asInt();
         m_pDS->close();
+        m_artistCache[cacheKey] = idArtist;
         return idArtist;
       }
       m_pDS->close();
@@ -1908,6 +1921,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
 
     m_pDS->exec(strSQL);
     int idArtist = (int)m_pDS->lastinsertid();
+    m_artistCache[cacheKey] = idArtist;
     return idArtist;
   }
   catch (...)
@@ -1962,6 +1976,9 @@ int CMusicDatabase::UpdateArtist(int idArtist,
           "mysql"))
     TrimImageURLs(strImageURLs, 65535);
 
+  // the name and MusicBrainz id may change
+  m_artistCache.clear();
+
   std::string strSQL;
   strSQL = PrepareSQL("UPDATE artist SET "
                       " strArtist = '%s', "
@@ -3957,6 +3974,7 @@ void CMusicDatabase::EmptyCache()
 {
   m_genreCache.erase(m_genreCache.begin(), m_genreCache.end());
   m_pathCache.erase(m_pathCache.begin(), m_pathCache.end());
+  m_artistCache.clear();
 }
 
 bool CMusicDatabase::Search(const std::string& search, CFileItemList& items)
@@ -4322,6 +4340,7 @@ bool CMusicDatabase::CleanupArtists()
     m_pDS->exec("CREATE TEMPORARY TABLE tmp_keep (idArtist INTEGER PRIMARY KEY)");
     m_pDS->exec("INSERT INTO tmp_keep SELECT DISTINCT idArtist from tmp_delartists");
     m_pDS->exec("DELETE FROM artist WHERE idArtist NOT IN (SELECT idArtist FROM tmp_keep)");
+    m_artistCache.clear();
     // Tidy up temp tables
     m_pDS->exec("DROP TABLE tmp_delartists");
     m_pDS->exec("DROP TABLE tmp_keep");
@@ -11416,6 +11435,29 @@ int CMusicDatabase::GetSongIDFromPath(const std::string& filePath)
   return -1;
 }
 
+void CMusicDatabase::BeginBatch()
+{
+  if (m_inBatch)
+    return;
+
+  BeginTransaction();
+  m_inBatch = true;
+}
+
+bool CMusicDatabase::CommitBatch()
+{
+  if (!m_inBatch)
+    return true;
+
+  m_inBatch = false;
+  if (CommitTransaction())
+    return true;
+
+  // ids added by the batch are gone
+  EmptyCache();
+  return false;
+}
+
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
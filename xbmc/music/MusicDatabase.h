@@ -106,6 +106,16 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+
+  /*! \brief Add several albums in one transaction
+   AddAlbum and UpdateAlbum commit every album on their own. Between BeginBatch and
+   CommitBatch they write into one transaction instead, which saves a commit and a
+   song count per album when a scan adds thousands of them.
+   */
+  void BeginBatch();
+  bool CommitBatch();
+  bool InBatch() const { return m_inBatch; }
+
   void EmptyCache();
   void Clean();
   int Cleanup(CGUIDialogProgress* progressDialog = nullptr);
@@ -879,6 +889,8 @@ public:
 protected:
   std::map<std::string, int> m_genreCache;
   std::map<std::string, int> m_pathCache;
+  std::map<std::string, int> m_artistCache; //!< artist ids by name and MusicBrainz id
+  bool m_inBatch = false;
 
   void CreateTables() override;
   void CreateAnalytics() override;
@@ -28,6 +28,7 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryJournal.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "filesystem/SmartPlaylistDirectory.h"
@@ -40,19 +41,25 @@
 #include "music/MusicThumbLoader.h"
 #include "music/MusicUtils.h"
 #include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagLoaderFFmpeg.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderTagLib.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/FileUtils.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <mutex>
 #include <utility>
 
 using namespace MUSIC_INFO;
@@ -62,6 +69,70 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+using namespace std::chrono_literals;
+
+namespace
+{
+// albums are committed once the open transaction holds this many songs or is this old
+constexpr int BATCH_SONGS = 1000;
+constexpr auto BATCH_TIME = 5s;
+
+// the files of a folder read by jobs, shared with them so a job that starts late finds none left
+struct CTagReadQueue
+{
+  std::vector<std::pair<CFileItem*, std::unique_ptr<IMusicInfoTagLoader>>> files;
+  CCriticalSection section;
+  XbmcThreads::ConditionVariable condition;
+  size_t next = 0;
+  unsigned int running = 0;
+  unsigned int done = 0;
+  bool stop = false;
+
+  //! read the tag of the next file, false if there is none left
+  bool ReadNext()
+  {
+    size_t index;
+    {
+      std::unique_lock<CCriticalSection> lock(section);
+      if (stop || next >= files.size())
+        return false;
+      index = next++;
+      running++;
+    }
+
+    CFileItem& item = *files[index].first;
+    try
+    {
+      files[index].second->Load(item.GetPath(), *item.GetMusicInfoTag());
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "CMusicInfoScanner::ReadTags - failed to read {}",
+                CURL::GetRedacted(item.GetPath()));
+    }
+
+    {
+      std::unique_lock<CCriticalSection> lock(section);
+      running--;
+      done++;
+    }
+    condition.notifyAll();
+    return true;
+  }
+
+  //! no file is read and none will be, call with the section locked
+  bool Finished() const { return running == 0 && (stop || next >= files.size()); }
+};
+
+bool CanReadInJob(const IMusicInfoTagLoader* loader)
+{
+  // a loader reads one file with its own TagLib or FFmpeg objects, audio decoder addons
+  // and the other loaders are not known to be safe on several threads at once
+  return dynamic_cast<const CTagLoaderTagLib*>(loader) ||
+         dynamic_cast<const CMusicInfoTagLoaderFFmpeg*>(loader);
+}
+} // namespace
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -122,6 +193,14 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      if (CServiceBroker::GetSettingsComponent()
+              ->GetAdvancedSettings()
+              ->m_musicLibraryUseDirectoryWatcher)
+      { // changes below the paths are seen from now on, local folders only
+        for (const auto& it : m_pathsToScan)
+          CDirectoryJournal::GetInstance().Watch(it);
+      }
+
       bool commit = true;
       for (const auto& it : m_pathsToScan)
       {
@@ -142,6 +221,7 @@ void CMusicInfoScanner::Process()
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
         bool scancomplete = DoScan(it);
+        CommitAlbums(true);
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -269,6 +349,7 @@ void CMusicInfoScanner::Process()
   catch (...)
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
+    CommitAlbums(true);
   }
   m_musicDatabase.Close();
   CLog::Log(LOGDEBUG, "{} - Finished scan", __FUNCTION__);
@@ -485,9 +566,28 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  // reading a remote folder can take long, other writers would wait for the open transaction
+  CommitAlbums(URIUtils::IsRemote(strDirectory));
+
   if (HasNoMedia(strDirectory))
     return true;
 
+  const bool useJournal = CServiceBroker::GetSettingsComponent()
+                              ->GetAdvancedSettings()
+                              ->m_musicLibraryUseDirectoryWatcher &&
+                          !(m_flags & SCAN_RESCAN);
+  const uint64_t journalPosition = CDirectoryJournal::GetInstance().GetPosition();
+  std::string dbHash;
+  const bool hasDbHash = m_musicDatabase.GetPathHash(strDirectory, dbHash);
+  if (useJournal && hasDbHash && CDirectoryJournal::GetInstance().IsUnchanged(strDirectory, dbHash))
+  { // nothing below the folder changed since it was scanned, the subfolders neither
+    CLog::Log(LOGDEBUG, "{} Skipping dir '{}' and its subfolders due to no change", __FUNCTION__,
+              CURL::GetRedacted(strDirectory));
+    if (m_handle)
+      OnDirectoryScanned(strDirectory);
+    return true;
+  }
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
@@ -500,8 +600,8 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   GetPathHash(items, hash);
 
   // check whether we need to rescan or not
-  std::string dbHash;
-  if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
+  std::string journalHash = hash;
+  if ((m_flags & SCAN_RESCAN) || !hasDbHash || !StringUtils::EqualsNoCase(dbHash, hash))
   { // path has changed - rescan
     if (dbHash.empty())
       CLog::Log(LOGDEBUG, "{} Scanning dir '{}' as not in the database", __FUNCTION__,
@@ -526,11 +626,13 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
+    CommitAlbums(URIUtils::IsRemote(strDirectory));
   }
   else
   { // path is the same - no need to rescan
     CLog::Log(LOGDEBUG, "{} Skipping dir '{}' due to no change", __FUNCTION__,
               CURL::GetRedacted(strDirectory));
+    journalHash = dbHash;
     m_currentItem += CountFiles(items, false);  // false for non-recursive
 
     // updated the dialog with our progress
@@ -559,6 +661,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
       }
     }
   }
+
+  // the subfolders were scanned too, the next scan can skip them all
+  if (useJournal && !m_bStop)
+    CDirectoryJournal::GetInstance().MarkScanned(strDirectory, journalHash, journalPosition);
   return !m_bStop;
 }
 
@@ -567,11 +673,9 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> files;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -580,18 +684,22 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    files.push_back(pItem);
+  }
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
-    }
+  // the progress is updated while the tags are read
+  ReadTags(files);
+  if (m_bStop)
+    return INFO_CANCELLED;
 
-    if (m_handle && m_itemCount>0)
-      m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
+  m_currentItem += static_cast<int>(files.size());
+  if (m_handle && m_itemCount > 0)
+    m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) /
+                            static_cast<float>(m_itemCount));
+
+  for (const auto& pItem : files)
+  {
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
 
     if (!tag.Loaded() && !pItem->HasCueDocument())
     {
@@ -612,6 +720,71 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
   return INFO_ADDED;
 }
 
+void CMusicInfoScanner::ReadTags(const std::vector<CFileItemPtr>& files)
+{
+  const int readers =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicLibraryTagReaders;
+
+  auto queue = std::make_shared<CTagReadQueue>();
+  std::vector<std::pair<CFileItem*, std::unique_ptr<IMusicInfoTagLoader>>> local;
+  for (const auto& pItem : files)
+  {
+    if (pItem->GetMusicInfoTag()->Loaded())
+      continue;
+
+    std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
+    if (nullptr == pLoader)
+      continue;
+
+    if (readers > 1 && CanReadInJob(pLoader.get()))
+      queue->files.emplace_back(pItem.get(), std::move(pLoader));
+    else
+      local.emplace_back(pItem.get(), std::move(pLoader));
+  }
+
+  // the scanner thread is one of the readers, so a busy job manager only slows it down
+  const size_t jobs = std::min(queue->files.size(), static_cast<size_t>(std::max(readers, 1)));
+  for (size_t i = 1; i < jobs; i++)
+  {
+    CServiceBroker::GetJobManager()->Submit(
+        [queue]() {
+          while (queue->ReadNext())
+            ;
+        },
+        CJob::PRIORITY_NORMAL);
+  }
+
+  unsigned int read = 0;
+  auto progress = [this, &read, &queue]() {
+    if (m_handle && m_itemCount > 0)
+    {
+      std::unique_lock<CCriticalSection> lock(queue->section);
+      m_handle->SetPercentage(static_cast<float>((m_currentItem + read + queue->done) * 100) /
+                              static_cast<float>(m_itemCount));
+    }
+  };
+
+  for (auto& file : local)
+  {
+    if (m_bStop)
+      break;
+    file.second->Load(file.first->GetPath(), *file.first->GetMusicInfoTag());
+    read++;
+    progress();
+  }
+
+  while (!m_bStop && queue->ReadNext())
+    progress();
+
+  // the jobs write into the items, wait for the files they are reading
+  std::unique_lock<CCriticalSection> lock(queue->section);
+  while (!queue->condition.wait(queue->section, 100ms, [&queue]() { return queue->Finished(); }))
+  {
+    if (m_bStop)
+      queue->stop = true;
+  }
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
@@ -909,12 +1082,25 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 {
   MAPSONGS songsMap;
 
+  // read the tags before writing anything. The albums of local folders go in one transaction
+  // with those of the folders before, a remote folder gets a short transaction of its own that
+  // DoScan commits once the folder is written, as its files may take long to read and no
+  // transaction is kept open meanwhile
+  CFileItemList scannedItems;
+  const INFO_RET ret = ScanTags(items, scannedItems);
+
+  CommitAlbums(URIUtils::IsRemote(strDirectory));
+  if (!m_musicDatabase.InBatch())
+  {
+    m_musicDatabase.BeginBatch();
+    m_batchStart = std::chrono::steady_clock::now();
+  }
+
   // get all information for all files in current directory from database, and remove them
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
 
-  CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
+  if (ret == INFO_CANCELLED || scannedItems.Size() == 0)
     return 0;
 
   VECALBUMS albums;
@@ -969,9 +1155,24 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
     numAdded += static_cast<int>(album.songs.size());
   }
+  if (m_musicDatabase.InBatch())
+    m_batchSongs += numAdded;
   return numAdded;
 }
 
+void CMusicInfoScanner::CommitAlbums(bool force)
+{
+  if (!m_musicDatabase.InBatch())
+    return;
+
+  if (force || m_batchSongs >= BATCH_SONGS ||
+      std::chrono::steady_clock::now() - m_batchStart >= BATCH_TIME)
+  {
+    m_musicDatabase.CommitBatch();
+    m_batchSongs = 0;
+  }
+}
+
 void MUSIC_INFO::CMusicInfoScanner::ScrapeInfoAddedAlbums()
 {
   /* Strategy: Having scanned tags, make a list of albums and add them to the library, only then try
@@ -16,8 +16,12 @@
 #include "threads/Thread.h"
 #include "utils/ScraperUrl.h"
 
+#include <chrono>
+#include <memory>
+
 class CAlbum;
 class CArtist;
+class CFileItem;
 class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
@@ -231,6 +235,23 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Read the tags of the files of a folder
+   Files read with TagLib or FFmpeg are read by a few jobs at once, the scanner
+   thread reads along and does the files of other loaders, e.g. audio decoder
+   addons, on its own. The scanner scans one folder at a time, so the number of
+   jobs also limits the reads in flight on the share of that folder.
+   \param files [in/out] files to read, the tags are set
+   */
+  void ReadTags(const std::vector<std::shared_ptr<CFileItem>>& files);
+
+  /*! \brief Commit the albums added since the last commit
+   Albums of local folders are added in one transaction for many folders, it is
+   committed once it holds enough songs or has been open for a while, and before
+   a remote folder is read.
+   \param force [in] commit whatever has been added
+   */
+  void CommitAlbums(bool force);
   int GetPathHash(const CFileItemList &items, std::string &hash);
 
   void Run() override;
@@ -257,6 +278,8 @@ protected:
   CMusicDatabase m_musicDatabase;
 
   std::set<int> m_albumsAdded;
+  int m_batchSongs = 0; //!< songs added in the open transaction
+  std::chrono::steady_clock::time_point m_batchStart;
 
   std::set<std::string> m_seenPaths;
   int m_flags;
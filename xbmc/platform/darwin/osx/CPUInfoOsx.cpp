@@ -51,11 +51,14 @@ CCPUInfoOsx::CCPUInfoOsx() : m_resourceCounter(new CPosixResourceCounter())
     m_cores.emplace_back(coreInfo);
   }
 
+  bool hasFma = false;
   buffer = {};
   if (sysctlbyname("machdep.cpu.features", buffer.data(), &bufferLength, nullptr, 0) == 0)
   {
     std::string features = buffer.data();
 
+    hasFma = features.find("FMA") != std::string::npos;
+
     if (features.find("MMX") != std::string::npos)
       m_cpuFeatures |= CPU_FEATURE_MMX;
 
@@ -89,6 +92,20 @@ CCPUInfoOsx::CCPUInfoOsx() : m_resourceCounter(new CPosixResourceCounter())
   else
     m_cpuFeatures |= CPU_FEATURE_MMX;
 
+  // the os saves the avx registers if the cpu has them
+  buffer = {};
+  bufferLength = buffer.size();
+  if (sysctlbyname("machdep.cpu.leaf7_features", buffer.data(), &bufferLength, nullptr, 0) == 0)
+  {
+    std::string features = buffer.data();
+
+    if (features.find("AVX2") != std::string::npos && hasFma)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
+
+    if (features.find("AVX512F") != std::string::npos)
+      m_cpuFeatures |= CPU_FEATURE_AVX512;
+  }
+
   // Set MMX2 when SSE is present as SSE is a superset of MMX2 and Intel doesn't set the MMX2 cap
   if (m_cpuFeatures & CPU_FEATURE_SSE)
     m_cpuFeatures |= CPU_FEATURE_MMX2;
@@ -228,6 +228,22 @@ CCPUInfoLinux::CCPUInfoLinux()
         m_cpuFeatures |= CPU_FEATURE_3DNOWEXT;
     }
   }
+
+  if (__get_cpuid(CPUID_INFOTYPE_STANDARD, &eax, &ebx, &ecx, &edx))
+  {
+    const unsigned int standardEcx = ecx;
+    unsigned long long xcr0 = 0;
+    if (standardEcx & CPUID_00000001_ECX_OSXSAVE)
+    {
+      unsigned int xcr0Low;
+      unsigned int xcr0High;
+      __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+      xcr0 = (static_cast<unsigned long long>(xcr0High) << 32) | xcr0Low;
+    }
+
+    if (__get_cpuid_count(CPUID_INFOTYPE_STRUCTURED_EXTENDED, 0, &eax, &ebx, &ecx, &edx))
+      m_cpuFeatures |= GetAVXFeatures(standardEcx, ebx, xcr0);
+  }
 #else
   std::ifstream cpuinfo("/proc/cpuinfo");
   std::regex re(".*: (.*)$");
@@ -0,0 +1,297 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InotifyDirectoryWatcher.h"
+
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace
+{
+// the folder's entries and the files in it, writes are seen once the file is closed
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_ONLYDIR | IN_DONT_FOLLOW;
+
+bool IsNetworkFileSystem(const std::string& path)
+{
+  struct statfs fs;
+  if (statfs(path.c_str(), &fs) != 0)
+    return true;
+
+  switch (static_cast<unsigned long>(fs.f_type))
+  {
+    case 0x6969: // nfs
+    case 0x517B: // smbfs
+    case 0xFF534D42: // cifs
+    case 0xFE534D42: // smb2
+    case 0x65735546: // fuse, e.g. sshfs
+    case 0x01021997: // 9p
+    case 0x00C36400: // ceph
+    case 0x5346414F: // afs
+    case 0x73757245: // coda
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+CInotifyDirectoryWatcher::CInotifyDirectoryWatcher() : CThread("InotifyWatcher")
+{
+}
+
+CInotifyDirectoryWatcher::~CInotifyDirectoryWatcher()
+{
+  if (m_wakeupfd >= 0)
+  {
+    StopThread(false);
+    eventfd_write(m_wakeupfd, 1);
+    StopThread(true);
+    close(m_wakeupfd);
+  }
+
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CInotifyDirectoryWatcher::Start(IEventHandler& handler)
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: inotify_init1 failed ({})", errno);
+    return false;
+  }
+
+  m_wakeupfd = eventfd(0, EFD_CLOEXEC);
+  if (m_wakeupfd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: eventfd failed ({})", errno);
+    return false;
+  }
+
+  m_handler = &handler;
+  Create();
+  return true;
+}
+
+bool CInotifyDirectoryWatcher::Watch(const std::string& path)
+{
+  // nothing is reported once the thread is gone
+  if (path.empty() || path[0] != '/' || !IsRunning())
+    return false;
+
+  // a symlinked folder is watched as the link, the target is not seen
+  struct stat st;
+  if (lstat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+    return false;
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+  return WatchTree(path);
+}
+
+bool CInotifyDirectoryWatcher::WatchTree(const std::string& path)
+{
+  std::vector<int> added;
+  if (AddWatches(path, added))
+    return true;
+
+  // the tree is of no use, its watches would only use up those of the user
+  for (int wd : added)
+  {
+    inotify_rm_watch(m_fd, wd);
+    m_paths.erase(wd);
+  }
+  return false;
+}
+
+bool CInotifyDirectoryWatcher::AddWatches(const std::string& path, std::vector<int>& added)
+{
+  if (IsNetworkFileSystem(path))
+    return false;
+
+  const int wd = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    // ENOSPC once fs.inotify.max_user_watches is reached
+    CLog::Log(LOGWARNING, "CInotifyDirectoryWatcher: unable to watch {} ({})", path,
+              strerror(errno));
+    return false;
+  }
+  if (m_paths.find(wd) == m_paths.end())
+    added.push_back(wd);
+  m_paths[wd] = path;
+
+  DIR* dir = opendir(path.c_str());
+  if (!dir)
+    return false;
+
+  bool watched = true;
+  while (struct dirent* entry = readdir(dir))
+  {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+
+    const std::string child = path + entry->d_name + "/";
+    unsigned char type = entry->d_type;
+    if (type == DT_UNKNOWN || type == DT_LNK)
+    {
+      struct stat st;
+      if (lstat(child.substr(0, child.size() - 1).c_str(), &st) != 0)
+        continue;
+      if (S_ISLNK(st.st_mode))
+      {
+        // a link to a folder is scanned, but changes in it are not seen
+        if (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+          watched = false;
+        continue;
+      }
+      type = S_ISDIR(st.st_mode) ? DT_DIR : DT_REG;
+    }
+
+    if (type == DT_DIR && !AddWatches(child, added))
+      watched = false;
+  }
+  closedir(dir);
+  return watched;
+}
+
+void CInotifyDirectoryWatcher::RemoveWatches(const std::string& path)
+{
+  for (auto it = m_paths.begin(); it != m_paths.end();)
+  {
+    if (StringUtils::StartsWith(it->second, path))
+    {
+      inotify_rm_watch(m_fd, it->first);
+      it = m_paths.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CInotifyDirectoryWatcher::Sync()
+{
+  if (IsRunning())
+    ReadEvents();
+}
+
+void CInotifyDirectoryWatcher::Process()
+{
+  while (!m_bStop)
+  {
+    struct pollfd fds[2] = {{m_fd, POLLIN, 0}, {m_wakeupfd, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      CLog::Log(LOGERROR, "CInotifyDirectoryWatcher: poll failed ({})", errno);
+      m_handler->OnWatchLost();
+      return;
+    }
+    if (m_bStop)
+      break;
+
+    ReadEvents();
+  }
+}
+
+void CInotifyDirectoryWatcher::ReadEvents()
+{
+  alignas(struct inotify_event) char buffer[16 * 1024];
+
+  std::unique_lock<CCriticalSection> readLock(m_readSection);
+  while (true)
+  {
+    const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      return;
+
+    std::vector<std::string> changed;
+    std::vector<std::string> replaced;
+    bool lost = false;
+    {
+      std::unique_lock<CCriticalSection> lock(m_section);
+
+      const struct inotify_event* event;
+      for (const char* ptr = buffer; ptr < buffer + length; ptr += sizeof(*event) + event->len)
+      {
+        event = reinterpret_cast<const struct inotify_event*>(ptr);
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+          lost = true;
+          continue;
+        }
+
+        auto it = m_paths.find(event->wd);
+        if (it == m_paths.end())
+          continue;
+        const std::string folder = it->second;
+
+        if (event->mask & IN_IGNORED)
+        {
+          m_paths.erase(it);
+          continue;
+        }
+
+        if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+        {
+          // the parent reports it, unless it is a watched path itself
+          if (std::none_of(m_paths.begin(), m_paths.end(), [&folder](const auto& path) {
+                return path.second.size() < folder.size() &&
+                       StringUtils::StartsWith(folder, path.second);
+              }))
+            lost = true;
+          continue;
+        }
+
+        if ((event->mask & IN_ISDIR) && event->len > 0)
+        {
+          const std::string child = folder + event->name + "/";
+          if (event->mask & (IN_CREATE | IN_MOVED_TO))
+          {
+            if (!WatchTree(child))
+              lost = true;
+            replaced.push_back(child);
+          }
+          else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+          {
+            RemoveWatches(child);
+            replaced.push_back(child);
+          }
+        }
+
+        if (changed.empty() || changed.back() != folder)
+          changed.push_back(folder);
+      }
+    }
+
+    // not under m_section, the handler may be in Watch()
+    for (const std::string& path : replaced)
+      m_handler->OnDirectoryReplaced(path);
+    for (const std::string& path : changed)
+      m_handler->OnDirectoryChanged(path);
+    if (lost)
+      m_handler->OnWatchLost();
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Watches local folders with inotify
+
+ inotify watches single folders, every folder below a watched path gets its
+ own watch. Folders on network file systems are refused, changes made on the
+ server never show up.
+ */
+class CInotifyDirectoryWatcher : public XFILE::IDirectoryWatcher, private CThread
+{
+public:
+  CInotifyDirectoryWatcher();
+  ~CInotifyDirectoryWatcher() override;
+
+  bool Start(IEventHandler& handler) override;
+  bool Watch(const std::string& path) override;
+  void Sync() override;
+
+private:
+  void Process() override;
+
+  //! report the events queued by the kernel, m_fd does not block
+  void ReadEvents();
+
+  //! watch a folder and the folders below it, call with m_section locked
+  //! \return false if any of them can't be watched, none of the new watches are kept then
+  bool WatchTree(const std::string& path);
+  //! \param added [out] watches that were not there before
+  bool AddWatches(const std::string& path, std::vector<int>& added);
+  //! stop watching a folder and the folders below it, call with m_section locked
+  void RemoveWatches(const std::string& path);
+
+  int m_fd = -1;
+  int m_wakeupfd = -1;
+  IEventHandler* m_handler = nullptr;
+
+  CCriticalSection m_readSection; //!< one reader of m_fd at a time, the events stay in order
+  CCriticalSection m_section;
+  std::map<int, std::string> m_paths; //!< watched folders by watch descriptor
+};
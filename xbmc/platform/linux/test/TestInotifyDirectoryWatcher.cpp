@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "platform/linux/InotifyDirectoryWatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+#include <dirent.h>
+#include <ftw.h>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+class CTestHandler : public XFILE::IDirectoryWatcher::IEventHandler
+{
+public:
+  void OnDirectoryChanged(const std::string& path) override
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.insert(path);
+  }
+
+  void OnDirectoryReplaced(const std::string& path) override
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_replaced.insert(path);
+  }
+
+  void OnWatchLost() override { m_lost = true; }
+
+  bool WaitForChange(const std::string& path)
+  {
+    for (int i = 0; i < 200; i++)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_changed.find(path) != m_changed.end())
+          return true;
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    return false;
+  }
+
+  bool HasChange(const std::string& path)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_changed.find(path) != m_changed.end();
+  }
+
+  bool IsReplaced(const std::string& path)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_replaced.find(path) != m_replaced.end();
+  }
+
+  void Clear()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.clear();
+    m_replaced.clear();
+  }
+
+  std::atomic<bool> m_lost{false};
+
+private:
+  std::mutex m_mutex;
+  std::set<std::string> m_changed;
+  std::set<std::string> m_replaced;
+};
+
+// inotify watches of the process, the kernel lists them in the fdinfo of the inotify fds
+int CountWatches()
+{
+  int count = 0;
+  DIR* dir = opendir("/proc/self/fdinfo");
+  if (!dir)
+    return -1;
+  while (struct dirent* entry = readdir(dir))
+  {
+    std::ifstream info(std::string("/proc/self/fdinfo/") + entry->d_name);
+    std::string line;
+    while (std::getline(info, line))
+    {
+      if (line.rfind("inotify wd:", 0) == 0)
+        count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+struct TestInotifyDirectoryWatcher : public ::testing::Test
+{
+  TestInotifyDirectoryWatcher()
+  {
+    std::string tmpdir{"/tmp"};
+    const char* test_tmpdir = getenv("TMPDIR");
+    if (test_tmpdir && test_tmpdir[0] != '\0')
+      tmpdir.assign(test_tmpdir);
+
+    std::string pattern = tmpdir + "/kodi-test-XXXXXX";
+    if (mkdtemp(&pattern[0]))
+      m_root = pattern + "/";
+  }
+
+  ~TestInotifyDirectoryWatcher() override
+  {
+    if (!m_root.empty())
+      nftw(
+          m_root.c_str(),
+          [](const char* path, const struct stat*, int, struct FTW*) { return remove(path); }, 16,
+          FTW_DEPTH | FTW_PHYS);
+  }
+
+  std::string m_root;
+};
+} // namespace
+
+TEST_F(TestInotifyDirectoryWatcher, ReportsChanges)
+{
+  ASSERT_FALSE(m_root.empty());
+  ASSERT_EQ(mkdir((m_root + "a").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "a/b").c_str(), 0755), 0);
+
+  CTestHandler handler;
+  CInotifyDirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Start(handler));
+  ASSERT_TRUE(watcher.Watch(m_root));
+
+  // a file written deep down
+  std::ofstream(m_root + "a/b/movie.mkv") << "data";
+  EXPECT_TRUE(handler.WaitForChange(m_root + "a/b/"));
+
+  // a new folder is reported and watched
+  handler.Clear();
+  ASSERT_EQ(mkdir((m_root + "c").c_str(), 0755), 0);
+  EXPECT_TRUE(handler.WaitForChange(m_root));
+  EXPECT_TRUE(handler.IsReplaced(m_root + "c/"));
+
+  handler.Clear();
+  std::ofstream(m_root + "c/episode.mkv") << "data";
+  EXPECT_TRUE(handler.WaitForChange(m_root + "c/"));
+
+  // a removed folder
+  handler.Clear();
+  ASSERT_EQ(unlink((m_root + "a/b/movie.mkv").c_str()), 0);
+  ASSERT_EQ(rmdir((m_root + "a/b").c_str()), 0);
+  EXPECT_TRUE(handler.WaitForChange(m_root + "a/"));
+  EXPECT_TRUE(handler.IsReplaced(m_root + "a/b/"));
+  EXPECT_FALSE(handler.m_lost);
+}
+
+TEST_F(TestInotifyDirectoryWatcher, Refuses)
+{
+  ASSERT_FALSE(m_root.empty());
+
+  CTestHandler handler;
+  CInotifyDirectoryWatcher watcher;
+  EXPECT_FALSE(watcher.Watch(m_root)); // not started
+  ASSERT_TRUE(watcher.Start(handler));
+
+  EXPECT_FALSE(watcher.Watch("smb://server/share/"));
+  EXPECT_FALSE(watcher.Watch(m_root + "missing/"));
+
+  // changes behind a symlinked folder are not seen
+  ASSERT_EQ(mkdir((m_root + "target").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "source").c_str(), 0755), 0);
+  ASSERT_EQ(symlink((m_root + "target").c_str(), (m_root + "source/link").c_str()), 0);
+  EXPECT_TRUE(watcher.Watch(m_root + "target/"));
+  EXPECT_FALSE(watcher.Watch(m_root + "source/"));
+}
+
+TEST_F(TestInotifyDirectoryWatcher, NoWatchesLeftOnFailure)
+{
+  ASSERT_FALSE(m_root.empty());
+  ASSERT_EQ(mkdir((m_root + "a").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "a/b").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "a/c").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "a/c/d").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((m_root + "target").c_str(), 0755), 0);
+  ASSERT_EQ(symlink((m_root + "target").c_str(), (m_root + "a/c/link").c_str()), 0);
+
+  CTestHandler handler;
+  CInotifyDirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Start(handler));
+  const int watches = CountWatches();
+  ASSERT_GE(watches, 0);
+
+  // the folders watched before the symlink was found are given up
+  EXPECT_FALSE(watcher.Watch(m_root + "a/"));
+  EXPECT_EQ(CountWatches(), watches);
+
+  // a tree watched on its own stays watched
+  EXPECT_TRUE(watcher.Watch(m_root + "a/b/"));
+  EXPECT_EQ(CountWatches(), watches + 1);
+  EXPECT_FALSE(watcher.Watch(m_root + "a/"));
+  EXPECT_EQ(CountWatches(), watches + 1);
+
+  std::ofstream(m_root + "a/b/song.flac") << "data";
+  EXPECT_TRUE(handler.WaitForChange(m_root + "a/b/"));
+}
+
+TEST_F(TestInotifyDirectoryWatcher, SyncReportsQueuedChanges)
+{
+  ASSERT_FALSE(m_root.empty());
+
+  CTestHandler handler;
+  CInotifyDirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Start(handler));
+  ASSERT_TRUE(watcher.Watch(m_root));
+
+  // reported by the time Sync() returns, whether the thread or Sync() read it
+  for (int i = 0; i < 20; i++)
+  {
+    handler.Clear();
+    const std::string folder = m_root + std::to_string(i) + "/";
+    ASSERT_EQ(mkdir(folder.c_str(), 0755), 0);
+    watcher.Sync();
+    EXPECT_TRUE(handler.HasChange(m_root));
+    EXPECT_TRUE(handler.IsReplaced(folder));
+  }
+}
@@ -14,6 +14,9 @@
 #include "utils/StringUtils.h"
 #include "utils/Temperature.h"
 
+#ifndef _M_ARM
+#include <immintrin.h>
+#endif
 #include <winrt/Windows.Foundation.Metadata.h>
 #include <winrt/Windows.System.Diagnostics.h>
 
@@ -62,6 +65,16 @@ CCPUInfoWin10::CCPUInfoWin10()
       m_cpuFeatures |= CPU_FEATURE_SSE42;
   }
 
+  if (MaxStdInfoType >= CPUID_INFOTYPE_STRUCTURED_EXTENDED)
+  {
+    __cpuid(CPUInfo, CPUID_INFOTYPE_STANDARD);
+    const unsigned int standardEcx = CPUInfo[CPUINFO_ECX];
+    const unsigned long long xcr0 =
+        (standardEcx & CPUID_00000001_ECX_OSXSAVE) ? _xgetbv(0) : 0;
+    __cpuidex(CPUInfo, CPUID_INFOTYPE_STRUCTURED_EXTENDED, 0);
+    m_cpuFeatures |= GetAVXFeatures(standardEcx, CPUInfo[CPUINFO_EBX], xcr0);
+  }
+
   __cpuid(CPUInfo, 0x80000000);
   int MaxExtInfoType = CPUInfo[0];
 
@@ -20,6 +20,7 @@
 
 #include <Pdh.h>
 #include <PdhMsg.h>
+#include <immintrin.h>
 #include <intrin.h>
 
 #pragma comment(lib, "Pdh.lib")
@@ -148,6 +149,16 @@ CCPUInfoWin32::CCPUInfoWin32()
       m_cpuFeatures |= CPU_FEATURE_SSE42;
   }
 
+  if (MaxStdInfoType >= CPUID_INFOTYPE_STRUCTURED_EXTENDED)
+  {
+    __cpuid(CPUInfo, CPUID_INFOTYPE_STANDARD);
+    const unsigned int standardEcx = CPUInfo[CPUINFO_ECX];
+    const unsigned long long xcr0 =
+        (standardEcx & CPUID_00000001_ECX_OSXSAVE) ? _xgetbv(0) : 0;
+    __cpuidex(CPUInfo, CPUID_INFOTYPE_STRUCTURED_EXTENDED, 0);
+    m_cpuFeatures |= GetAVXFeatures(standardEcx, CPUInfo[CPUINFO_EBX], xcr0);
+  }
+
   __cpuid(CPUInfo, CPUID_INFOTYPE_EXTENDED_IMPLEMENTED);
   if (CPUInfo[0] >= CPUID_INFOTYPE_EXTENDED)
   {
@@ -594,6 +594,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
     XMLUtils::GetUInt(pElement, "maxpassthroughoffsyncduration", m_maxPassthroughOffSyncDuration,
                       10, 100);
+    XMLUtils::GetBoolean(pElement, "sharedenginethread", m_audioSharedEngineThread);
   }
 
   pElement = pRootElement->FirstChildElement("x11");
@@ -742,6 +743,16 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     //0 = disable fps detect, 1 = only detect on timestamps with uniform spacing, 2 detect on all timestamps
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
+    XMLUtils::GetBoolean(pElement, "demuxprefetch", m_videoDemuxPrefetch);
+    XMLUtils::GetBoolean(pElement, "softwarerenderer", m_videoSoftwareRenderer);
+    // thumbs are extracted as pausable jobs, of which the job manager runs at most 2 at once
+    if (XMLUtils::GetUInt(pElement, "extractthumbjobs", m_videoExtractThumbJobs, 1, 4) &&
+        m_videoExtractThumbJobs > 2)
+    {
+      CLog::Log(LOGWARNING, "extractthumbjobs {} exceeds the 2 pausable jobs run at once, using 2",
+                m_videoExtractThumbJobs);
+      m_videoExtractThumbJobs = 2;
+    }
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
 
@@ -797,6 +808,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
     XMLUtils::GetBoolean(pElement, "useisodates", m_bMusicLibraryUseISODates);
+    XMLUtils::GetInt(pElement, "tagreaders", m_musicLibraryTagReaders, 0, 16);
+    XMLUtils::GetBoolean(pElement, "usedirectorywatcher", m_musicLibraryUseDirectoryWatcher);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -822,6 +835,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iVideoLibraryRecentlyAddedItems, 1, INT_MAX);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bVideoLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "usefasthash", m_bVideoLibraryUseFastHash);
+    XMLUtils::GetInt(pElement, "scanthreads", m_videoLibraryScanThreads, 0, 16);
+    XMLUtils::GetBoolean(pElement, "usedirectorywatcher", m_videoLibraryUseDirectoryWatcher);
     XMLUtils::GetString(pElement, "itemseparator", m_videoItemSeparator);
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
@@ -160,6 +160,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_videoIgnorePercentAtEnd;
     float m_audioApplyDrc;
     unsigned int m_maxPassthroughOffSyncDuration = 10; // when 10 ms off adjust
+    bool m_audioSharedEngineThread = false; // run both audio engines on one thread
 
     int   m_videoVDPAUScaling;
     float m_videoNonLinStretchRatio;
@@ -171,6 +172,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
     int  m_videoFpsDetect;
+    bool m_videoDemuxPrefetch = false; // read packets ahead on a demux thread
+    bool m_videoSoftwareRenderer = false; // render video to memory instead of the gpu
+    unsigned int m_videoExtractThumbJobs = 2; // files to extract thumbs from at once, 1 or 2 (pausable jobs)
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
 
@@ -251,6 +255,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
     bool m_bMusicLibraryUseISODates;
+    int m_musicLibraryTagReaders = 4; // jobs reading the tags of a folder, 0 or 1 = scanner thread only
+    bool m_musicLibraryUseDirectoryWatcher = true; // skip local folders not changed since the last scan
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
@@ -262,6 +268,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iVideoLibraryRecentlyAddedItems;
     bool m_bVideoLibraryCleanOnUpdate;
     bool m_bVideoLibraryUseFastHash;
+    int m_videoLibraryScanThreads = 4; // threads listing folders ahead of the scanner, 0 = off
+    bool m_videoLibraryUseDirectoryWatcher = true; // skip local folders not changed since the last scan
     bool m_bVideoLibraryImportWatchedState{true};
     bool m_bVideoLibraryImportResumePoint{true};
     std::vector<std::string> m_videoEpisodeExtraArt;
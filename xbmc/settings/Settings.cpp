@@ -398,6 +398,7 @@ constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_STEREOUPMIX;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_MAINTAINORIGINALVOLUME;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_PROCESSQUALITY;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_ATEMPOTHRESHOLD;
+constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_SYNCOFFSET;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_STREAMSILENCE;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_STREAMNOISE;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT2_GUISOUNDMODE;
@@ -399,6 +399,7 @@ public:
       "audiooutput2.maintainoriginalvolume";
   static constexpr auto SETTING_AUDIOOUTPUT2_PROCESSQUALITY = "audiooutput2.processquality";
   static constexpr auto SETTING_AUDIOOUTPUT2_ATEMPOTHRESHOLD = "audiooutput2.atempothreshold";
+  static constexpr auto SETTING_AUDIOOUTPUT2_SYNCOFFSET = "audiooutput2.syncoffset";
   static constexpr auto SETTING_AUDIOOUTPUT2_STREAMSILENCE = "audiooutput2.streamsilence";
   static constexpr auto SETTING_AUDIOOUTPUT2_STREAMNOISE = "audiooutput2.streamnoise";
   static constexpr auto SETTING_AUDIOOUTPUT2_GUISOUNDMODE = "audiooutput2.guisoundmode";
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace XbmcThreads
+{
+
+/*!
+ * \brief Bounded single producer / single consumer queue
+ *
+ * Push and Pop never block and never take a lock. Push must only be called
+ * from one thread and Pop only from one other thread. Waking up the consumer
+ * is left to the caller.
+ */
+template<typename T>
+class CSPSCQueue
+{
+public:
+  /*!
+   * \param capacity number of items the queue can hold, rounded up to a power of two
+   */
+  explicit CSPSCQueue(size_t capacity)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    m_items.resize(size);
+    m_mask = size - 1;
+  }
+
+  CSPSCQueue(const CSPSCQueue&) = delete;
+  CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+  /*!
+   * \brief Append an item, producer side
+   * \return false if the queue is full
+   */
+  bool Push(const T& item)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+      return false;
+
+    m_items[tail & m_mask] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Append an item, producer side, item is only moved from on success
+   * \return false if the queue is full
+   */
+  bool Push(T&& item)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+      return false;
+
+    m_items[tail & m_mask] = std::move(item);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Remove the oldest item, consumer side
+   * \return false if the queue is empty
+   */
+  bool Pop(T& item)
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+
+    // move, so that the slot does not keep the item alive
+    item = std::move(m_items[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Oldest item without removing it, consumer side
+   * \return nullptr if the queue is empty
+   */
+  T* Front()
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return nullptr;
+
+    return &m_items[head & m_mask];
+  }
+
+  bool IsEmpty() const
+  {
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+  }
+
+  //! may be called from any thread, the result is a snapshot
+  size_t GetSize() const
+  {
+    const size_t head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+
+  size_t GetCapacity() const { return m_items.size(); }
+
+private:
+  std::vector<T> m_items;
+  size_t m_mask = 0;
+  // keep the indices on separate cache lines, each is written by one side only
+  alignas(64) std::atomic<size_t> m_head{0};
+  alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+} // namespace XbmcThreads
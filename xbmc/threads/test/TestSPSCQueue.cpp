@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/SPSCQueue.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace XbmcThreads;
+
+TEST(TestSPSCQueue, CapacityIsPowerOfTwo)
+{
+  CSPSCQueue<int> queue(5);
+  EXPECT_EQ(8u, queue.GetCapacity());
+}
+
+TEST(TestSPSCQueue, FullAndEmpty)
+{
+  CSPSCQueue<int> queue(4);
+  int item = 0;
+
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.Pop(item));
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(4));
+
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.Pop(item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TestSPSCQueue, KeepsOrderAcrossThreads)
+{
+  CSPSCQueue<int> queue(16);
+  constexpr int count = 100000;
+
+  std::thread producer([&queue]() {
+    for (int i = 0; i < count; i++)
+    {
+      while (!queue.Push(i))
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < count)
+  {
+    int item;
+    if (!queue.Pop(item))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(expected, item);
+    expected++;
+  }
+
+  producer.join();
+  EXPECT_TRUE(queue.IsEmpty());
+}
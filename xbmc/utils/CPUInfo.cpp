@@ -21,6 +21,25 @@ bool CCPUInfo::HasCoreId(int coreId) const
   return false;
 }
 
+unsigned int CCPUInfo::GetAVXFeatures(unsigned int standardEcx,
+                                      unsigned int structuredEbx,
+                                      unsigned long long xcr0) const
+{
+  unsigned int features = 0;
+
+  if (!(standardEcx & CPUID_00000001_ECX_OSXSAVE) || !(standardEcx & CPUID_00000001_ECX_AVX))
+    return features;
+
+  if ((xcr0 & XCR0_AVX) == XCR0_AVX && (structuredEbx & CPUID_00000007_EBX_AVX2) &&
+      (standardEcx & CPUID_00000001_ECX_FMA))
+    features |= CPU_FEATURE_AVX2;
+
+  if ((xcr0 & XCR0_AVX512) == XCR0_AVX512 && (structuredEbx & CPUID_00000007_EBX_AVX512F))
+    features |= CPU_FEATURE_AVX512;
+
+  return features;
+}
+
 const CoreInfo CCPUInfo::GetCoreInfo(int coreId)
 {
   CoreInfo coreInfo;
@@ -30,6 +30,8 @@ enum CpuFeature
   CPU_FEATURE_3DNOWEXT = 1 << 9,
   CPU_FEATURE_ALTIVEC = 1 << 10,
   CPU_FEATURE_NEON = 1 << 11,
+  CPU_FEATURE_AVX2 = 1 << 12, // includes FMA
+  CPU_FEATURE_AVX512 = 1 << 13, // AVX-512F
 };
 
 struct CoreInfo
@@ -47,6 +49,7 @@ public:
   // Defines to help with calls to CPUID
   const unsigned int CPUID_INFOTYPE_MANUFACTURER = 0x00000000;
   const unsigned int CPUID_INFOTYPE_STANDARD = 0x00000001;
+  const unsigned int CPUID_INFOTYPE_STRUCTURED_EXTENDED = 0x00000007;
   const unsigned int CPUID_INFOTYPE_EXTENDED_IMPLEMENTED = 0x80000000;
   const unsigned int CPUID_INFOTYPE_EXTENDED = 0x80000001;
   const unsigned int CPUID_INFOTYPE_PROCESSOR_1 = 0x80000002;
@@ -59,11 +62,23 @@ public:
   const unsigned int CPUID_00000001_ECX_SSSE3 = (1 << 9);
   const unsigned int CPUID_00000001_ECX_SSE4 = (1 << 19);
   const unsigned int CPUID_00000001_ECX_SSE42 = (1 << 20);
+  const unsigned int CPUID_00000001_ECX_FMA = (1 << 12);
+  const unsigned int CPUID_00000001_ECX_OSXSAVE = (1 << 27);
+  const unsigned int CPUID_00000001_ECX_AVX = (1 << 28);
 
   const unsigned int CPUID_00000001_EDX_MMX = (1 << 23);
   const unsigned int CPUID_00000001_EDX_SSE = (1 << 25);
   const unsigned int CPUID_00000001_EDX_SSE2 = (1 << 26);
 
+  // Structured Extended Features
+  // Bitmasks for the values returned by a call to cpuid with eax=0x00000007, ecx=0
+  const unsigned int CPUID_00000007_EBX_AVX2 = (1 << 5);
+  const unsigned int CPUID_00000007_EBX_AVX512F = (1 << 16);
+
+  // Register state the OS saves on context switches, read with xgetbv
+  const unsigned long long XCR0_AVX = 0x06; // xmm, ymm
+  const unsigned long long XCR0_AVX512 = 0xE6; // xmm, ymm, opmask, zmm
+
   // Extended Features
   // Bitmasks for the values returned by a call to cpuid with eax=0x80000001
   const unsigned int CPUID_80000001_EDX_MMX2 = (1 << 22);
@@ -99,6 +114,18 @@ protected:
   CCPUInfo() = default;
   virtual ~CCPUInfo() = default;
 
+  /*!
+   * \brief CpuFeature flags for AVX2 and AVX-512
+   *
+   * Only set if the OS saves the wide registers on context switches.
+   * \param standardEcx ecx of cpuid 0x00000001
+   * \param structuredEbx ebx of cpuid 0x00000007, sub leaf 0
+   * \param xcr0 xgetbv(0), 0 if OSXSAVE is not set
+   */
+  unsigned int GetAVXFeatures(unsigned int standardEcx,
+                              unsigned int structuredEbx,
+                              unsigned long long xcr0) const;
+
   int m_lastUsedPercentage;
   XbmcThreads::EndTime<> m_nextUsedReadTime;
   std::string m_cpuVendor;
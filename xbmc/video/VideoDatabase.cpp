@@ -3875,6 +3875,77 @@ CVideoInfoTag CVideoDatabase::GetDetailsByTypeAndId(VideoDbContentType type, int
   return {};
 }
 
+namespace
+{
+// ids per IN (...) list of the detail queries, keeps the statements short
+constexpr size_t DETAILS_CHUNK_SIZE = 500;
+
+std::vector<std::string> GetIdLists(const std::map<int, std::vector<CVideoInfoTag*>>& items)
+{
+  std::vector<std::string> lists;
+  std::string list;
+  size_t count = 0;
+  for (const auto& item : items)
+  {
+    if (!list.empty())
+      list += ",";
+    list += std::to_string(item.first);
+    if (++count == DETAILS_CHUNK_SIZE)
+    {
+      lists.emplace_back(std::move(list));
+      list.clear();
+      count = 0;
+    }
+  }
+  if (!list.empty())
+    lists.emplace_back(std::move(list));
+  return lists;
+}
+
+// one row of "SELECT * FROM streamdetails"
+bool AddStreamDetail(dbiplus::Dataset& ds, CStreamDetails& details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)ds.fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = ds.fv(2).get_asString();
+      p->m_fAspect = ds.fv(3).get_asFloat();
+      p->m_iWidth = ds.fv(4).get_asInt();
+      p->m_iHeight = ds.fv(5).get_asInt();
+      p->m_iDuration = ds.fv(10).get_asInt();
+      p->m_strStereoMode = ds.fv(11).get_asString();
+      p->m_strLanguage = ds.fv(12).get_asString();
+      p->m_strHdrType = ds.fv(13).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = ds.fv(6).get_asString();
+      if (ds.fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = ds.fv(7).get_asInt();
+      p->m_strLanguage = ds.fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = ds.fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
 bool CVideoDatabase::GetStreamDetails(CFileItem& item)
 {
   // Note that this function (possibly) creates VideoInfoTags for items that don't have one yet!
@@ -3912,46 +3983,8 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 
     while (!pDS->eof())
     {
-      CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-      switch (e)
-      {
-      case CStreamDetail::VIDEO:
-        {
-          CStreamDetailVideo *p = new CStreamDetailVideo();
-          p->m_strCodec = pDS->fv(2).get_asString();
-          p->m_fAspect = pDS->fv(3).get_asFloat();
-          p->m_iWidth = pDS->fv(4).get_asInt();
-          p->m_iHeight = pDS->fv(5).get_asInt();
-          p->m_iDuration = pDS->fv(10).get_asInt();
-          p->m_strStereoMode = pDS->fv(11).get_asString();
-          p->m_strLanguage = pDS->fv(12).get_asString();
-          p->m_strHdrType = pDS->fv(13).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::AUDIO:
-        {
-          CStreamDetailAudio *p = new CStreamDetailAudio();
-          p->m_strCodec = pDS->fv(6).get_asString();
-          if (pDS->fv(7).get_isNull())
-            p->m_iChannels = -1;
-          else
-            p->m_iChannels = pDS->fv(7).get_asInt();
-          p->m_strLanguage = pDS->fv(8).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::SUBTITLE:
-        {
-          CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-          p->m_strLanguage = pDS->fv(9).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      }
+      if (AddStreamDetail(*pDS, details))
+        retVal = true;
 
       pDS->next();
     }
@@ -4075,20 +4108,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
      GetUniqueIDs(details.m_iDbId, MediaTypeMovie, details);
 
     if (getDetails & VideoDbDetailsShowLink)
-    {
-      // create tvshowlink string
-      std::vector<int> links;
-      GetLinksToTvShow(idMovie, links);
-      for (unsigned int i = 0; i < links.size(); ++i)
-      {
-        std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
-          VIDEODB_ID_TV_TITLE, links[i]);
-        m_pDS2->query(strSQL);
-        if (!m_pDS2->eof())
-          details.m_showLink.emplace_back(m_pDS2->fv(0).get_asString());
-      }
-      m_pDS2->close();
-    }
+      GetShowLinks(idMovie, details.m_showLink);
 
     if (getDetails & VideoDbDetailsStream)
       GetStreamDetails(details);
@@ -4433,6 +4453,279 @@ void CVideoDatabase::GetUniqueIDs(int media_id, const std::string &media_type, C
   }
 }
 
+void CVideoDatabase::GetShowLinks(int idMovie, std::vector<std::string>& showLink)
+{
+  // create tvshowlink string
+  std::vector<int> links;
+  GetLinksToTvShow(idMovie, links);
+  for (unsigned int i = 0; i < links.size(); ++i)
+  {
+    std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
+      VIDEODB_ID_TV_TITLE, links[i]);
+    m_pDS2->query(strSQL);
+    if (!m_pDS2->eof())
+      showLink.emplace_back(m_pDS2->fv(0).get_asString());
+  }
+  m_pDS2->close();
+}
+
+void CVideoDatabase::GetDetailsForItems(std::vector<CVideoInfoTag>& items,
+                                        const std::string& mediaType,
+                                        int getDetails)
+{
+  if (items.empty() || !getDetails)
+    return;
+
+  DetailsById byId;
+  DetailsById byFile;
+  DetailsById byShow;
+  for (auto& item : items)
+  {
+    byId[item.m_iDbId].push_back(&item);
+    if (item.m_iFileId >= 0)
+      byFile[item.m_iFileId].push_back(&item);
+    if (mediaType == MediaTypeEpisode)
+      byShow[item.m_iIdShow].push_back(&item);
+  }
+
+  if (mediaType == MediaTypeMovie)
+  {
+    GetCastForItems(byId, MediaTypeMovie);
+
+    if (getDetails & VideoDbDetailsTag)
+      GetTagsForItems(byId, MediaTypeMovie);
+  }
+  else if (mediaType == MediaTypeEpisode && (getDetails & VideoDbDetailsCast))
+  {
+    // the cast of the show follows the guest stars
+    GetCastForItems(byId, MediaTypeEpisode);
+    GetCastForItems(byShow, MediaTypeTvShow);
+  }
+
+  if (getDetails & VideoDbDetailsRating)
+    GetRatingsForItems(byId, mediaType);
+
+  if (getDetails & VideoDbDetailsUniqueID)
+    GetUniqueIDsForItems(byId, mediaType);
+
+  if (getDetails & VideoDbDetailsStream)
+    GetStreamDetailsForItems(byFile);
+
+  for (auto& item : items)
+  {
+    if (mediaType == MediaTypeMovie && (getDetails & VideoDbDetailsShowLink))
+      GetShowLinks(item.m_iDbId, item.m_showLink);
+    if (mediaType == MediaTypeEpisode && (getDetails & VideoDbDetailsBookmark))
+      GetBookMarkForEpisode(item, item.m_EpBookmark);
+
+    item.m_parsedDetails = getDetails;
+  }
+}
+
+void CVideoDatabase::GetCastForItems(const DetailsById& items, const std::string& mediaType)
+{
+  try
+  {
+    if (!m_pDB)
+      return;
+    if (!m_pDS2)
+      return;
+
+    for (const std::string& ids : GetIdLists(items))
+    {
+      std::string sql = PrepareSQL("SELECT actor_link.media_id,"
+                                   "  actor.name,"
+                                   "  actor_link.role,"
+                                   "  actor_link.cast_order,"
+                                   "  actor.art_urls,"
+                                   "  art.url "
+                                   "FROM actor_link"
+                                   "  JOIN actor ON"
+                                   "    actor_link.actor_id=actor.actor_id"
+                                   "  LEFT JOIN art ON"
+                                   "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                                   "WHERE actor_link.media_id IN (%s) AND actor_link.media_type='%s' "
+                                   "ORDER BY actor_link.media_id, actor_link.cast_order",
+                                   ids.c_str(), mediaType.c_str());
+      m_pDS2->query(sql);
+      while (!m_pDS2->eof())
+      {
+        const auto it = items.find(m_pDS2->fv(0).get_asInt());
+        if (it != items.end())
+        {
+          SActorInfo info;
+          info.strName = m_pDS2->fv(1).get_asString();
+          info.strRole = m_pDS2->fv(2).get_asString();
+          info.order = m_pDS2->fv(3).get_asInt();
+          info.thumbUrl.ParseFromData(m_pDS2->fv(4).get_asString());
+          info.thumb = m_pDS2->fv(5).get_asString();
+
+          for (CVideoInfoTag* details : it->second)
+          {
+            // ignore identical actors (since cast might already be prefilled)
+            std::vector<SActorInfo>& cast = details->m_cast;
+            if (std::none_of(cast.begin(), cast.end(), [&info](const SActorInfo& actor) {
+                  return actor.strName == info.strName && actor.strRole == info.strRole;
+                }))
+              cast.emplace_back(info);
+          }
+        }
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, mediaType);
+  }
+}
+
+void CVideoDatabase::GetTagsForItems(const DetailsById& items, const std::string& mediaType)
+{
+  try
+  {
+    if (!m_pDB)
+      return;
+    if (!m_pDS2)
+      return;
+
+    for (const std::string& ids : GetIdLists(items))
+    {
+      std::string sql = PrepareSQL("SELECT tag_link.media_id, tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id IN (%s) AND tag_link.media_type = '%s' ORDER BY tag_link.media_id, tag.tag_id", ids.c_str(), mediaType.c_str());
+      m_pDS2->query(sql);
+      while (!m_pDS2->eof())
+      {
+        const auto it = items.find(m_pDS2->fv(0).get_asInt());
+        if (it != items.end())
+        {
+          for (CVideoInfoTag* details : it->second)
+            details->m_tags.emplace_back(m_pDS2->fv(1).get_asString());
+        }
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, mediaType);
+  }
+}
+
+void CVideoDatabase::GetRatingsForItems(const DetailsById& items, const std::string& mediaType)
+{
+  try
+  {
+    if (!m_pDB)
+      return;
+    if (!m_pDS2)
+      return;
+
+    for (const std::string& ids : GetIdLists(items))
+    {
+      std::string sql = PrepareSQL("SELECT rating.media_id, rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id IN (%s) AND rating.media_type = '%s'", ids.c_str(), mediaType.c_str());
+      m_pDS2->query(sql);
+      while (!m_pDS2->eof())
+      {
+        const auto it = items.find(m_pDS2->fv(0).get_asInt());
+        if (it != items.end())
+        {
+          for (CVideoInfoTag* details : it->second)
+            details->m_ratings[m_pDS2->fv(1).get_asString()] =
+                CRating(m_pDS2->fv(2).get_asFloat(), m_pDS2->fv(3).get_asInt());
+        }
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, mediaType);
+  }
+}
+
+void CVideoDatabase::GetUniqueIDsForItems(const DetailsById& items, const std::string& mediaType)
+{
+  try
+  {
+    if (!m_pDB)
+      return;
+    if (!m_pDS2)
+      return;
+
+    for (const std::string& ids : GetIdLists(items))
+    {
+      std::string sql = PrepareSQL("SELECT media_id, type, value FROM uniqueid WHERE media_id IN (%s) AND media_type = '%s'", ids.c_str(), mediaType.c_str());
+      m_pDS2->query(sql);
+      while (!m_pDS2->eof())
+      {
+        const auto it = items.find(m_pDS2->fv(0).get_asInt());
+        if (it != items.end())
+        {
+          for (CVideoInfoTag* details : it->second)
+            details->SetUniqueID(m_pDS2->fv(2).get_asString(), m_pDS2->fv(1).get_asString());
+        }
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, mediaType);
+  }
+}
+
+void CVideoDatabase::GetStreamDetailsForItems(const DetailsById& items)
+{
+  for (const auto& item : items)
+  {
+    for (CVideoInfoTag* details : item.second)
+      details->m_streamDetails.Reset();
+  }
+
+  try
+  {
+    if (!m_pDB)
+      return;
+    if (!m_pDS2)
+      return;
+
+    for (const std::string& ids : GetIdLists(items))
+    {
+      std::string sql = PrepareSQL("SELECT * FROM streamdetails WHERE idFile IN (%s)", ids.c_str());
+      m_pDS2->query(sql);
+      while (!m_pDS2->eof())
+      {
+        const auto it = items.find(m_pDS2->fv(0).get_asInt());
+        if (it != items.end())
+        {
+          for (CVideoInfoTag* details : it->second)
+            AddStreamDetail(*m_pDS2, details->m_streamDetails);
+        }
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} failed", __FUNCTION__);
+  }
+
+  for (const auto& item : items)
+  {
+    for (CVideoInfoTag* details : item.second)
+    {
+      details->m_streamDetails.DetermineBestStreams();
+      if (details->m_streamDetails.GetVideoDuration() > 0)
+        details->SetDuration(details->m_streamDetails.GetVideoDuration());
+    }
+  }
+}
+
 bool CVideoDatabase::GetVideoSettings(const CFileItem &item, CVideoSettings &settings)
 {
   return GetVideoSettings(GetFileId(item), settings);
@@ -4455,8 +4748,8 @@ bool CVideoDatabase::GetVideoSettings(int idFile, CVideoSettings &settings)
     if (nullptr == m_pDS)
       return false;
 
-    std::string strSQL=PrepareSQL("select * from settings where settings.idFile = '%i'", idFile);
-    m_pDS->query( strSQL );
+    m_pDS->query_bound("select * from settings where settings.idFile = ?",
+                       {dbiplus::field_value(idFile)});
 
     if (m_pDS->num_rows() > 0)
     { // get the video settings info
@@ -7708,33 +8001,40 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
       return false;
 
     // get data from returned rows
-    items.Reserve(results.size());
+    VECMOVIES movies;
+    movies.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+      CVideoInfoTag movie = GetDetailsForMovie(record);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(movie));
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path = std::to_string(movie.m_iDbId);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-        pItem->SetDynPath(movie.m_strFileNameAndPath);
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
-        items.Add(pItem);
-      }
+        movies.emplace_back(std::move(movie));
     }
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(movies, MediaTypeMovie, getDetails);
+
+    items.Reserve(movies.size());
+    for (const auto& movie : movies)
+    {
+      CFileItemPtr pItem(new CFileItem(movie));
+
+      CVideoDbUrl itemUrl = videoUrl;
+      std::string path = std::to_string(movie.m_iDbId);
+      itemUrl.AppendPath(path);
+      pItem->SetPath(itemUrl.ToString());
+      pItem->SetDynPath(movie.m_strFileNameAndPath);
+
+      pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+      items.Add(pItem);
+    }
     return true;
   }
   catch (...)
@@ -7942,45 +8242,48 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
       return false;
 
     // get data from returned rows
-    items.Reserve(results.size());
-    CLabelFormatter formatter("%H. %T", "");
-
+    std::vector<CVideoInfoTag> episodes;
+    episodes.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag episode = GetDetailsForEpisode(record, getDetails);
+      CVideoInfoTag episode = GetDetailsForEpisode(record);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(episode.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(episode));
-        formatter.FormatLabel(pItem.get());
-
-        int idEpisode = record->at(0).get_asInt();
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path;
-        if (appendFullShowPath && videoUrl.GetItemType() != "episodes")
-          path = StringUtils::Format("{}/{}/{}",
-                                     record->at(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt(),
-                                     episode.m_iSeason, idEpisode);
-        else
-          path = std::to_string(idEpisode);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-        pItem->SetDynPath(episode.m_strFileNameAndPath);
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, episode.GetPlayCount() > 0);
-        pItem->m_dateTime = episode.m_firstAired;
-        items.Add(pItem);
-      }
+        episodes.emplace_back(std::move(episode));
     }
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(episodes, MediaTypeEpisode, getDetails);
+
+    items.Reserve(episodes.size());
+    CLabelFormatter formatter("%H. %T", "");
+    for (const auto& episode : episodes)
+    {
+      CFileItemPtr pItem(new CFileItem(episode));
+      formatter.FormatLabel(pItem.get());
+
+      CVideoDbUrl itemUrl = videoUrl;
+      std::string path;
+      if (appendFullShowPath && videoUrl.GetItemType() != "episodes")
+        path = StringUtils::Format("{}/{}/{}", episode.m_iIdShow, episode.m_iSeason,
+                                   episode.m_iDbId);
+      else
+        path = std::to_string(episode.m_iDbId);
+      itemUrl.AppendPath(path);
+      pItem->SetPath(itemUrl.ToString());
+      pItem->SetDynPath(episode.m_strFileNameAndPath);
+
+      pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, episode.GetPlayCount() > 0);
+      pItem->m_dateTime = episode.m_firstAired;
+      items.Add(pItem);
+    }
     return true;
   }
   catch (...)
@@ -10823,8 +11126,63 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
   }
 }
 
+void CVideoDatabase::BeginTransaction()
+{
+  if (!m_inBatch)
+  {
+    CDatabase::BeginTransaction();
+    return;
+  }
+
+  // savepoint names are numbered, mysql replaces a savepoint of the same name
+  ExecuteQuery(PrepareSQL("SAVEPOINT item%i", ++m_batchSavepoints));
+}
+
+void CVideoDatabase::RollbackTransaction()
+{
+  if (!m_inBatch)
+  {
+    CDatabase::RollbackTransaction();
+    return;
+  }
+
+  if (m_batchSavepoints > 0)
+  {
+    ExecuteQuery(PrepareSQL("ROLLBACK TO SAVEPOINT item%i", m_batchSavepoints));
+    ExecuteQuery(PrepareSQL("RELEASE SAVEPOINT item%i", m_batchSavepoints--));
+  }
+}
+
+void CVideoDatabase::BeginBatch()
+{
+  if (m_inBatch)
+    return;
+
+  CDatabase::BeginTransaction();
+  m_inBatch = true;
+  m_batchSavepoints = 0;
+}
+
+bool CVideoDatabase::CommitBatch()
+{
+  if (!m_inBatch)
+    return true;
+
+  // the commit ends any savepoint left open
+  m_inBatch = false;
+  m_batchSavepoints = 0;
+  return CommitTransaction();
+}
+
 bool CVideoDatabase::CommitTransaction()
 {
+  if (m_inBatch)
+  {
+    if (m_batchSavepoints > 0)
+      return ExecuteQuery(PrepareSQL("RELEASE SAVEPOINT item%i", m_batchSavepoints--));
+    return true;
+  }
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
@@ -15,6 +15,7 @@
 #include "utils/SortUtils.h"
 #include "utils/UrlOptions.h"
 
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
@@ -425,7 +426,18 @@ public:
   ~CVideoDatabase(void) override;
 
   bool Open() override;
+  void BeginTransaction() override;
   bool CommitTransaction() override;
+  void RollbackTransaction() override;
+
+  /*! \brief Write several items in one transaction
+   The SetDetailsFor* functions commit every item on their own. Between BeginBatch and
+   CommitBatch their transactions become savepoints of one transaction instead, so an item
+   that fails is still rolled back on its own.
+   */
+  void BeginBatch();
+  bool CommitBatch();
+  bool InBatch() const { return m_inBatch; }
 
   int AddNewEpisode(int idShow, CVideoInfoTag& details);
 
@@ -1072,6 +1084,23 @@ protected:
   void GetTags(int media_id, const std::string &media_type, std::vector<std::string> &tags);
   void GetRatings(int media_id, const std::string &media_type, RatingMap &ratings);
   void GetUniqueIDs(int media_id, const std::string &media_type, CVideoInfoTag& details);
+  void GetShowLinks(int idMovie, std::vector<std::string>& showLink);
+
+  /*! \brief Fill in the details of a whole result set at once
+   Runs one query per detail table for all items instead of a few queries per item.
+   \param items the tags as read from the movie_view or episode_view
+   \param mediaType MediaTypeMovie or MediaTypeEpisode
+   \param getDetails VideoDbDetails* flags, as for GetDetailsForMovie()
+   */
+  void GetDetailsForItems(std::vector<CVideoInfoTag>& items,
+                          const std::string& mediaType,
+                          int getDetails);
+  typedef std::map<int, std::vector<CVideoInfoTag*>> DetailsById;
+  void GetCastForItems(const DetailsById& items, const std::string& mediaType);
+  void GetTagsForItems(const DetailsById& items, const std::string& mediaType);
+  void GetRatingsForItems(const DetailsById& items, const std::string& mediaType);
+  void GetUniqueIDsForItems(const DetailsById& items, const std::string& mediaType);
+  void GetStreamDetailsForItems(const DetailsById& items);
 
   void GetDetailsFromDB(std::unique_ptr<dbiplus::Dataset> &pDS, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
   void GetDetailsFromDB(const dbiplus::sql_record* const record, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
@@ -1151,4 +1180,7 @@ private:
   static void AnnounceUpdate(const std::string& content, int id);
 
   static CDateTime GetDateAdded(const std::string& filename, CDateTime dateAdded = CDateTime());
+
+  bool m_inBatch = false;
+  int m_batchSavepoints = 0; //!< nested transactions open in the batch
 };
@@ -24,6 +24,7 @@
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryJournal.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
@@ -44,9 +45,11 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
+#include "video/VideoScanPrefetcher.h"
 #include "video/VideoThumbLoader.h"
 
 #include <algorithm>
+#include <chrono>
 #include <utility>
 
 using namespace XFILE;
@@ -58,6 +61,33 @@ using KODI::UTILITY::CDigest;
 
 namespace VIDEO
 {
+  // items of a folder written in one transaction at most, and for how long it stays open
+  constexpr unsigned int BATCH_ITEMS = 100;
+  constexpr auto BATCH_TIME = std::chrono::seconds(1);
+
+  //! Counts an item of a stage of the scan and the time it took
+  class CScanStageTimer
+  {
+  public:
+    explicit CScanStageTimer(SScanStage& stage)
+      : m_stage(&stage), m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~CScanStageTimer() { Stop(); }
+
+    void Stop()
+    {
+      if (!m_stage)
+        return;
+      m_stage->count++;
+      m_stage->time += std::chrono::steady_clock::now() - m_start;
+      m_stage = nullptr;
+    }
+
+  private:
+    SScanStage* m_stage;
+    const std::chrono::steady_clock::time_point m_start;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
@@ -98,6 +128,9 @@ namespace VIDEO
       }
 
       auto start = std::chrono::steady_clock::now();
+      m_scanStart = start;
+      m_scrapeStage = {};
+      m_writeStage = {};
 
       m_database.Open();
 
@@ -112,6 +145,17 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      m_useDirectoryJournal = CServiceBroker::GetSettingsComponent()
+                                  ->GetAdvancedSettings()
+                                  ->m_videoLibraryUseDirectoryWatcher;
+      if (m_useDirectoryJournal)
+      { // changes below the paths are seen from now on, local folders only
+        for (const std::string& directory : m_pathsToScan)
+          CDirectoryJournal::GetInstance().Watch(directory);
+      }
+
+      StartPrefetch();
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -136,11 +180,16 @@ namespace VIDEO
           CLog::Log(LOGWARNING, "{} directory '{}' does not exist - skipping scan{}.", __FUNCTION__,
                     CURL::GetRedacted(directory), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
+          if (m_prefetcher)
+            m_prefetcher->Take(directory);
         }
         else if (!DoScan(directory))
           bCancelled = true;
       }
 
+      CommitWrites(true);
+      StopPrefetch();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -161,12 +210,20 @@ namespace VIDEO
 
       CLog::Log(LOGINFO, "VideoInfoScanner: Finished scan. Scanning for video info took {} ms",
                 duration.count());
+      CLog::Log(LOGINFO,
+                "VideoInfoScanner: {} scraper lookups took {} ms, {} items were written in {} ms",
+                m_scrapeStage.count,
+                std::chrono::duration_cast<std::chrono::milliseconds>(m_scrapeStage.time).count(),
+                m_writeStage.count,
+                std::chrono::duration_cast<std::chrono::milliseconds>(m_writeStage.time).count());
     }
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      CommitWrites(true);
     }
 
+    StopPrefetch();
     m_bRunning = false;
     CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
                                                        "OnScanFinished");
@@ -230,11 +287,6 @@ namespace VIDEO
 
   bool CVideoInfoScanner::DoScan(const std::string& strDirectory)
   {
-    if (m_handle)
-    {
-      m_handle->SetText(g_localizeStrings.Get(20415));
-    }
-
     /*
      * Remove this path from the list we're processing. This must be done prior to
      * the check for file or folder exclusion to prevent an infinite while loop
@@ -244,13 +296,61 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    // no transaction is kept open while a remote folder is read
+    if (URIUtils::IsRemote(strDirectory) || URIUtils::IsPlugin(strDirectory))
+      CommitWrites(true);
+
+    // taken in any case, a result left behind would hold up the prefetch threads
+    std::unique_ptr<CVideoScanPrefetcher::CResult> prefetched;
+    if (m_prefetcher)
+      prefetched = m_prefetcher->Take(strDirectory);
+
+    // a prefetched folder was looked at before the scanner got here
+    const uint64_t journalPosition =
+        prefetched ? m_prefetchPosition : CDirectoryJournal::GetInstance().GetPosition();
+    std::string journalHash;
+
+    if (m_handle)
+    {
+      std::string text;
+      if (m_prefetcher)
+      {
+        const CVideoScanPrefetcher::CStats stats = m_prefetcher->GetStats();
+        const unsigned int checked = stats.taken + stats.missed;
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(stats.elapsed).count();
+        text = StringUtils::Format(g_localizeStrings.Get(20315), checked, stats.queued,
+                                   seconds > 0 ? checked / seconds : checked,
+                                   stats.prefetched - stats.taken);
+      }
+      else
+        text = g_localizeStrings.Get(20415);
+
+      // throughput of the scraper lookups and the writes over the whole scan
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_scanStart;
+      if (elapsed.count() >= 1.0)
+        text = StringUtils::Format(g_localizeStrings.Get(20312), text,
+                                   m_scrapeStage.count / elapsed.count(),
+                                   m_writeStage.count / elapsed.count());
+      m_handle->SetText(text);
+    }
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
     bool bSkip = false;
 
     SScanSettings settings;
-    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
+    ScraperPtr info;
+    auto scanPath = m_scanPaths.find(strDirectory);
+    if (scanPath != m_scanPaths.end())
+    {
+      info = scanPath->second.info;
+      settings = scanPath->second.settings;
+      foundDirectly = scanPath->second.foundDirectly;
+      m_scanPaths.erase(scanPath);
+    }
+    else
+      info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
     CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
 
     // exclude folders that match our exclude regexps
@@ -285,25 +385,34 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name()));
       }
 
+      const bool unchanged = m_useDirectoryJournal && m_database.GetPathHash(strDirectory, dbHash) &&
+                             CDirectoryJournal::GetInstance().IsUnchanged(strDirectory, dbHash);
+
       std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      if (!unchanged)
+      {
+        if (prefetched)
+          fastHash = prefetched->fastHash;
+        else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
+          fastHash = GetFastHash(strDirectory, regexps);
+      }
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+      if (unchanged)
+      { // nothing below the folder changed since it was scanned
+        hash = dbHash;
+      }
+      else if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
+      else if (prefetched && prefetched->listed)
+      { // listed ahead
+        items.Assign(*prefetched->items);
+        hash = prefetched->hash;
+      }
       else
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        // do not consider inner folders with .nomedia
-        items.erase(std::remove_if(items.begin(), items.end(),
-                                   [this](const CFileItemPtr& item) {
-                                     return item->m_bIsFolder && HasNoMedia(item->GetPath());
-                                   }),
-                    items.end());
-        items.Stack();
+        GetMovieFolderListing(strDirectory, items);
 
         // check whether to re-use previously computed fast hash
         if (!CanFastHash(items, regexps) || fastHash.empty())
@@ -315,7 +424,9 @@ namespace VIDEO
       if (StringUtils::EqualsNoCase(hash, dbHash))
       { // hash matches - skipping
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '{}' due to no change{}",
-                  CURL::GetRedacted(strDirectory), !fastHash.empty() ? " (fasthash)" : "");
+                  CURL::GetRedacted(strDirectory),
+                  unchanged ? " (watched)" : !fastHash.empty() ? " (fasthash)" : "");
+        journalHash = dbHash;
         bSkip = true;
       }
       else if (hash.empty())
@@ -346,10 +457,18 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
+        if (prefetched && prefetched->listed)
+        {
+          items.Assign(*prefetched->items);
+          hash = prefetched->hash;
+        }
+        else
+        {
+          CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                                   DIR_FLAG_DEFAULTS);
+          items.SetPath(strDirectory);
+          GetPathHash(items, hash);
+        }
         bSkip = true;
         if (!m_database.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
           bSkip = false;
@@ -373,6 +492,7 @@ namespace VIDEO
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
           m_database.SetPathHash(strDirectory, hash);
+          journalHash = hash;
           if (m_bClean)
             m_pathsToClean.insert(m_database.GetPathId(strDirectory));
           CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir {}",
@@ -390,8 +510,12 @@ namespace VIDEO
     else if (!StringUtils::EqualsNoCase(hash, dbHash) && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
     { // update the hash either way - we may have changed the hash to a fast version
       m_database.SetPathHash(strDirectory, hash);
+      journalHash = hash;
     }
 
+    // the folder is written, other connections may write before the next one is read
+    CommitWrites(true);
+
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
@@ -412,6 +536,10 @@ namespace VIDEO
         }
       }
     }
+
+    // the folders below were scanned too, the next scan can skip them all
+    if (m_useDirectoryJournal && !m_bStop && !journalHash.empty())
+      CDirectoryJournal::GetInstance().MarkScanned(strDirectory, journalHash, journalPosition);
     return !m_bStop;
   }
 
@@ -837,6 +965,8 @@ namespace VIDEO
       {
         if (!item->IsPlugin() || scraper->ID() != "metadata.local")
         {
+          CommitWrites(true);
+          CScanStageTimer scrape(m_scrapeStage);
           CVideoInfoDownloader loader(scraper);
           loader.GetArtwork(showInfo);
         }
@@ -869,6 +999,7 @@ namespace VIDEO
       if (it != m_pathsToScan.end())
         m_pathsToScan.erase(it);
 
+      const uint64_t journalPosition = CDirectoryJournal::GetInstance().GetPosition();
       std::string hash, dbHash;
       bool allowEmptyHash = false;
       if (item->IsPlugin())
@@ -881,6 +1012,9 @@ namespace VIDEO
           allowEmptyHash = true;
         }
       }
+      else if (m_useDirectoryJournal && m_database.GetPathHash(item->GetPath(), dbHash) &&
+               CDirectoryJournal::GetInstance().IsUnchanged(item->GetPath(), dbHash))
+        hash = dbHash; // nothing below the show folder changed since it was scanned
       else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash)
         hash = GetRecursiveFastHash(item->GetPath(), regexps);
 
@@ -915,6 +1049,8 @@ namespace VIDEO
       {
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '{}' due to no change",
                   CURL::GetRedacted(item->GetPath()));
+        if (m_useDirectoryJournal)
+          CDirectoryJournal::GetInstance().MarkScanned(item->GetPath(), dbHash, journalPosition);
         // update our dialog with our progress
         if (m_handle)
           OnDirectoryScanned(item->GetPath());
@@ -1344,6 +1480,9 @@ namespace VIDEO
     if (!m_database.Open())
       return -1;
 
+    // an expired transaction is not kept open while the art and stream details are read
+    CommitWrites(false);
+
     if (!libraryImport)
       GetArtwork(pItem, content, videoFolder, useLocal && !pItem->IsPlugin(), showInfo ? showInfo->m_strPath : "");
 
@@ -1352,6 +1491,15 @@ namespace VIDEO
     if (art.empty())
       art["thumb"] = "";
 
+    if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
+            CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS) &&
+        CDVDFileInfo::GetFileStreamDetails(pItem))
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: Extracted filestream details from video file {}",
+                CURL::GetRedacted(pItem->GetPath()));
+
+    BeginWrites(*pItem);
+    CScanStageTimer write(m_writeStage);
+
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
     if (movieDetails.m_basePath.empty())
       movieDetails.m_basePath = pItem->GetBaseMoviePath(videoFolder);
@@ -1370,12 +1518,6 @@ namespace VIDEO
                                      movieDetails.m_iSeason, movieDetails.m_iEpisode, strTitle);
     }
 
-    if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
-            CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS) &&
-        CDVDFileInfo::GetFileStreamDetails(pItem))
-      CLog::Log(LOGDEBUG, "VideoInfoScanner: Extracted filestream details from video file {}",
-                CURL::GetRedacted(pItem->GetPath()));
-
     CLog::Log(LOGDEBUG, "VideoInfoScanner: Adding new item to {}:{}", TranslateContent(content), CURL::GetRedacted(pItem->GetPath()));
     long lResult = -1;
 
@@ -1462,6 +1604,8 @@ namespace VIDEO
         m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.GetResumePoint(), CBookmark::RESUME);
     }
 
+    CommitWrites(false);
+    write.Stop();
     m_database.Close();
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
@@ -1792,6 +1936,8 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          CommitWrites(true);
+          CScanStageTimer scrape(m_scrapeStage);
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1908,11 +2054,14 @@ namespace VIDEO
 
       if (bFound)
       {
+        CommitWrites(true);
+        CScanStageTimer scrape(m_scrapeStage);
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
         if (!imdb.GetEpisodeDetails(guide->cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress))
           return INFO_NOT_FOUND; //! @todo should we just skip to the next episode?
+        scrape.Stop();
 
         // Only set season/epnum from filename when it is not already set by a scraper
         if (item.GetVideoInfoTag()->m_iSeason == -1)
@@ -1945,8 +2094,11 @@ namespace VIDEO
     if (m_handle && !url.GetTitle().empty())
       m_handle->SetText(url.GetTitle());
 
+    CommitWrites(true);
+    CScanStageTimer scrape(m_scrapeStage);
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
+    scrape.Stop();
 
     if (ret)
     {
@@ -2026,6 +2178,135 @@ namespace VIDEO
     return true;
   }
 
+  void CVideoInfoScanner::GetMovieFolderListing(const std::string& directory,
+                                                CFileItemList& items) const
+  {
+    CDirectory::GetDirectory(directory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                             DIR_FLAG_DEFAULTS);
+    // do not consider inner folders with .nomedia
+    items.erase(std::remove_if(items.begin(), items.end(),
+                               [this](const CFileItemPtr& item) {
+                                 return item->m_bIsFolder && HasNoMedia(item->GetPath());
+                               }),
+                items.end());
+    items.Stack();
+  }
+
+  void CVideoInfoScanner::StartPrefetch()
+  {
+    const std::shared_ptr<CAdvancedSettings> advancedSettings =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    if (advancedSettings->m_videoLibraryScanThreads <= 0 || m_pathsToScan.size() < 2)
+      return;
+
+    // results kept for the scanner, the listings of a few dozen folders
+    constexpr unsigned int MAX_AHEAD = 64;
+    m_prefetchPosition = CDirectoryJournal::GetInstance().GetPosition();
+    m_prefetcher = std::make_unique<CVideoScanPrefetcher>(
+        advancedSettings->m_videoLibraryScanThreads, MAX_AHEAD);
+
+    const bool useFastHash = advancedSettings->m_bVideoLibraryUseFastHash;
+    for (const std::string& directory : m_pathsToScan)
+    {
+      SScanPath& scanPath = m_scanPaths[directory];
+      scanPath.info = m_database.GetScraperForPath(directory, scanPath.settings, scanPath.foundDirectly);
+
+      // the same folders DoScan() skips before it lists anything
+      const CONTENT_TYPE content = scanPath.info ? scanPath.info->Content() : CONTENT_NONE;
+      if (content == CONTENT_NONE || (!m_scanAll && scanPath.settings.noupdate) ||
+          URIUtils::IsPlugin(directory))
+        continue;
+
+      const std::vector<std::string>& regexps = content == CONTENT_TVSHOWS
+                                                    ? advancedSettings->m_tvshowExcludeFromScanRegExps
+                                                    : advancedSettings->m_moviesExcludeFromScanRegExps;
+      if (CUtil::ExcludeFileOrFolder(directory, regexps))
+        continue;
+
+      if (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS)
+      {
+        std::string dbHash;
+        m_database.GetPathHash(directory, dbHash);
+        if (m_useDirectoryJournal && CDirectoryJournal::GetInstance().IsUnchanged(directory, dbHash))
+          continue;
+        m_prefetcher->Add(directory, [this, directory, regexps, dbHash,
+                                      useFastHash](CVideoScanPrefetcher::CResult& result) {
+          if (useFastHash)
+            result.fastHash = GetFastHash(directory, regexps);
+          if (!result.fastHash.empty() && StringUtils::EqualsNoCase(result.fastHash, dbHash))
+            return;
+
+          result.items = std::make_unique<CFileItemList>();
+          GetMovieFolderListing(directory, *result.items);
+          if (!CanFastHash(*result.items, regexps) || result.fastHash.empty())
+            GetPathHash(*result.items, result.hash);
+          else
+            result.hash = result.fastHash;
+          result.listed = true;
+        });
+      }
+      else if (content == CONTENT_TVSHOWS && scanPath.foundDirectly &&
+               !scanPath.settings.parent_name_root)
+      {
+        m_prefetcher->Add(directory, [directory](CVideoScanPrefetcher::CResult& result) {
+          result.items = std::make_unique<CFileItemList>();
+          CDirectory::GetDirectory(directory, *result.items,
+                                   CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                                   DIR_FLAG_DEFAULTS);
+          result.items->SetPath(directory);
+          GetPathHash(*result.items, result.hash);
+          result.listed = true;
+        });
+      }
+    }
+  }
+
+  void CVideoInfoScanner::BeginWrites(const CFileItem& item)
+  {
+    // the info of items in remote folders and plugins is read between their writes
+    if (!m_bRunning || item.IsPlugin() || URIUtils::IsRemote(item.GetPath()))
+    {
+      CommitWrites(true);
+      return;
+    }
+
+    if (!m_database.InBatch())
+    {
+      m_database.BeginBatch();
+      m_batchStart = std::chrono::steady_clock::now();
+    }
+    m_batchItems++;
+  }
+
+  void CVideoInfoScanner::CommitWrites(bool force)
+  {
+    if (!m_database.InBatch())
+      return;
+
+    if (force || m_batchItems >= BATCH_ITEMS ||
+        std::chrono::steady_clock::now() - m_batchStart >= BATCH_TIME)
+    {
+      m_database.CommitBatch();
+      m_batchItems = 0;
+    }
+  }
+
+  void CVideoInfoScanner::StopPrefetch()
+  {
+    if (m_prefetcher)
+    {
+      m_prefetcher->Stop();
+
+      const CVideoScanPrefetcher::CStats stats = m_prefetcher->GetStats();
+      CLog::Log(LOGINFO,
+                "VideoInfoScanner: {} of {} folders listed ahead, {} used, {} listed by the "
+                "scanner itself",
+                stats.prefetched, stats.queued, stats.taken, stats.missed);
+      m_prefetcher.reset();
+    }
+    m_scanPaths.clear();
+  }
+
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
@@ -2227,8 +2508,11 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &title, int year, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    CommitWrites(true);
+    CScanStageTimer scrape(m_scrapeStage);
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(title, year, movielist, progress);
+    scrape.Stop();
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
     { // scraper reported an error, or we had an error and user wants to cancel the scan
       m_bStop = true;
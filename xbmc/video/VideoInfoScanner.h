@@ -13,7 +13,11 @@
 #include "addons/Scraper.h"
 #include "guilib/GUIListItem.h"
 
+#include <chrono>
+#include <map>
+#include <memory>
 #include <set>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -24,6 +28,7 @@ class CFileItemList;
 namespace VIDEO
 {
   class IVideoInfoTagLoader;
+  class CVideoScanPrefetcher;
 
   typedef struct SScanSettings
   {
@@ -44,6 +49,13 @@ namespace VIDEO
     bool m_allExtAudio; /* treat all audio files in video directory as external tracks */
   } SScanSettings;
 
+  //! Work done by one stage of a scan
+  struct SScanStage
+  {
+    unsigned int count = 0;
+    std::chrono::steady_clock::duration time{};
+  };
+
   class CVideoInfoScanner : public CInfoScanner
   {
   public:
@@ -220,6 +232,26 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    /*! \brief List a movie or music video folder for scanning
+     Stacks the items and leaves out subfolders that contain a .nomedia file.
+     */
+    void GetMovieFolderListing(const std::string& directory, CFileItemList& items) const;
+
+    /*! \brief List and hash the folders to scan on prefetch threads
+     Looks up the scraper of each folder to decide what to fetch, DoScan() takes
+     these lookups and the results.
+     */
+    void StartPrefetch();
+    void StopPrefetch();
+
+    /*! \brief Write the items of a local folder in one transaction
+     It is committed once the folder is written, after a second or 100 items at most, and
+     before a scraper is asked or a remote folder is read, so it is never kept open while
+     waiting for the network and other connections do not wait long for their writes.
+     */
+    void BeginWrites(const CFileItem& item);
+    void CommitWrites(bool force);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -243,6 +275,23 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
 
+    struct SScanPath
+    {
+      ADDON::ScraperPtr info;
+      SScanSettings settings;
+      bool foundDirectly = false;
+    };
+    std::map<std::string, SScanPath> m_scanPaths; //!< scraper lookups made by StartPrefetch()
+    std::unique_ptr<CVideoScanPrefetcher> m_prefetcher;
+    uint64_t m_prefetchPosition = 0; //!< directory journal position when prefetching started
+    bool m_useDirectoryJournal = false;
+
+    std::chrono::steady_clock::time_point m_scanStart; //!< the rates of the stages are shown over it
+    SScanStage m_scrapeStage; //!< scraper lookups and the time spent waiting on them
+    SScanStage m_writeStage; //!< items written and the time spent writing them
+    unsigned int m_batchItems = 0; //!< items written in the open transaction
+    std::chrono::steady_clock::time_point m_batchStart;
+
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
       const std::vector<std::string>& wantedArtTypes, const std::string& itemPath,
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoScanPrefetcher.h"
+
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace VIDEO;
+
+CVideoScanPrefetcher::CResult::CResult() = default;
+
+CVideoScanPrefetcher::CResult::~CResult() = default;
+
+CVideoScanPrefetcher::CVideoScanPrefetcher(unsigned int threads, unsigned int maxAhead)
+  : m_maxAhead(std::max(maxAhead, 1u))
+{
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    m_threads.emplace_back(
+        std::make_unique<CThread>(static_cast<IRunnable*>(this), "VideoScanPrefetch"));
+    m_threads.back()->Create();
+  }
+}
+
+CVideoScanPrefetcher::~CVideoScanPrefetcher()
+{
+  Stop();
+}
+
+void CVideoScanPrefetcher::Add(const std::string& directory, Task task)
+{
+  {
+    std::unique_lock<CCriticalSection> lock(m_section);
+    if (m_stop || m_entries.find(directory) != m_entries.end())
+      return;
+
+    if (!m_stats.queued)
+      m_start = std::chrono::steady_clock::now();
+    m_stats.queued++;
+
+    m_entries[directory].task = std::move(task);
+    m_queue.push_back(directory);
+  }
+  m_workCondition.notify();
+}
+
+std::unique_ptr<CVideoScanPrefetcher::CResult> CVideoScanPrefetcher::Take(
+    const std::string& directory)
+{
+  std::unique_ptr<CResult> result;
+  {
+    std::unique_lock<CCriticalSection> lock(m_section);
+
+    auto it = m_entries.find(directory);
+    if (it == m_entries.end())
+      return {};
+
+    if (it->second.state == State::QUEUED)
+    {
+      // quicker to do it right away than to wait for a thread, the thread skips it
+      m_entries.erase(it);
+      m_stats.missed++;
+      return {};
+    }
+
+    // a running task always finishes, even after Stop
+    m_doneCondition.wait(m_section, [it]() { return it->second.state == State::DONE; });
+
+    result = std::move(it->second.result);
+    m_entries.erase(it);
+    m_ahead--;
+    m_stats.taken++;
+  }
+  m_workCondition.notify();
+  return result;
+}
+
+void CVideoScanPrefetcher::Stop()
+{
+  {
+    std::unique_lock<CCriticalSection> lock(m_section);
+    m_stop = true;
+    m_queue.clear();
+  }
+  m_workCondition.notifyAll();
+
+  for (auto& thread : m_threads)
+    thread->StopThread(true);
+  m_threads.clear();
+
+  std::unique_lock<CCriticalSection> lock(m_section);
+  m_entries.clear();
+  m_ahead = 0;
+}
+
+CVideoScanPrefetcher::CStats CVideoScanPrefetcher::GetStats() const
+{
+  std::unique_lock<CCriticalSection> lock(m_section);
+
+  CStats stats = m_stats;
+  if (stats.queued)
+    stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_start);
+  return stats;
+}
+
+void CVideoScanPrefetcher::Run()
+{
+  while (true)
+  {
+    std::string directory;
+    Task task;
+    {
+      std::unique_lock<CCriticalSection> lock(m_section);
+      m_workCondition.wait(m_section, [this]() {
+        return m_stop || (!m_queue.empty() && m_ahead < m_maxAhead);
+      });
+      if (m_stop)
+        return;
+
+      directory = std::move(m_queue.front());
+      m_queue.pop_front();
+
+      // the scanner got there first
+      auto it = m_entries.find(directory);
+      if (it == m_entries.end() || it->second.state != State::QUEUED)
+        continue;
+
+      it->second.state = State::RUNNING;
+      task = std::move(it->second.task);
+      m_ahead++;
+    }
+
+    auto result = std::make_unique<CResult>();
+    try
+    {
+      task(*result);
+    }
+    catch (...)
+    {
+      // the scanner does it again
+      CLog::Log(LOGERROR, "CVideoScanPrefetcher: failed to prefetch {}", CURL::GetRedacted(directory));
+      result = std::make_unique<CResult>();
+    }
+
+    {
+      std::unique_lock<CCriticalSection> lock(m_section);
+
+      // only Take removes a running entry and it waits for it
+      auto it = m_entries.find(directory);
+      if (it != m_entries.end())
+      {
+        it->second.result = std::move(result);
+        it->second.state = State::DONE;
+        m_stats.prefetched++;
+      }
+    }
+    m_doneCondition.notifyAll();
+  }
+}
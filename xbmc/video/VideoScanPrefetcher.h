@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CFileItemList;
+class CThread;
+
+namespace VIDEO
+{
+/*!
+ \brief Lists and hashes the folders of a library scan ahead of the scanner
+
+ The scanner walks the folders one by one, and on network shares most of
+ that time is spent waiting for directory listings and stat calls. The
+ prefetcher does that part on a few threads for the folders the scanner is
+ going to visit, the scanner takes the results in whatever order it visits
+ the folders. Scraping and database access stay on the scanner thread.
+
+ A folder the scanner asks for before a thread got to it is dropped from
+ the queue, the scanner does the work itself. It only waits for folders a
+ thread is working on, which is why the queue can't stall the scan.
+ */
+class CVideoScanPrefetcher : private IRunnable
+{
+public:
+  struct CResult
+  {
+    CResult();
+    ~CResult();
+
+    std::string fastHash; //!< hash of the folder's modification time, empty if none
+    bool listed = false; //!< the folder was listed, items and hash are valid
+    std::unique_ptr<CFileItemList> items;
+    std::string hash; //!< hash of the listing
+  };
+
+  //! lists or hashes one folder, runs on a prefetch thread
+  using Task = std::function<void(CResult& result)>;
+
+  struct CStats
+  {
+    unsigned int queued = 0; //!< folders added
+    unsigned int prefetched = 0; //!< folders done by a prefetch thread
+    unsigned int taken = 0; //!< prefetched folders the scanner used
+    unsigned int missed = 0; //!< folders the scanner asked for before a thread got to them
+    std::chrono::milliseconds elapsed{0}; //!< since the first folder was added
+  };
+
+  /*!
+   \param threads number of prefetch threads
+   \param maxAhead results kept for the scanner before the threads pause
+   */
+  CVideoScanPrefetcher(unsigned int threads, unsigned int maxAhead);
+  ~CVideoScanPrefetcher() override;
+
+  //! queue a folder, folders are picked up in the order they were added
+  void Add(const std::string& directory, Task task);
+
+  /*!
+   \brief Take the result for a folder
+   \return nullptr if the folder was not queued or no thread got to it yet, the
+   caller has to do the work itself. Waits if a thread is working on it.
+   */
+  std::unique_ptr<CResult> Take(const std::string& directory);
+
+  //! drop everything queued and wait for the threads to finish the folders in progress
+  void Stop();
+
+  CStats GetStats() const;
+
+private:
+  void Run() override;
+
+  enum class State
+  {
+    QUEUED,
+    RUNNING,
+    DONE,
+  };
+
+  struct CEntry
+  {
+    State state = State::QUEUED;
+    Task task;
+    std::unique_ptr<CResult> result;
+  };
+
+  const unsigned int m_maxAhead;
+  std::vector<std::unique_ptr<CThread>> m_threads;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_workCondition;
+  XbmcThreads::ConditionVariable m_doneCondition;
+  std::map<std::string, CEntry> m_entries;
+  std::deque<std::string> m_queue;
+  unsigned int m_ahead = 0; //!< results waiting for the scanner
+  bool m_stop = false;
+
+  CStats m_stats;
+  std::chrono::steady_clock::time_point m_start;
+};
+} // namespace VIDEO
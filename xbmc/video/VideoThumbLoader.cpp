@@ -14,9 +14,11 @@
 #include "TextureCache.h"
 #include "URL.h"
 #include "cores/VideoPlayer/DVDFileInfo.h"
+#include "cores/VideoPlayer/DVDThumbnailer.h"
 #include "cores/VideoSettings.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/File.h"
 #include "filesystem/StackDirectory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
@@ -36,6 +38,7 @@
 #include "video/tags/VideoInfoTagLoaderFactory.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <utility>
 
@@ -179,8 +182,74 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
-CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CThumbBatchExtractor::CThumbBatchExtractor(const CFileItem& item, std::vector<Thumb> thumbs)
+  : m_item(item), m_thumbs(std::move(thumbs))
+{
+  if (m_item.IsStack())
+    m_item.SetPath(CStackDirectory::GetFirstStackedFile(m_item.GetPath()));
+}
+
+CThumbBatchExtractor::~CThumbBatchExtractor() = default;
+
+bool CThumbBatchExtractor::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) == 0)
+  {
+    const CThumbBatchExtractor* jobExtract = dynamic_cast<const CThumbBatchExtractor*>(job);
+    if (jobExtract && jobExtract->m_item.GetPath() == m_item.GetPath() &&
+        jobExtract->m_thumbs.size() == m_thumbs.size() &&
+        std::equal(m_thumbs.begin(), m_thumbs.end(), jobExtract->m_thumbs.begin(),
+                   [](const Thumb& a, const Thumb& b) { return a.target == b.target; }))
+      return true;
+  }
+  return false;
+}
+
+bool CThumbBatchExtractor::DoWork()
+{
+  CLog::Log(LOGDEBUG, "{} - trying to extract {} thumbs from video file {}", __FUNCTION__,
+            m_thumbs.size(), CURL::GetRedacted(m_item.GetPath()));
+
+  const auto start = std::chrono::steady_clock::now();
+  CDVDThumbnailer thumbnailer;
+  const bool opened = thumbnailer.Open(m_item, nullptr);
+
+  unsigned int extracted = 0;
+  for (unsigned int i = 0; i < m_thumbs.size(); i++)
+  {
+    CTextureDetails details;
+    details.file = CTextureCache::GetCacheFile(m_thumbs[i].target) + ".jpg";
+    if (opened && thumbnailer.ExtractThumb(m_thumbs[i].pos, details))
+    {
+      CServiceBroker::GetTextureCache()->AddCachedTexture(m_thumbs[i].target, details);
+      extracted++;
+    }
+    else
+    {
+      // same as CDVDFileInfo::ExtractThumb, don't try again
+      CFile file;
+      if (file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
+        file.Close();
+    }
+
+    if (ShouldCancel(i + 1, m_thumbs.size()))
+      break;
+  }
+
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  CLog::Log(LOGDEBUG, "{} - measured {} ms to extract {} thumbs from file <{}> in {} packets",
+            __FUNCTION__, duration.count(), extracted, CURL::GetRedacted(m_item.GetPath()),
+            thumbnailer.GetPacketsTried());
+
+  return extracted > 0;
+}
+
+CVideoThumbLoader::CVideoThumbLoader()
+  : CThumbLoader(),
+    CJobQueue(true,
+              CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoExtractThumbJobs,
+              CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
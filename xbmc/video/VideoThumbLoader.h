@@ -56,6 +56,44 @@ public:
   bool m_fillStreamDetails; ///< fill in stream details?
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Extracts thumbs at several positions of one video file
+
+ The file is opened and its decoder set up once for all positions. Progress is
+ reported after every thumb, so that callers can show them as they come in.
+
+ \sa CThumbExtractor and CJob
+ */
+class CThumbBatchExtractor : public CJob
+{
+public:
+  struct Thumb
+  {
+    std::string target; ///< thumbpath
+    int64_t pos; ///< position to extract the thumb from, in ms
+  };
+
+  CThumbBatchExtractor(const CFileItem& item, std::vector<Thumb> thumbs);
+  ~CThumbBatchExtractor() override;
+
+  /*!
+   \brief Work function that extracts the thumbs, in order
+   \return true if at least one thumb was extracted
+   */
+  bool DoWork() override;
+
+  const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+  bool operator==(const CJob* job) const override;
+
+  CFileItem m_item;
+  std::vector<Thumb> m_thumbs;
+};
+
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
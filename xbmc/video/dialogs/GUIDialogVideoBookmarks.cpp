@@ -269,6 +269,8 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
   // add chapters if around
   const auto& components = CServiceBroker::GetAppComponents();
   const auto appPlayer = components.GetComponent<CApplicationPlayer>();
+  std::vector<CThumbBatchExtractor::Thumb> chapterThumbs;
+  std::vector<unsigned int> chapters;
   for (int i = 1; i <= appPlayer->GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -292,10 +294,8 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
+      chapterThumbs.push_back({chapterPath, pos * 1000});
+      chapters.push_back(i);
       m_jobsStarted++;
     }
 
@@ -305,6 +305,14 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  // one job for all chapters, the file is only opened once
+  if (!chapterThumbs.empty())
+  {
+    CJob* job = new CThumbBatchExtractor(CFileItem(m_filePath, false), std::move(chapterThumbs));
+    if (AddJob(job))
+      m_mapJobsChapter[job] = std::move(chapters);
+  }
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -572,19 +580,33 @@ bool CGUIDialogVideoBookmarks::OnAddEpisodeBookmark()
   return bReturn;
 }
 
+void CGUIDialogVideoBookmarks::OnJobProgress(unsigned int jobID,
+                                             unsigned int progress,
+                                             unsigned int total,
+                                             const CJob* job)
+{
+  if (progress == 0 || !IsActive())
+    return;
+
+  unsigned int chapterIdx = 0;
+  {
+    std::unique_lock<CCriticalSection> lock(m_refreshSection);
+    MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
+    if (iter == m_mapJobsChapter.end() || progress > iter->second.size())
+      return;
+    chapterIdx = iter->second[progress - 1];
+  }
+
+  CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+  CServiceBroker::GetAppMessenger()->SendGUIMessage(m);
+}
+
 void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
                                              bool success, CJob* job)
 {
-  if (success && IsActive())
   {
-    MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
-    if (iter != m_mapJobsChapter.end())
-    {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
-      CServiceBroker::GetAppMessenger()->SendGUIMessage(m);
-      m_mapJobsChapter.erase(iter);
-    }
+    std::unique_lock<CCriticalSection> lock(m_refreshSection);
+    m_mapJobsChapter.erase(job);
   }
   CJobQueue::OnJobComplete(jobID, success, job);
 }
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2023 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "video/VideoScanPrefetcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace VIDEO;
+using namespace std::chrono_literals;
+
+namespace
+{
+CVideoScanPrefetcher::Task HashTask(const std::string& hash,
+                                    std::atomic<int>* runs = nullptr,
+                                    std::chrono::milliseconds duration = 0ms)
+{
+  return [hash, runs, duration](CVideoScanPrefetcher::CResult& result) {
+    if (runs)
+      (*runs)++;
+    std::this_thread::sleep_for(duration);
+    result.hash = hash;
+    result.listed = true;
+  };
+}
+
+bool WaitForPrefetched(const CVideoScanPrefetcher& prefetcher, unsigned int count)
+{
+  for (int i = 0; i < 500; i++)
+  {
+    if (prefetcher.GetStats().prefetched >= count)
+      return true;
+    std::this_thread::sleep_for(10ms);
+  }
+  return false;
+}
+} // namespace
+
+TEST(TestVideoScanPrefetcher, TakeInAnyOrder)
+{
+  CVideoScanPrefetcher prefetcher(3, 16);
+  prefetcher.Add("/movies/a/", HashTask("a"));
+  prefetcher.Add("/movies/b/", HashTask("b", nullptr, 50ms));
+  prefetcher.Add("/movies/c/", HashTask("c"));
+
+  // waits for the folder a thread works on
+  ASSERT_TRUE(WaitForPrefetched(prefetcher, 1));
+  auto result = prefetcher.Take("/movies/b/");
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(result->listed);
+  EXPECT_EQ(result->hash, "b");
+
+  ASSERT_TRUE(WaitForPrefetched(prefetcher, 3));
+  result = prefetcher.Take("/movies/a/");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result->hash, "a");
+  EXPECT_EQ(prefetcher.Take("/movies/c/")->hash, "c");
+
+  // a result is only handed out once
+  EXPECT_FALSE(prefetcher.Take("/movies/a/"));
+  EXPECT_FALSE(prefetcher.Take("/movies/unknown/"));
+
+  const CVideoScanPrefetcher::CStats stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.queued, 3u);
+  EXPECT_EQ(stats.prefetched, 3u);
+  EXPECT_EQ(stats.taken, 3u);
+  EXPECT_EQ(stats.missed, 0u);
+}
+
+TEST(TestVideoScanPrefetcher, MissedFolderIsSkipped)
+{
+  std::atomic<int> runs{0};
+
+  // no threads, nothing gets started
+  CVideoScanPrefetcher prefetcher(0, 16);
+  prefetcher.Add("/movies/a/", HashTask("a", &runs));
+  EXPECT_FALSE(prefetcher.Take("/movies/a/"));
+  EXPECT_EQ(prefetcher.GetStats().missed, 1u);
+  EXPECT_EQ(runs, 0);
+}
+
+TEST(TestVideoScanPrefetcher, StaysAhead)
+{
+  std::atomic<int> runs{0};
+
+  CVideoScanPrefetcher prefetcher(2, 1);
+  prefetcher.Add("/movies/a/", HashTask("a", &runs));
+  prefetcher.Add("/movies/b/", HashTask("b", &runs));
+
+  // one result waits for the scanner, the threads pause
+  ASSERT_TRUE(WaitForPrefetched(prefetcher, 1));
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(runs, 1);
+
+  EXPECT_TRUE(prefetcher.Take("/movies/a/"));
+  ASSERT_TRUE(WaitForPrefetched(prefetcher, 2));
+  EXPECT_EQ(runs, 2);
+  EXPECT_TRUE(prefetcher.Take("/movies/b/"));
+}
+
+TEST(TestVideoScanPrefetcher, Stop)
+{
+  std::atomic<int> runs{0};
+
+  CVideoScanPrefetcher prefetcher(1, 16);
+  prefetcher.Add("/movies/a/", HashTask("a", &runs, 50ms));
+  for (int i = 0; i < 10; i++)
+    prefetcher.Add("/movies/" + std::to_string(i) + "/", HashTask("", &runs));
+  prefetcher.Stop();
+
+  // the folder in progress is finished, the rest is dropped
+  const int runsAtStop = runs;
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(runs, runsAtStop);
+  EXPECT_FALSE(prefetcher.Take("/movies/a/"));
+
+  // adding after a stop does nothing
+  prefetcher.Add("/movies/b/", HashTask("b", &runs));
+  EXPECT_FALSE(prefetcher.Take("/movies/b/"));
+  EXPECT_EQ(prefetcher.GetStats().missed, 0u);
+}